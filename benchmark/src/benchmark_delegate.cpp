@@ -0,0 +1,345 @@
+#include <benchmark/benchmark.h>
+#include <core/bavil_delegate.h>
+#include <core/bavil_multicast_delegate.h>
+#include <core/bavil_concurrent_multicast_delegate.h>
+#include <core/bavil_object_system.h>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// 登録数を変えてブロードキャストする
+static void BM_DelegateBroadcast(benchmark::State& state)
+{
+	const auto listener_num = static_cast<size_t>(state.range(0));
+
+	bavil::MulticastDelegate<void(int)> events;
+
+	int sum = 0;
+	for ( size_t i = 0; i < listener_num; ++i )
+	{
+		events.add(
+		    [&sum](int _value)
+		    {
+			    sum += _value;
+		    });
+	}
+
+	for ( auto _ : state )
+	{
+		events.broadcast(1);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * listener_num);
+}
+BENCHMARK(BM_DelegateBroadcast)->RangeMultiplier(10)->Range(1, 10000);
+
+// 登録と削除を繰り返す
+static void BM_DelegateAddRemove(benchmark::State& state)
+{
+	const auto listener_num = static_cast<size_t>(state.range(0));
+
+	bavil::MulticastDelegate<void(int)> events;
+	for ( size_t i = 0; i < listener_num; ++i )
+	{
+		events.add([](int) {});
+	}
+
+	for ( auto _ : state )
+	{
+		auto handle = events.add([](int) {});
+		events.remove(handle);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DelegateAddRemove)->RangeMultiplier(10)->Range(1, 10000);
+
+// 内部のバッファに保持するデリゲートで登録数を変えてブロードキャストする
+static void BM_InlineDelegateBroadcast(benchmark::State& state)
+{
+	const auto listener_num = static_cast<size_t>(state.range(0));
+
+	bavil::InlineMulticastDelegate<void(int)> events;
+
+	int sum = 0;
+	for ( size_t i = 0; i < listener_num; ++i )
+	{
+		events.add(
+		    [&sum](int _value)
+		    {
+			    sum += _value;
+		    });
+	}
+
+	for ( auto _ : state )
+	{
+		events.broadcast(1);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * listener_num);
+}
+BENCHMARK(BM_InlineDelegateBroadcast)->RangeMultiplier(10)->Range(1, 10000);
+
+namespace
+{
+	constexpr size_t CONCURRENT_LISTENER_NUM = 16;
+
+	bavil::ConcurrentMulticastDelegate<void(int&)> s_concurrent_events;
+
+	std::mutex                          s_locked_mutex;
+	bavil::MulticastDelegate<void(int&)> s_locked_events;
+} // namespace
+
+// 複数のスレッドから同時にブロードキャストする
+static void BM_ConcurrentDelegateBroadcast(benchmark::State& state)
+{
+	if ( state.thread_index() == 0 )
+	{
+		for ( size_t i = 0; i < CONCURRENT_LISTENER_NUM; ++i )
+		{
+			s_concurrent_events.add(
+			    [](int& _sum)
+			    {
+				    _sum++;
+			    });
+		}
+	}
+
+	int sum = 0;
+	for ( auto _ : state )
+	{
+		s_concurrent_events.broadcast(sum);
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations());
+
+	if ( state.thread_index() == 0 )
+	{
+		s_concurrent_events.clear();
+	}
+}
+BENCHMARK(BM_ConcurrentDelegateBroadcast)->Threads(1)->Threads(16)->UseRealTime();
+
+// 複数のスレッドからブロードキャストしつつ、1スレッドが登録と削除を繰り返す
+static void BM_ConcurrentDelegateBroadcastWithWriter(benchmark::State& state)
+{
+	if ( state.thread_index() == 0 )
+	{
+		for ( size_t i = 0; i < CONCURRENT_LISTENER_NUM; ++i )
+		{
+			s_concurrent_events.add(
+			    [](int& _sum)
+			    {
+				    _sum++;
+			    });
+		}
+	}
+
+	int    sum   = 0;
+	size_t count = 0;
+	for ( auto _ : state )
+	{
+		if ( state.thread_index() == 0 && (++count % 1024) == 0 )
+		{
+			auto handle = s_concurrent_events.add([](int&) {});
+			s_concurrent_events.remove(handle);
+		}
+		s_concurrent_events.broadcast(sum);
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations());
+
+	if ( state.thread_index() == 0 )
+	{
+		s_concurrent_events.clear();
+	}
+}
+BENCHMARK(BM_ConcurrentDelegateBroadcastWithWriter)->Threads(16)->UseRealTime();
+
+// 比較用: 通常のデリゲートをミューテックスで保護してブロードキャストする
+static void BM_LockedDelegateBroadcast(benchmark::State& state)
+{
+	if ( state.thread_index() == 0 )
+	{
+		for ( size_t i = 0; i < CONCURRENT_LISTENER_NUM; ++i )
+		{
+			s_locked_events.add(
+			    [](int& _sum)
+			    {
+				    _sum++;
+			    });
+		}
+	}
+
+	int sum = 0;
+	for ( auto _ : state )
+	{
+		std::lock_guard lock(s_locked_mutex);
+		s_locked_events.broadcast(sum);
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations());
+
+	if ( state.thread_index() == 0 )
+	{
+		s_locked_events.clear();
+	}
+}
+BENCHMARK(BM_LockedDelegateBroadcast)->Threads(1)->Threads(16)->UseRealTime();
+
+namespace
+{
+	class ListenerObject : public bavil::ObjectBase
+	{
+	public:
+		void on_event(int _value)
+		{
+			sum += _value;
+		}
+
+		int sum = 0;
+
+	protected:
+		void construct() override {}
+		void destruct() override {}
+	};
+} // namespace
+
+// オブジェクトのメンバ関数を登録してブロードキャストする
+static void BM_MemberDelegateBroadcast(benchmark::State& state)
+{
+	const auto listener_num = static_cast<size_t>(state.range(0));
+
+	bavil::core::SystemManager system_manager = {};
+	auto&                      object_system  = bavil::ObjectSystem::Get();
+
+	std::vector<bavil::ObjectHandle<ListenerObject>> objects;
+	bavil::InlineMulticastDelegate<void(int)>        events;
+	for ( size_t i = 0; i < listener_num; ++i )
+	{
+		objects.push_back(object_system.create_object<ListenerObject>());
+		events.add_member<&ListenerObject::on_event>(objects.back());
+	}
+
+	for ( auto _ : state )
+	{
+		events.broadcast(1);
+	}
+	state.SetItemsProcessed(state.iterations() * listener_num);
+
+	objects.clear();
+	system_manager.finalize();
+}
+BENCHMARK(BM_MemberDelegateBroadcast)->RangeMultiplier(10)->Range(1, 1000);
+
+// 引数を積んでおき、flush() でまとめて呼び出す
+static void BM_DelegateQueueFlush(benchmark::State& state)
+{
+	using Events = bavil::MulticastDelegate<void(int)>;
+
+	const auto payload_num = static_cast<size_t>(state.range(0));
+
+	Events events;
+
+	int sum = 0;
+	for ( size_t i = 0; i < 8; ++i )
+	{
+		events.add(
+		    [&sum](int _value)
+		    {
+			    sum += _value;
+		    });
+	}
+	events.add_batch(
+	    [&sum](std::span<const Events::Payload> _payloads)
+	    {
+		    for ( const auto& payload : _payloads )
+		    {
+			    sum += std::get<0>(payload);
+		    }
+	    });
+
+	for ( auto _ : state )
+	{
+		for ( size_t i = 0; i < payload_num; ++i )
+		{
+			events.queue(1);
+		}
+		events.flush();
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * payload_num);
+}
+BENCHMARK(BM_DelegateQueueFlush)->RangeMultiplier(10)->Range(1, 10000);
+
+// スレッドセーフなデリゲートを並列にブロードキャストする
+static void BM_DelegateBroadcastParallel(benchmark::State& state)
+{
+	const auto listener_num = static_cast<size_t>(state.range(0));
+
+	bavil::core::SystemManager system_manager = {};
+
+	bavil::MulticastDelegate<void(int)> events;
+
+	std::vector<int> values(listener_num, 0);
+	for ( size_t i = 0; i < listener_num; ++i )
+	{
+		events.add(
+		    [&values, i](int _value)
+		    {
+			    values[i] += _value;
+		    },
+		    bavil::DelegateFlags::ThreadSafe);
+	}
+
+	for ( auto _ : state )
+	{
+		events.broadcast_parallel(1);
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * listener_num);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_DelegateBroadcastParallel)
+    ->RangeMultiplier(10)
+    ->Range(100, 100000)
+    ->UseRealTime();
+
+// 1つの関数を登録したデリゲートを呼び出す
+static void BM_SingleDelegateExecute(benchmark::State& state)
+{
+	int                       offset = 1;
+	bavil::Delegate<int(int)> query  = [&offset](int _value)
+	{
+		return _value + offset;
+	};
+
+	int value = 0;
+	for ( auto _ : state )
+	{
+		value = query.execute(value);
+		benchmark::DoNotOptimize(value);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SingleDelegateExecute);
+
+// 比較用にstd::functionを呼び出す
+static void BM_StdFunctionExecute(benchmark::State& state)
+{
+	int                     offset = 1;
+	std::function<int(int)> query  = [&offset](int _value)
+	{
+		return _value + offset;
+	};
+
+	int value = 0;
+	for ( auto _ : state )
+	{
+		value = query(value);
+		benchmark::DoNotOptimize(value);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StdFunctionExecute);
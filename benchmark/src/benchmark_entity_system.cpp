@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+#include <core/bavil_entity_system.h>
+#include <core/bavil_task_system.h>
+#include <core/bavil_world_system.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace
+{
+	constexpr size_t ENTITY_NUM = 100000;
+
+	struct Position
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+	};
+
+	struct Velocity
+	{
+		float x = 1.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+	};
+
+	// 位置と速度を持つアクター(比較用に同じ計算をアクターで行う)
+	class MovingActor : public bavil::Actor
+	{
+	public:
+		Position position;
+		Velocity velocity;
+	};
+} // namespace
+
+// 10万個のアクターの位置を速度で進める
+static void BM_ActorIntegrate(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<MovingActor[]>(ENTITY_NUM);
+	for ( size_t i = 0; i < ENTITY_NUM; ++i )
+	{
+		world_system.add_actor(&actors[i]);
+	}
+
+	for ( auto _ : state )
+	{
+		world_system.for_each_actor(
+		    [](bavil::Actor& _actor)
+		    {
+			    auto& actor = static_cast<MovingActor&>(_actor);
+			    actor.position.x += actor.velocity.x;
+			    actor.position.y += actor.velocity.y;
+			    actor.position.z += actor.velocity.z;
+		    });
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ENTITY_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_ActorIntegrate);
+
+// 10万個のエンティティの位置を速度で進める(引数が1の場合は並列に処理する)
+static void BM_EntityIntegrate(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      entity_system  = bavil::EntitySystem::Get();
+	bavil::TaskSystem::Get().set_worker_num(
+	    std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+	for ( size_t i = 0; i < ENTITY_NUM; ++i )
+	{
+		entity_system.create_entity(Position{}, Velocity{});
+	}
+
+	const auto integrate = [](std::span<const bavil::Entity>,
+	                          std::span<Position>       _positions,
+	                          std::span<const Velocity> _velocities)
+	{
+		for ( size_t i = 0; i < _positions.size(); ++i )
+		{
+			_positions[i].x += _velocities[i].x;
+			_positions[i].y += _velocities[i].y;
+			_positions[i].z += _velocities[i].z;
+		}
+	};
+	for ( auto _ : state )
+	{
+		if ( state.range(0) == 0 )
+		{
+			entity_system.for_each_chunk<Position, const Velocity>(integrate);
+		}
+		else
+		{
+			entity_system.parallel_for_each_chunk<Position, const Velocity>(
+			    integrate);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ENTITY_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_EntityIntegrate)->Arg(0)->Arg(1);
+
+// 10万個のエンティティでコンポーネントの追加と削除を繰り返す
+static void BM_EntityAddRemoveComponent(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      entity_system  = bavil::EntitySystem::Get();
+
+	std::vector<bavil::Entity> entities;
+	for ( size_t i = 0; i < ENTITY_NUM; ++i )
+	{
+		entities.push_back(entity_system.create_entity(Position{}));
+	}
+
+	size_t index = 0;
+	for ( auto _ : state )
+	{
+		const bavil::Entity entity = entities[index];
+		entity_system.add_component(entity, Velocity{});
+		entity_system.remove_component<Velocity>(entity);
+		index = (index + 7919) % ENTITY_NUM;
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_EntityAddRemoveComponent);
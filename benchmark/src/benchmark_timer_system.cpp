@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include <core/bavil_timer_system.h>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr size_t ACTIVE_TIMER_NUM = 1000000;
+
+	// 1ms単位で最大10分後までのタイマーを登録する
+	constexpr bavil::u64 MAX_DELAY_TICKS = 10 * 60 * 1000;
+
+	std::vector<bavil::u64> make_delays(size_t _num)
+	{
+		std::mt19937_64                           engine(12345);
+		std::uniform_int_distribution<bavil::u64> dist(1, MAX_DELAY_TICKS);
+		std::vector<bavil::u64>                   result(_num);
+		for ( bavil::u64& delay : result )
+		{
+			delay = dist(engine);
+		}
+		return result;
+	}
+} // namespace
+
+// 100万個のタイマーを登録する
+static void BM_TimerSchedule(benchmark::State& state)
+{
+	const auto delays = make_delays(ACTIVE_TIMER_NUM);
+
+	for ( auto _ : state )
+	{
+		state.PauseTiming();
+		bavil::core::SystemManager system_manager = {};
+		auto&                      timer_system   = bavil::TimerSystem::Get();
+		state.ResumeTiming();
+
+		for ( bavil::u64 delay : delays )
+		{
+			timer_system.schedule_ticks(delay, []() {});
+		}
+
+		state.PauseTiming();
+		system_manager.finalize();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * ACTIVE_TIMER_NUM);
+}
+BENCHMARK(BM_TimerSchedule)->Unit(benchmark::kMillisecond);
+
+// 100万個の繰り返しタイマーが有効な状態で1フレーム(16ティック)進める
+static void BM_TimerTickMillionActive(benchmark::State& state)
+{
+	const auto delays = make_delays(ACTIVE_TIMER_NUM);
+
+	bavil::core::SystemManager system_manager = {};
+	auto&                      timer_system   = bavil::TimerSystem::Get();
+
+	size_t fired_num = 0;
+	for ( bavil::u64 delay : delays )
+	{
+		// 期限が来たら同じ間隔で登録し直されるので有効な数は一定
+		timer_system.schedule_ticks(
+		    delay,
+		    [&fired_num]()
+		    {
+			    fired_num++;
+		    },
+		    delay);
+	}
+
+	for ( auto _ : state )
+	{
+		timer_system.advance_ticks(16);
+	}
+
+	benchmark::DoNotOptimize(fired_num);
+	state.counters["active"] =
+	    static_cast<double>(timer_system.get_active_timer_num());
+	state.counters["fired/frame"] = benchmark::Counter(
+	    static_cast<double>(fired_num) / static_cast<double>(state.iterations()));
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_TimerTickMillionActive)->Unit(benchmark::kMicrosecond);
+
+// 100万個のタイマーが有効な状態で登録とキャンセルを繰り返す
+static void BM_TimerScheduleCancel(benchmark::State& state)
+{
+	const auto delays = make_delays(ACTIVE_TIMER_NUM);
+
+	bavil::core::SystemManager system_manager = {};
+	auto&                      timer_system   = bavil::TimerSystem::Get();
+
+	for ( bavil::u64 delay : delays )
+	{
+		timer_system.schedule_ticks(delay, []() {});
+	}
+
+	size_t index = 0;
+	for ( auto _ : state )
+	{
+		auto handle = timer_system.schedule_ticks(delays[index], []() {});
+		timer_system.cancel(handle);
+		index = (index + 1) % delays.size();
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_TimerScheduleCancel);
@@ -0,0 +1,522 @@
+#include <benchmark/benchmark.h>
+#include <core/bavil_actor_pool_system.h>
+#include <core/bavil_world_system.h>
+
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr size_t ACTOR_NUM = 100000;
+} // namespace
+
+// 10万個のアクターを配列の順に辿る
+static void BM_WorldForEachActor(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	// アクターの生成時の登録を避ける為に直接構築する
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		world_system.add_actor(&actors[i]);
+	}
+
+	for ( auto _ : state )
+	{
+		float sum = 0.0f;
+		world_system.for_each_actor(
+		    [&sum](bavil::Actor& _actor)
+		    {
+			    sum += _actor.get_transform().get_position().x;
+		    });
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldForEachActor);
+
+// 比較用に10万個のアクターをリストで辿る
+static void BM_ListForEachActor(benchmark::State& state)
+{
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+
+	std::list<bavil::Actor*> actor_list;
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		actor_list.push_back(&actors[i]);
+	}
+
+	for ( auto _ : state )
+	{
+		float sum = 0.0f;
+		for ( bavil::Actor* actor : actor_list )
+		{
+			sum += actor->get_transform().get_position().x;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM);
+}
+BENCHMARK(BM_ListForEachActor);
+
+// 10万個のアクターが登録されたワールドでランダムに削除と登録を繰り返す
+static void BM_WorldAddRemoveActor(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		world_system.add_actor(&actors[i]);
+	}
+
+	std::mt19937                          engine(12345);
+	std::uniform_int_distribution<size_t> dist(0, ACTOR_NUM - 1);
+
+	for ( auto _ : state )
+	{
+		bavil::Actor* actor = &actors[dist(engine)];
+		world_system.remove_actor(actor);
+		world_system.add_actor(actor);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldAddRemoveActor);
+
+// 10万個のアクターのトランスフォームを変更して行列をまとめて作り直す
+static void BM_WorldUpdateTransforms(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		world_system.add_actor(&actors[i]);
+	}
+
+	float value = 0.0f;
+	for ( auto _ : state )
+	{
+		value += 1.0f;
+		// 複数の値を変更しても作り直しは1回で済む
+		world_system.for_each_actor(
+		    [value](bavil::Actor& _actor)
+		    {
+			    bavil::Transform& transform = _actor.get_transform();
+			    transform.set_position({value, 0.0f, 0.0f});
+			    transform.set_rotation({0.0f, value, 0.0f});
+			    transform.set_scale({1.0f, 1.0f, value});
+		    });
+		world_system.update_transforms();
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldUpdateTransforms)->Unit(benchmark::kMillisecond);
+
+// 比較用に行列を1つずつ取得して作り直す
+static void BM_TransformGetMatrix(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		world_system.add_actor(&actors[i]);
+	}
+
+	float value = 0.0f;
+	for ( auto _ : state )
+	{
+		value += 1.0f;
+		world_system.for_each_actor(
+		    [value](bavil::Actor& _actor)
+		    {
+			    bavil::Transform& transform = _actor.get_transform();
+			    transform.set_position({value, 0.0f, 0.0f});
+			    transform.set_rotation({0.0f, value, 0.0f});
+			    transform.set_scale({1.0f, 1.0f, value});
+			    benchmark::DoNotOptimize(transform.get_matrix());
+		    });
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_TransformGetMatrix)->Unit(benchmark::kMillisecond);
+
+namespace
+{
+	// ルート1つに子が9つ(孫を含む)の階層を作る
+	constexpr size_t HIERARCHY_SIZE = 10;
+
+	void build_hierarchies(bavil::WorldSystem& _world_system, bavil::Actor* _actors)
+	{
+		for ( size_t i = 0; i < ACTOR_NUM; ++i )
+		{
+			_world_system.add_actor(&_actors[i]);
+			_actors[i].get_transform().set_position({1.0f, 0.0f, 0.0f});
+		}
+		for ( size_t i = 0; i < ACTOR_NUM; i += HIERARCHY_SIZE )
+		{
+			for ( size_t j = 1; j < HIERARCHY_SIZE; ++j )
+			{
+				// 半分は子、半分は孫にする
+				const size_t parent = j < HIERARCHY_SIZE / 2 ? i : i + j - 4;
+				_world_system.attach_actor(&_actors[i + j], &_actors[parent]);
+			}
+		}
+	}
+} // namespace
+
+// 1割のルートを動かしてワールド行列を計算し直す
+static void BM_WorldUpdateHierarchy(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	build_hierarchies(world_system, actors.get());
+	world_system.update_transforms();
+
+	float value = 0.0f;
+	for ( auto _ : state )
+	{
+		value += 1.0f;
+		for ( size_t i = 0; i < ACTOR_NUM; i += HIERARCHY_SIZE * 10 )
+		{
+			actors[i].get_transform().set_position({value, 0.0f, 0.0f});
+		}
+		world_system.update_transforms();
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldUpdateHierarchy)->Unit(benchmark::kMillisecond);
+
+// 比較用に親を再帰的に辿ってワールド行列を計算する
+static void BM_RecursiveUpdateHierarchy(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	build_hierarchies(world_system, actors.get());
+
+	std::vector<bavil::math::Matrix44> world_matrices(ACTOR_NUM);
+
+	float value = 0.0f;
+	for ( auto _ : state )
+	{
+		value += 1.0f;
+		for ( size_t i = 0; i < ACTOR_NUM; i += HIERARCHY_SIZE * 10 )
+		{
+			actors[i].get_transform().set_position({value, 0.0f, 0.0f});
+		}
+		for ( size_t i = 0; i < ACTOR_NUM; ++i )
+		{
+			bavil::math::Matrix44 matrix = actors[i].get_transform().get_matrix();
+			for ( const bavil::Actor* parent = actors[i].get_parent(); parent;
+			      parent                     = parent->get_parent() )
+			{
+				matrix = matrix * parent->get_transform().get_matrix();
+			}
+			world_matrices[i] = matrix;
+		}
+		benchmark::DoNotOptimize(world_matrices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_RecursiveUpdateHierarchy)->Unit(benchmark::kMillisecond);
+
+namespace
+{
+	// tick() で自身のトランスフォームを動かすアクター
+	class MovingActor : public bavil::Actor
+	{
+	public:
+		explicit MovingActor(bool _thread_safe = false)
+		{
+			set_tick_enabled(true);
+			set_tick_thread_safe(_thread_safe);
+		}
+
+		virtual void tick(bavil::f32 _delta_seconds) override
+		{
+			bavil::math::Vector3 position = m_transform.get_position();
+			position.x += m_speed * _delta_seconds;
+			m_transform.set_position(position);
+			m_transform.set_rotation({0.0f, position.x, 0.0f});
+		}
+
+	private:
+		bavil::f32 m_speed = 1.0f;
+	};
+} // namespace
+
+// 10万個のアクターの tick() を呼び出す(引数が1の場合は並列に呼び出す)
+static void BM_WorldTick(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	std::vector<std::unique_ptr<MovingActor>> actors;
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		actors.push_back(std::make_unique<MovingActor>(state.range(0) != 0));
+		world_system.add_actor(actors.back().get());
+	}
+
+	for ( auto _ : state )
+	{
+		world_system.tick(1.0f / 60.0f);
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldTick)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+namespace
+{
+	// 1辺2000の範囲に10万個のアクターを配置する
+	void scatter_actors(bavil::WorldSystem& _world_system, bavil::Actor* _actors)
+	{
+		std::mt19937                          engine(1234);
+		std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+		for ( size_t i = 0; i < ACTOR_NUM; ++i )
+		{
+			_world_system.add_actor(&_actors[i]);
+			_actors[i].get_transform().set_position(
+			    {distribution(engine), distribution(engine), distribution(engine)});
+		}
+		_world_system.update_transforms();
+	}
+
+	bavil::SpatialIndexSettings make_spatial_index_settings(int64_t _type)
+	{
+		bavil::SpatialIndexSettings settings;
+		settings.type      = static_cast<bavil::SpatialIndexType>(_type);
+		settings.cell_size = 50.0f;
+		settings.bounds    = {bavil::math::Vector3(-1024.0f),
+		                      bavil::math::Vector3(1024.0f)};
+		return settings;
+	}
+
+	// アクターに1辺が2から10の境界ボックスを持たせて散らばらせる
+	void scatter_bounds_actors(bavil::WorldSystem& _world_system,
+	                           bavil::Actor*       _actors)
+	{
+		scatter_actors(_world_system, _actors);
+
+		std::mt19937                          engine(4321);
+		std::uniform_real_distribution<float> distribution(1.0f, 5.0f);
+		for ( size_t i = 0; i < ACTOR_NUM; ++i )
+		{
+			const bavil::math::Vector3 extent(
+			    distribution(engine), distribution(engine), distribution(engine));
+			_actors[i].set_local_bounds({-extent, extent});
+		}
+	}
+} // namespace
+
+// 半径100の範囲のアクターを検索する(引数は索引の種類)
+static void BM_WorldQueryRadius(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	world_system.set_spatial_index(make_spatial_index_settings(state.range(0)));
+	scatter_actors(world_system, actors.get());
+
+	std::mt19937                          engine(5678);
+	std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+	for ( auto _ : state )
+	{
+		const bavil::math::Vector3 center = {
+		    distribution(engine), distribution(engine), distribution(engine)};
+		size_t found_num = 0;
+		world_system.query_actors_in_radius(
+		    center, 100.0f, [&](bavil::Actor&) { ++found_num; });
+		benchmark::DoNotOptimize(found_num);
+	}
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldQueryRadius)->DenseRange(0, 2);
+
+// 近い順に16個のアクターを取得する(引数は索引の種類)
+static void BM_WorldFindNearest(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	world_system.set_spatial_index(make_spatial_index_settings(state.range(0)));
+	scatter_actors(world_system, actors.get());
+
+	std::mt19937                          engine(5678);
+	std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+	bavil::Actor*                         nearest[16] = {};
+	for ( auto _ : state )
+	{
+		const bavil::math::Vector3 center = {
+		    distribution(engine), distribution(engine), distribution(engine)};
+		benchmark::DoNotOptimize(world_system.find_nearest_actors(center, nearest));
+	}
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldFindNearest)->DenseRange(0, 2);
+
+// 1割のアクターを動かして索引に反映する(引数は索引の種類)
+static void BM_WorldUpdateSpatialIndex(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	world_system.set_spatial_index(make_spatial_index_settings(state.range(0)));
+	scatter_actors(world_system, actors.get());
+
+	float value = 0.0f;
+	for ( auto _ : state )
+	{
+		value = -value + 10.0f;
+		for ( size_t i = 0; i < ACTOR_NUM; i += 10 )
+		{
+			bavil::Transform&    transform = actors[i].get_transform();
+			bavil::math::Vector3 position  = transform.get_position();
+			position.x += value;
+			transform.set_position(position);
+		}
+		world_system.update_transforms();
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM / 10);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldUpdateSpatialIndex)
+    ->DenseRange(0, 2)
+    ->Unit(benchmark::kMicrosecond);
+
+// 10万個の境界ボックスを持つアクターに1万本の半直線を判定する
+// (引数が0の場合は位置も向きもばらばら、1の場合は1点から格子状に放つ)
+static void BM_WorldRaycast(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	scatter_bounds_actors(world_system, actors.get());
+
+	constexpr size_t                      RAY_GRID_SIZE = 100;
+	constexpr size_t                      RAY_NUM = RAY_GRID_SIZE * RAY_GRID_SIZE;
+	std::mt19937                          engine(5678);
+	std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+	std::vector<bavil::math::Ray>         rays(RAY_NUM);
+	for ( size_t i = 0; i < RAY_NUM; ++i )
+	{
+		bavil::math::Ray& ray = rays[i];
+		if ( state.range(0) == 0 )
+		{
+			ray.origin = {
+			    distribution(engine), distribution(engine), distribution(engine)};
+			ray.direction = {
+			    distribution(engine), distribution(engine), distribution(engine)};
+		}
+		else
+		{
+			const float u = static_cast<float>(i % RAY_GRID_SIZE) / RAY_GRID_SIZE;
+			const float v = static_cast<float>(i / RAY_GRID_SIZE) / RAY_GRID_SIZE;
+			ray.origin    = {-1000.0f, 0.0f, 0.0f};
+			ray.direction = {1.0f, u - 0.5f, v - 0.5f};
+		}
+		ray.direction.safe_normalize();
+	}
+	std::vector<bavil::RaycastHit> hits(RAY_NUM);
+
+	for ( auto _ : state )
+	{
+		world_system.raycast(rays, hits);
+		benchmark::DoNotOptimize(hits.data());
+	}
+	state.SetItemsProcessed(state.iterations() * RAY_NUM);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldRaycast)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+
+// 1割の境界ボックスを持つアクターを動かして木に反映する
+static void BM_WorldUpdateBounds(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      world_system   = bavil::WorldSystem::Get();
+
+	auto actors = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	scatter_bounds_actors(world_system, actors.get());
+
+	float value = 0.0f;
+	for ( auto _ : state )
+	{
+		value = -value + 10.0f;
+		for ( size_t i = 0; i < ACTOR_NUM; i += 10 )
+		{
+			bavil::Transform&    transform = actors[i].get_transform();
+			bavil::math::Vector3 position  = transform.get_position();
+			position.x += value;
+			transform.set_position(position);
+		}
+		world_system.update_transforms();
+	}
+	state.SetItemsProcessed(state.iterations() * ACTOR_NUM / 10);
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldUpdateBounds)->Unit(benchmark::kMicrosecond);
+
+// アクターの生成と削除を繰り返す(引数が1の場合はプールで再利用する)
+static void BM_WorldSpawnActor(benchmark::State& state)
+{
+	bavil::core::SystemManager system_manager = {};
+	auto&                      object_system  = bavil::ObjectSystem::Get();
+	auto&                      pool_system    = bavil::ActorPoolSystem::Get();
+	pool_system.configure<bavil::Actor>({.warm_num = 1});
+
+	const bavil::math::Vector3 position(1.0f, 2.0f, 3.0f);
+	for ( auto _ : state )
+	{
+		if ( state.range(0) == 0 )
+		{
+			auto actor = object_system.create_object<bavil::Actor>();
+			actor->get_transform().set_position(position);
+			benchmark::DoNotOptimize(actor.get_object());
+		}
+		else
+		{
+			auto actor = pool_system.spawn<bavil::Actor>(position);
+			benchmark::DoNotOptimize(actor.get_object());
+			pool_system.despawn(std::move(actor));
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	system_manager.finalize();
+}
+BENCHMARK(BM_WorldSpawnActor)->Arg(0)->Arg(1);
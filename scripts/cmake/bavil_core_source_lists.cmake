@@ -3,12 +3,27 @@
 set(BVIL_CORE_PUBLIC_SOURCE_LISTS
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_system.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_system_manager.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_system_allocator.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_delegate.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_multicast_delegate.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_inline_function.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_concurrent_multicast_delegate.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_object_base.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_object_handle.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_object_system.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_actor.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_transform_store.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_world_system.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_spatial_index.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_aabb_tree.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_entity.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_entity_system.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_actor_pool_system.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_linear_arena.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_frame_allocator_system.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_timer_system.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_event_bus_system.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/core/bavil_task_system.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/math/bavil_angle.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/math/bavil_color4.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/math/bavil_colori4.h"
@@ -27,14 +42,28 @@ set(BVIL_CORE_PUBLIC_SOURCE_LISTS
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/math/bavil_vector3.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/math/bavil_vector4.h"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/math/bavil_rotator.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/math/bavil_aabb.h"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/public/math/bavil_ray.h"
 )
 
 set(BVIL_CORE_PRIVATE_SOURCE_LISTS
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_system_manager.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_system_allocator.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_multicast_delegate.cpp"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_object_handle.cpp"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_object_system.cpp"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_actor.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_transform_store.cpp"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_world_system.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_spatial_index.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_aabb_tree.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_entity_system.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_actor_pool_system.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_linear_arena.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_frame_allocator_system.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_timer_system.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_event_bus_system.cpp"
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/core/bavil_task_system.cpp"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/math/bavil_color4.cpp"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/math/bavil_colori4.cpp"
 	"${CMAKE_CURRENT_SOURCE_DIR}/src/private/math/bavil_matrix33.cpp"
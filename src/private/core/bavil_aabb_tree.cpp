@@ -0,0 +1,557 @@
+#include "core/bavil_aabb_tree.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define BAVIL_AABB_TREE_SSE2 1
+#include <emmintrin.h>
+#else
+#define BAVIL_AABB_TREE_SSE2 0
+#endif
+
+namespace bavil
+{
+
+	namespace
+	{
+		using Vector3 = bavil::math::Vector3;
+		using AABB    = bavil::math::AABB;
+
+		// 方向の成分が0の場合も逆数を有限の値にする為の最小の大きさ
+		constexpr f32 MIN_DIRECTION = 1.0e-20f;
+
+		/**
+		 * @brief 木を辿る時に節点を積むスタック
+		 * 通常の高さであれば関数のスタック上の領域に収まり、超えた場合のみ確保する
+		 */
+		template<class T>
+		class TraversalStack
+		{
+		public:
+			TraversalStack()
+			    : m_resource(m_buffer.data(),
+			                 m_buffer.size(),
+			                 std::pmr::new_delete_resource())
+			    , m_items(&m_resource)
+			{
+				m_items.reserve(RESERVE_NUM);
+			}
+
+			void push(const T& _item)
+			{
+				m_items.push_back(_item);
+			}
+
+			T pop() noexcept
+			{
+				const T item = m_items.back();
+				m_items.pop_back();
+				return item;
+			}
+
+			bool empty() const noexcept
+			{
+				return m_items.empty();
+			}
+
+		private:
+			static constexpr size_t RESERVE_NUM = 128;
+
+			alignas(T) std::array<std::byte, RESERVE_NUM * sizeof(T)> m_buffer;
+			std::pmr::monotonic_buffer_resource m_resource;
+			std::pmr::vector<T>                 m_items;
+		};
+
+		/**
+		 * @brief まとめて判定する半直線を成分毎に並べたもの
+		 * 判定の済んでいない半直線の最大の距離は、当たる度に縮める
+		 */
+		struct RayPacket
+		{
+			alignas(16) f32 origin[3][AABBTree::RAY_PACKET_SIZE];
+			alignas(16) f32 inv_direction[3][AABBTree::RAY_PACKET_SIZE];
+			// 使用しない要素は負の値にして当たらないようにする
+			alignas(16) f32 max_distance[AABBTree::RAY_PACKET_SIZE];
+		};
+
+		/**
+		 * @brief 全ての半直線と境界ボックスの判定をまとめて行う
+		 * 軸毎の板を通過する距離の範囲を重ね、範囲が残る半直線を当たりとする
+		 * @param _near 半直線が境界ボックスに入る距離(始点が内側の場合は0)
+		 * @return 当たった半直線のビットマスク
+		 */
+		u32 intersect_packet(const RayPacket& _packet,
+		                     const AABB&      _aabb,
+		                     f32*             _near) noexcept
+		{
+#if BAVIL_AABB_TREE_SSE2
+			__m128 t_min = _mm_setzero_ps();
+			__m128 t_max = _mm_load_ps(_packet.max_distance);
+			for ( u32 axis = 0; axis < 3; ++axis )
+			{
+				const __m128 origin  = _mm_load_ps(_packet.origin[axis]);
+				const __m128 inv_dir = _mm_load_ps(_packet.inv_direction[axis]);
+				const __m128 t0      = _mm_mul_ps(
+				    _mm_sub_ps(_mm_set1_ps(_aabb.min[axis]), origin), inv_dir);
+				const __m128 t1 = _mm_mul_ps(
+				    _mm_sub_ps(_mm_set1_ps(_aabb.max[axis]), origin), inv_dir);
+				t_min = _mm_max_ps(t_min, _mm_min_ps(t0, t1));
+				t_max = _mm_min_ps(t_max, _mm_max_ps(t0, t1));
+			}
+			_mm_storeu_ps(_near, t_min);
+			return static_cast<u32>(_mm_movemask_ps(_mm_cmple_ps(t_min, t_max)));
+#else
+			u32 mask = 0;
+			for ( size_t lane = 0; lane < AABBTree::RAY_PACKET_SIZE; ++lane )
+			{
+				f32 t_min = 0.0f;
+				f32 t_max = _packet.max_distance[lane];
+				for ( u32 axis = 0; axis < 3; ++axis )
+				{
+					const f32 origin        = _packet.origin[axis][lane];
+					const f32 inv_direction = _packet.inv_direction[axis][lane];
+					const f32 t0 = (_aabb.min[axis] - origin) * inv_direction;
+					const f32 t1 = (_aabb.max[axis] - origin) * inv_direction;
+					t_min        = std::max(t_min, std::min(t0, t1));
+					t_max        = std::min(t_max, std::max(t0, t1));
+				}
+				_near[lane] = t_min;
+				if ( t_min <= t_max )
+				{
+					mask |= 1u << lane;
+				}
+			}
+			return mask;
+#endif
+		}
+
+	} // namespace
+
+	AABBTree::AABBTree(std::pmr::memory_resource* _resource, f32 _margin)
+	    : m_nodes(_resource)
+	    , m_links(_resource)
+	    , m_leaves(_resource)
+	    , m_free_ids(_resource)
+	    , m_margin(_margin)
+	{
+	}
+
+	u32 AABBTree::insert(bavil::Actor* _actor, const bavil::math::AABB& _bounds)
+	{
+		const u32 id       = allocate_node();
+		m_nodes[id].bounds = AABB::Expand(_bounds, m_margin);
+		m_leaves[id]       = {_bounds, _actor};
+		insert_leaf(id);
+		++m_leaf_num;
+		return id;
+	}
+
+	bool AABBTree::update(u32 _id, const bavil::math::AABB& _bounds)
+	{
+		m_leaves[_id].bounds = _bounds;
+		if ( m_nodes[_id].bounds.contains(_bounds) )
+		{
+			return false;
+		}
+
+		remove_leaf(_id);
+		m_nodes[_id].bounds = AABB::Expand(_bounds, m_margin);
+		insert_leaf(_id);
+		return true;
+	}
+
+	void AABBTree::remove(u32 _id)
+	{
+		remove_leaf(_id);
+		free_node(_id);
+		--m_leaf_num;
+	}
+
+	void AABBTree::clear() noexcept
+	{
+		m_nodes.clear();
+		m_links.clear();
+		m_leaves.clear();
+		m_free_ids.clear();
+		m_root     = INVALID_ID;
+		m_leaf_num = 0;
+	}
+
+	void AABBTree::raycast(std::span<const bavil::math::Ray> _rays,
+	                       std::span<RaycastHit>             _hits) const
+	{
+		const size_t ray_num = std::min(_rays.size(), _hits.size());
+		for ( size_t i = 0; i < ray_num; i += RAY_PACKET_SIZE )
+		{
+			raycast_packet(&_rays[i],
+			               &_hits[i],
+			               std::min(RAY_PACKET_SIZE, ray_num - i));
+		}
+	}
+
+	void AABBTree::query_aabb_internal(const bavil::math::AABB& _aabb,
+	                                   void*                    _context,
+	                                   QueryFunction            _function) const
+	{
+		if ( m_root == INVALID_ID )
+		{
+			return;
+		}
+
+		TraversalStack<u32> stack;
+		stack.push(m_root);
+		while ( !stack.empty() )
+		{
+			const u32   id   = stack.pop();
+			const Node& node = m_nodes[id];
+			if ( !node.bounds.intersects(_aabb) )
+			{
+				continue;
+			}
+			if ( !node.is_leaf() )
+			{
+				stack.push(node.children[0]);
+				stack.push(node.children[1]);
+			}
+			else if ( m_leaves[id].bounds.intersects(_aabb) )
+			{
+				_function(_context, *m_leaves[id].actor);
+			}
+		}
+	}
+
+	void AABBTree::raycast_packet(const bavil::math::Ray* _rays,
+	                              RaycastHit*             _hits,
+	                              size_t                  _num) const
+	{
+		RayPacket packet;
+		for ( size_t lane = 0; lane < RAY_PACKET_SIZE; ++lane )
+		{
+			if ( lane >= _num )
+			{
+				for ( u32 axis = 0; axis < 3; ++axis )
+				{
+					packet.origin[axis][lane]        = 0.0f;
+					packet.inv_direction[axis][lane] = 1.0f;
+				}
+				packet.max_distance[lane] = -1.0f;
+				continue;
+			}
+
+			const bavil::math::Ray& ray = _rays[lane];
+			for ( u32 axis = 0; axis < 3; ++axis )
+			{
+				const f32 direction = ray.direction[axis];
+				const f32 magnitude = std::max(std::abs(direction), MIN_DIRECTION);
+				packet.origin[axis][lane]        = ray.origin[axis];
+				packet.inv_direction[axis][lane] =
+				    1.0f / std::copysign(magnitude, direction);
+			}
+			packet.max_distance[lane] = ray.max_distance;
+			_hits[lane]               = RaycastHit();
+		}
+
+		alignas(16) f32 near0[RAY_PACKET_SIZE];
+		alignas(16) f32 near1[RAY_PACKET_SIZE];
+		if ( m_root == INVALID_ID ||
+		     intersect_packet(packet, m_nodes[m_root].bounds, near0) == 0 )
+		{
+			return;
+		}
+
+		// 子の境界ボックスは親で判定し、当たった子のみを積む
+		TraversalStack<u32> stack;
+		stack.push(m_root);
+		while ( !stack.empty() )
+		{
+			const u32   id   = stack.pop();
+			const Node& node = m_nodes[id];
+			if ( node.is_leaf() )
+			{
+				// 広げる前の境界ボックスで当たった距離を求める
+				const Leaf& leaf = m_leaves[id];
+				u32         mask = intersect_packet(packet, leaf.bounds, near0);
+				for ( ; mask != 0; mask &= mask - 1 )
+				{
+					const u32 lane            = std::countr_zero(mask);
+					_hits[lane]               = {leaf.actor, near0[lane]};
+					packet.max_distance[lane] = near0[lane];
+				}
+				continue;
+			}
+
+			const u32 child0 = node.children[0];
+			const u32 child1 = node.children[1];
+			const u32 mask0 =
+			    intersect_packet(packet, m_nodes[child0].bounds, near0);
+			const u32 mask1 =
+			    intersect_packet(packet, m_nodes[child1].bounds, near1);
+			if ( mask0 == 0 || mask1 == 0 )
+			{
+				if ( mask0 != 0 )
+				{
+					stack.push(child0);
+				}
+				else if ( mask1 != 0 )
+				{
+					stack.push(child1);
+				}
+				continue;
+			}
+
+			// 両方に当たった半直線から見て手前の子を先に辿ると、
+			// 最大の距離が早く縮まり奥の子を辿らずに済む
+			const u32 both_mask = mask0 & mask1;
+			const u32 lane = std::countr_zero(both_mask != 0 ? both_mask : mask0);
+			if ( near0[lane] <= near1[lane] )
+			{
+				stack.push(child1);
+				stack.push(child0);
+			}
+			else
+			{
+				stack.push(child0);
+				stack.push(child1);
+			}
+		}
+	}
+
+	u32 AABBTree::allocate_node()
+	{
+		if ( !m_free_ids.empty() )
+		{
+			const u32 id = m_free_ids.back();
+			m_free_ids.pop_back();
+			m_nodes[id]  = Node();
+			m_links[id]  = Link();
+			m_leaves[id] = Leaf();
+			return id;
+		}
+		m_nodes.emplace_back();
+		m_links.emplace_back();
+		m_leaves.emplace_back();
+		return static_cast<u32>(m_nodes.size() - 1);
+	}
+
+	void AABBTree::free_node(u32 _id)
+	{
+		m_leaves[_id].actor = nullptr;
+		m_free_ids.push_back(_id);
+	}
+
+	void AABBTree::insert_leaf(u32 _leaf)
+	{
+		if ( m_root == INVALID_ID )
+		{
+			m_root                = _leaf;
+			m_links[_leaf].parent = INVALID_ID;
+			return;
+		}
+
+		// 兄弟にする節点を、増える表面積の合計が最も小さくなるように選ぶ
+		// 節点の兄弟にする費用は、新しい親の表面積と祖先の表面積の増分の合計で、
+		// 子孫の費用は葉の表面積と節点までの増分の合計を下回らないので枝を刈れる
+		const AABB leaf_bounds = m_nodes[_leaf].bounds;
+		const f32  leaf_area   = leaf_bounds.surface_area();
+
+		struct Candidate
+		{
+			u32 id;
+			// 子を兄弟にする場合の祖先の表面積の増分の合計
+			f32 inherited_cost;
+			// 子孫を兄弟にする場合の費用の下限
+			f32 lower_bound;
+		};
+
+		const Node& root      = m_nodes[m_root];
+		u32         index     = m_root;
+		f32         best_cost = AABB::Merge(root.bounds, leaf_bounds).surface_area();
+		TraversalStack<Candidate> stack;
+		if ( !root.is_leaf() )
+		{
+			stack.push({m_root, best_cost - root.bounds.surface_area(), 0.0f});
+		}
+
+		// 入れ子になった境界ボックスが多いと刈れなくなるので、調べる数に上限を設ける
+		for ( u32 count = 0; !stack.empty() && count < MAX_INSERT_CANDIDATE_NUM;
+		      ++count )
+		{
+			const Candidate candidate = stack.pop();
+			if ( candidate.lower_bound >= best_cost )
+			{
+				continue;
+			}
+
+			const Node& node = m_nodes[candidate.id];
+			Candidate   children[2];
+			for ( u32 i = 0; i < 2; ++i )
+			{
+				const Node& child = m_nodes[node.children[i]];
+				const f32   cost =
+				    AABB::Merge(child.bounds, leaf_bounds).surface_area() +
+				    candidate.inherited_cost;
+				if ( cost < best_cost )
+				{
+					best_cost = cost;
+					index     = node.children[i];
+				}
+
+				const f32 inherited_cost = cost - child.bounds.surface_area();
+				children[i]              = {node.children[i],
+				                            inherited_cost,
+				                            child.is_leaf()
+				                                ? std::numeric_limits<f32>::max()
+				                                : inherited_cost + leaf_area};
+			}
+
+			// 下限の小さい子を先に調べる
+			if ( children[0].lower_bound < children[1].lower_bound )
+			{
+				std::swap(children[0], children[1]);
+			}
+			for ( const Candidate& child : children )
+			{
+				if ( child.lower_bound < best_cost )
+				{
+					stack.push(child);
+				}
+			}
+		}
+
+		// 兄弟と葉を子に持つ親を作り、兄弟の位置に置く
+		const u32 sibling    = index;
+		const u32 old_parent = m_links[sibling].parent;
+		const u32 new_parent = allocate_node();
+
+		Node& parent        = m_nodes[new_parent];
+		parent.children[0]  = sibling;
+		parent.children[1]  = _leaf;
+		parent.bounds       = AABB::Merge(m_nodes[sibling].bounds, leaf_bounds);
+		m_links[new_parent] = {old_parent, m_links[sibling].height + 1};
+
+		m_links[sibling].parent = new_parent;
+		m_links[_leaf].parent   = new_parent;
+		replace_child(old_parent, sibling, new_parent);
+
+		refit_ancestors(new_parent);
+	}
+
+	void AABBTree::remove_leaf(u32 _leaf)
+	{
+		if ( _leaf == m_root )
+		{
+			m_root = INVALID_ID;
+			return;
+		}
+
+		// 親を取り除き、兄弟を親の位置に上げる
+		const u32   parent       = m_links[_leaf].parent;
+		const Node& parent_node  = m_nodes[parent];
+		const u32   grand_parent = m_links[parent].parent;
+		const u32   sibling      = parent_node.children[0] == _leaf
+		                               ? parent_node.children[1]
+		                               : parent_node.children[0];
+
+		replace_child(grand_parent, parent, sibling);
+		m_links[sibling].parent = grand_parent;
+		free_node(parent);
+
+		refit_ancestors(grand_parent);
+	}
+
+	void AABBTree::refit_ancestors(u32 _id)
+	{
+		while ( _id != INVALID_ID )
+		{
+			_id = balance(_id);
+			refit(_id);
+			_id = m_links[_id].parent;
+		}
+	}
+
+	void AABBTree::refit(u32 _id) noexcept
+	{
+		Node&     node   = m_nodes[_id];
+		const u32 child0 = node.children[0];
+		const u32 child1 = node.children[1];
+		node.bounds = AABB::Merge(m_nodes[child0].bounds, m_nodes[child1].bounds);
+		m_links[_id].height =
+		    std::max(m_links[child0].height, m_links[child1].height) + 1;
+	}
+
+	u32 AABBTree::balance(u32 _id)
+	{
+		Node& node = m_nodes[_id];
+		if ( node.is_leaf() || m_links[_id].height < 2 )
+		{
+			return _id;
+		}
+
+		const u32 height0  = m_links[node.children[0]].height;
+		const u32 height1  = m_links[node.children[1]].height;
+		u32       up_index = 0;
+		if ( height1 > height0 + 1 )
+		{
+			up_index = 1;
+		}
+		else if ( height0 > height1 + 1 )
+		{
+			up_index = 0;
+		}
+		else
+		{
+			return _id;
+		}
+
+		// 高い方の子を節点の位置に上げ、節点はその子の子になる
+		const u32 up      = node.children[up_index];
+		Node&     up_node = m_nodes[up];
+		const u32 grand0  = up_node.children[0];
+		const u32 grand1  = up_node.children[1];
+
+		const u32 old_parent = m_links[_id].parent;
+		m_links[up].parent   = old_parent;
+		m_links[_id].parent  = up;
+		replace_child(old_parent, _id, up);
+
+		// 高い方の孫を上げた子に残し、低い方を節点に渡す
+		const bool is_grand0_higher =
+		    m_links[grand0].height > m_links[grand1].height;
+		const u32 keep = is_grand0_higher ? grand0 : grand1;
+		const u32 pass = is_grand0_higher ? grand1 : grand0;
+
+		up_node.children[0]     = _id;
+		up_node.children[1]     = keep;
+		node.children[up_index] = pass;
+		m_links[pass].parent    = _id;
+
+		refit(_id);
+		refit(up);
+		return up;
+	}
+
+	void AABBTree::replace_child(u32 _parent, u32 _old_child, u32 _new_child)
+	{
+		if ( _parent == INVALID_ID )
+		{
+			m_root = _new_child;
+			return;
+		}
+
+		Node& parent = m_nodes[_parent];
+		if ( parent.children[0] == _old_child )
+		{
+			parent.children[0] = _new_child;
+		}
+		else
+		{
+			parent.children[1] = _new_child;
+		}
+	}
+
+} // namespace bavil
@@ -1,26 +1,24 @@
 #include "core/bavil_actor.h"
+#include "core/bavil_entity_system.h"
 #include "core/bavil_world_system.h"
 
 namespace bavil
 {
-	void Transform::recash() noexcept
+	namespace
 	{
-		if ( m_is_recash_request )
+		WorldSystem* find_world_system() noexcept
 		{
-			m_cash_matrix = math::Matrix44::Scaling(m_scale);
-			m_cash_matrix *= math::Matrix44(math::ToQuaternion(m_rotation));
-			m_cash_matrix *= math::Matrix44::Translate(m_position);
+			auto* context = bavil::core::SystemManager::GetCurrent();
+			return context != nullptr ? context->find_system<WorldSystem>()
+			                          : nullptr;
 		}
-		m_is_recash_request = false;
-	}
+	} // namespace
 
 	/**
 	 * @brief オブジェクトの構築時に呼ばれる
 	 */
 	void Actor::construct()
 	{
-		SuperType::construct();
-
 		WorldSystem::Get().add_actor(this);
 	}
 
@@ -29,9 +27,71 @@ namespace bavil
 	 */
 	void Actor::destruct()
 	{
-		SuperType::destruct();
+		// ワールドが先に終了している場合は登録も解除されている
+		if ( WorldSystem* world_system = find_world_system() )
+		{
+			world_system->remove_actor(this);
+		}
+		if ( m_entity.is_valid() )
+		{
+			auto* context = bavil::core::SystemManager::GetCurrent();
+			if ( EntitySystem* entity_system =
+			         context != nullptr ? context->find_system<EntitySystem>()
+			                            : nullptr )
+			{
+				entity_system->destroy_entity(m_entity);
+			}
+		}
+	}
 
-		WorldSystem::Get().remove_actor(this);
+	void Actor::set_tick_enabled(bool _enabled)
+	{
+		// 呼び出す配列が変わるので、登録を解除してから登録し直す
+		WorldSystem* world_system = is_in_world() ? find_world_system() : nullptr;
+		if ( world_system != nullptr )
+		{
+			world_system->unregister_tick(this);
+		}
+		m_is_tick_enabled = _enabled;
+		if ( world_system != nullptr )
+		{
+			world_system->register_tick(this);
+		}
+	}
+
+	void Actor::set_tick_thread_safe(bool _thread_safe)
+	{
+		WorldSystem* world_system = is_in_world() ? find_world_system() : nullptr;
+		if ( world_system != nullptr )
+		{
+			world_system->unregister_tick(this);
+		}
+		m_is_tick_thread_safe = _thread_safe;
+		if ( world_system != nullptr )
+		{
+			world_system->register_tick(this);
+		}
+	}
+
+	void Actor::set_local_bounds(const bavil::math::AABB& _bounds)
+	{
+		m_local_bounds     = _bounds;
+		m_has_local_bounds = true;
+		WorldSystem* world_system = is_in_world() ? find_world_system() : nullptr;
+		if ( world_system != nullptr )
+		{
+			world_system->update_bounds(*this);
+		}
+	}
+
+	void Actor::clear_local_bounds()
+	{
+		WorldSystem* world_system = is_in_world() ? find_world_system() : nullptr;
+		if ( world_system != nullptr )
+		{
+			world_system->unregister_bounds(*this);
+		}
+		m_has_local_bounds = false;
 	}
 
 } // namespace bavil
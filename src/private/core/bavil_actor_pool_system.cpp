@@ -0,0 +1,151 @@
+#include "core/bavil_actor_pool_system.h"
+#include "core/bavil_entity_system.h"
+#include "core/bavil_world_system.h"
+
+#include <atomic>
+
+namespace bavil
+{
+
+	namespace
+	{
+		std::atomic<size_t> s_pool_type_id = 0;
+	} // namespace
+
+	size_t ActorPoolSystem::GeneratedPoolTypeIdInternal()
+	{
+		return s_pool_type_id++;
+	}
+
+	ActorPoolSystem::ActorPoolSystem(bavil::core::SystemAllocator& _allocator)
+	    : m_pools(&_allocator)
+	{
+	}
+
+	void ActorPoolSystem::initialize(bavil::core::SystemManager& _system_manager)
+	{
+		// 未使用のアクターを削除する時に両方のシステムを使う
+		m_object_system = _system_manager.get_system<bavil::ObjectSystem>();
+		m_world_system  = _system_manager.get_system<bavil::WorldSystem>();
+	}
+
+	void ActorPoolSystem::finalize()
+	{
+		// 未使用のアクターは他に参照が無いので、ハンドルを手放すと削除される
+		m_pools.clear();
+	}
+
+	ObjectHandleBase ActorPoolSystem::create_actor(u32 _pool_id)
+	{
+		ObjectHandleBase handle = m_pools[_pool_id].create(*m_object_system);
+		get_actor(handle)->m_pool_id = _pool_id;
+		return handle;
+	}
+
+	bavil::Actor* ActorPoolSystem::get_actor(
+	    const ObjectHandleBase& _handle) const
+	{
+		return static_cast<bavil::Actor*>(
+		    m_object_system->get_object_internal(_handle));
+	}
+
+	void ActorPoolSystem::configure_internal(u32                      _pool_id,
+	                                         const ActorPoolSettings& _settings)
+	{
+		Pool& pool    = m_pools[_pool_id];
+		pool.settings = _settings;
+
+		if ( pool.free_actors.size() < _settings.warm_num )
+		{
+			pool.free_actors.reserve(_settings.warm_num);
+		}
+		while ( pool.free_actors.size() < _settings.warm_num )
+		{
+			// 生成時にワールドに登録されるので、使うまで外しておく
+			ObjectHandleBase handle = create_actor(_pool_id);
+			bavil::Actor*    actor  = get_actor(handle);
+			m_world_system->remove_actor(actor);
+			actor->m_is_in_pool = true;
+			pool.free_actors.push_back(std::move(handle));
+		}
+		while ( pool.free_actors.size() > _settings.max_free_num )
+		{
+			pool.free_actors.pop_back();
+		}
+	}
+
+	ObjectHandleBase ActorPoolSystem::spawn_internal(
+	    u32                         _pool_id,
+	    const bavil::math::Vector3& _position,
+	    const bavil::math::Rotator& _rotation)
+	{
+		Pool& pool = m_pools[_pool_id];
+		if ( pool.free_actors.empty() )
+		{
+			ObjectHandleBase  handle    = create_actor(_pool_id);
+			bavil::Transform& transform = get_actor(handle)->get_transform();
+			transform.set_position(_position);
+			transform.set_rotation(_rotation);
+			return handle;
+		}
+
+		ObjectHandleBase handle = std::move(pool.free_actors.back());
+		pool.free_actors.pop_back();
+
+		// トランスフォームは返却前の値を保持しているので、新しく生成した場合と
+		// 同じ値になるようにスケールも書き直す
+		bavil::Actor*     actor     = get_actor(handle);
+		bavil::Transform& transform = actor->get_transform();
+		actor->m_is_in_pool         = false;
+		transform.set_position(_position);
+		transform.set_rotation(_rotation);
+		transform.set_scale(bavil::math::Vector3::ONE);
+		m_world_system->add_actor(actor);
+		actor->reactivate();
+		return handle;
+	}
+
+	void ActorPoolSystem::despawn_internal(ObjectHandleBase&& _actor)
+	{
+		ObjectHandleBase handle = std::move(_actor);
+		bavil::Actor*    actor  = get_actor(handle);
+		if ( actor == nullptr || actor->m_is_in_pool ||
+		     actor->m_pool_id >= m_pools.size() )
+		{
+			return;
+		}
+
+		// 他にハンドルが残っている場合は再利用すると別のアクターを指してしまうので、
+		// ハンドルを手放すだけにする
+		const ObjectArrayItem* item =
+		    m_object_system->get_object_array_internal(handle);
+		if ( item->ReferenceNum > 1 )
+		{
+			return;
+		}
+
+		Pool& pool = m_pools[actor->m_pool_id];
+		if ( pool.free_actors.size() >= pool.settings.max_free_num )
+		{
+			return;
+		}
+
+		m_world_system->remove_actor(actor);
+		if ( actor->get_entity().is_valid() )
+		{
+			auto* context = bavil::core::SystemManager::GetCurrent();
+			if ( EntitySystem* entity_system =
+			         context != nullptr ? context->find_system<EntitySystem>()
+			                            : nullptr )
+			{
+				entity_system->destroy_entity(actor->get_entity());
+			}
+		}
+		// 参照数を増やさずに指している側(メンバ関数のデリゲート等)からは破棄として扱う
+		m_object_system->invalidate_bindings_internal(handle);
+		actor->reset();
+		actor->m_is_in_pool = true;
+		pool.free_actors.push_back(std::move(handle));
+	}
+
+} // namespace bavil
@@ -0,0 +1,360 @@
+#include "core/bavil_entity_system.h"
+#include "core/bavil_actor.h"
+#include "core/bavil_task_system.h"
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+namespace bavil
+{
+
+	namespace
+	{
+		std::atomic<size_t> s_component_type_id = 0;
+
+		size_t align_up(size_t _value, size_t _alignment) noexcept
+		{
+			return (_value + _alignment - 1) & ~(_alignment - 1);
+		}
+	} // namespace
+
+	std::array<EntitySystem::ComponentInfo, EntitySystem::MAX_COMPONENT_TYPE_NUM>
+	    EntitySystem::s_component_infos = {};
+
+	size_t EntitySystem::GeneratedComponentTypeIdInternal(
+	    const ComponentInfo& _info)
+	{
+		// 情報の配列と型のマスクを超えない様に、リリースビルドでも失敗させる
+		const size_t id = s_component_type_id++;
+		if ( id >= MAX_COMPONENT_TYPE_NUM )
+		{
+			throw std::length_error("EntitySystem: too many component types");
+		}
+		s_component_infos[id] = _info;
+		return id;
+	}
+
+	EntitySystem::EntitySystem(bavil::core::SystemAllocator& _allocator)
+	    : m_archetypes(&_allocator)
+	    , m_archetype_ids(&_allocator)
+	    , m_records(&_allocator)
+	    , m_free_indices(&_allocator)
+	    , m_free_chunks(&_allocator)
+	{
+	}
+
+	void EntitySystem::initialize(bavil::core::SystemManager& _system_manager)
+	{
+	}
+
+	void EntitySystem::finalize()
+	{
+		// 生存しているアクターからエンティティを外す
+		for_each<ActorComponent>(
+		    [](ActorComponent& _component)
+		    {
+			    if ( _component.actor != nullptr )
+			    {
+				    _component.actor->m_entity = Entity();
+			    }
+		    });
+
+		for ( Archetype& archetype : m_archetypes )
+		{
+			for ( u32 id : archetype.component_ids )
+			{
+				const ComponentInfo& info = s_component_infos[id];
+				if ( info.destruct == nullptr )
+				{
+					continue;
+				}
+				for ( size_t row = 0; row < archetype.entity_num; ++row )
+				{
+					info.destruct(archetype.get_component(id, row));
+				}
+			}
+			m_free_chunks.insert(m_free_chunks.end(),
+			                     archetype.chunks.begin(),
+			                     archetype.chunks.end());
+		}
+
+		for ( std::byte* chunk : m_free_chunks )
+		{
+			get_allocator().deallocate(chunk, CHUNK_SIZE, CHUNK_ALIGNMENT);
+		}
+		m_archetypes.clear();
+		m_archetype_ids.clear();
+		m_records.clear();
+		m_free_indices.clear();
+		m_free_chunks.clear();
+		m_entity_num = 0;
+	}
+
+	void EntitySystem::destroy_entity(Entity _entity)
+	{
+		if ( !is_alive(_entity) )
+		{
+			return;
+		}
+
+		EntityRecord& record    = m_records[_entity.index];
+		Archetype&    archetype = m_archetypes[record.archetype];
+
+		if ( auto* component = get_component<ActorComponent>(_entity);
+		     component != nullptr && component->actor != nullptr )
+		{
+			component->actor->m_entity = Entity();
+		}
+
+		for ( u32 id : archetype.component_ids )
+		{
+			if ( auto destruct = s_component_infos[id].destruct )
+			{
+				destruct(archetype.get_component(id, record.row));
+			}
+		}
+		remove_row(archetype, record.row);
+
+		record.archetype = INVALID_ARCHETYPE;
+		++record.generation;
+		m_free_indices.push_back(_entity.index);
+		--m_entity_num;
+	}
+
+	Entity EntitySystem::bridge_actor(bavil::Actor& _actor)
+	{
+		if ( is_alive(_actor.m_entity) )
+		{
+			return _actor.m_entity;
+		}
+		_actor.m_entity = create_entity(ActorComponent{&_actor});
+		return _actor.m_entity;
+	}
+
+	u32 EntitySystem::find_or_create_archetype(ComponentMask _mask)
+	{
+		if ( auto it = m_archetype_ids.find(_mask); it != m_archetype_ids.end() )
+		{
+			return it->second;
+		}
+
+		const u32  archetype_id = static_cast<u32>(m_archetypes.size());
+		Archetype& archetype    = m_archetypes.emplace_back(
+		    m_archetypes.get_allocator().resource());
+		archetype.mask          = _mask;
+		for ( ComponentMask bits = _mask; bits != 0; bits &= bits - 1 )
+		{
+			archetype.component_ids.push_back(
+			    static_cast<u32>(std::countr_zero(bits)));
+		}
+
+		// エンティティ毎の大きさから格納できる数を求め、アライメントで溢れる分を減らす
+		const auto get_layout_size = [&](size_t _capacity)
+		{
+			size_t size = sizeof(Entity) * _capacity;
+			for ( u32 id : archetype.component_ids )
+			{
+				const ComponentInfo& info = s_component_infos[id];
+				size = align_up(size, info.alignment) + info.size * _capacity;
+			}
+			return size;
+		};
+		size_t entity_size = sizeof(Entity);
+		for ( u32 id : archetype.component_ids )
+		{
+			entity_size += s_component_infos[id].size;
+		}
+		size_t capacity = CHUNK_SIZE / entity_size;
+		while ( capacity > 0 && get_layout_size(capacity) > CHUNK_SIZE )
+		{
+			--capacity;
+		}
+		// 1つのエンティティがチャンクに収まらない組み合わせは作れない
+		if ( capacity == 0 )
+		{
+			m_archetypes.pop_back();
+			throw std::length_error(
+			    "the components of an entity exceed the chunk size");
+		}
+		archetype.chunk_capacity = capacity;
+
+		size_t offset = sizeof(Entity) * capacity;
+		for ( u32 id : archetype.component_ids )
+		{
+			const ComponentInfo& info = s_component_infos[id];
+			offset                    = align_up(offset, info.alignment);
+			archetype.columns[id]     = {static_cast<u32>(offset), info.size};
+			offset += info.size * capacity;
+		}
+
+		m_archetype_ids.emplace(_mask, archetype_id);
+		return archetype_id;
+	}
+
+	Entity EntitySystem::allocate_entity(u32 _archetype)
+	{
+		int64_t index = 0;
+		if ( !m_free_indices.empty() )
+		{
+			index = m_free_indices.back();
+			m_free_indices.pop_back();
+		}
+		else
+		{
+			index = static_cast<int64_t>(m_records.size());
+			m_records.emplace_back();
+		}
+
+		EntityRecord& record = m_records[index];
+		const Entity  entity = {index, record.generation};
+		record.archetype     = _archetype;
+		record.row           = allocate_row(m_archetypes[_archetype], entity);
+		++m_entity_num;
+		return entity;
+	}
+
+	size_t EntitySystem::allocate_row(Archetype& _archetype, Entity _entity)
+	{
+		const size_t row = _archetype.entity_num;
+		if ( row == _archetype.chunks.size() * _archetype.chunk_capacity )
+		{
+			_archetype.chunks.push_back(allocate_chunk());
+		}
+		_archetype.get_entities(row / _archetype.chunk_capacity)
+		    [row % _archetype.chunk_capacity] = _entity;
+		++_archetype.entity_num;
+		return row;
+	}
+
+	void EntitySystem::remove_row(Archetype& _archetype, size_t _row)
+	{
+		const size_t last     = _archetype.entity_num - 1;
+		const size_t capacity = _archetype.chunk_capacity;
+		if ( _row != last )
+		{
+			for ( u32 id : _archetype.component_ids )
+			{
+				const ComponentInfo& info = s_component_infos[id];
+				void*                dst  = _archetype.get_component(id, _row);
+				void*                src  = _archetype.get_component(id, last);
+				if ( info.relocate != nullptr )
+				{
+					info.relocate(dst, src);
+				}
+				else
+				{
+					std::memcpy(dst, src, info.size);
+				}
+			}
+
+			const Entity moved =
+			    _archetype.get_entities(last / capacity)[last % capacity];
+			_archetype.get_entities(_row / capacity)[_row % capacity] = moved;
+			m_records[moved.index].row                                = _row;
+		}
+
+		--_archetype.entity_num;
+		if ( _archetype.entity_num == (_archetype.chunks.size() - 1) * capacity )
+		{
+			m_free_chunks.push_back(_archetype.chunks.back());
+			_archetype.chunks.pop_back();
+		}
+	}
+
+	void EntitySystem::move_entity(Entity _entity, ComponentMask _mask)
+	{
+		EntityRecord& record = m_records[_entity.index];
+		// アーキタイプの追加で配列が伸びるので、先に移動先を決める
+		const u32  dst_id = find_or_create_archetype(_mask);
+		Archetype& src    = m_archetypes[record.archetype];
+		Archetype& dst    = m_archetypes[dst_id];
+
+		const size_t src_row = record.row;
+		const size_t dst_row = allocate_row(dst, _entity);
+		for ( u32 id : src.component_ids )
+		{
+			const ComponentInfo& info      = s_component_infos[id];
+			void*                component = src.get_component(id, src_row);
+			if ( (dst.mask & (ComponentMask(1) << id)) == 0 )
+			{
+				if ( info.destruct != nullptr )
+				{
+					info.destruct(component);
+				}
+			}
+			else if ( info.relocate != nullptr )
+			{
+				info.relocate(dst.get_component(id, dst_row), component);
+			}
+			else
+			{
+				std::memcpy(dst.get_component(id, dst_row), component, info.size);
+			}
+		}
+		remove_row(src, src_row);
+
+		record.archetype = dst_id;
+		record.row       = dst_row;
+	}
+
+	std::byte* EntitySystem::allocate_chunk()
+	{
+		if ( !m_free_chunks.empty() )
+		{
+			std::byte* chunk = m_free_chunks.back();
+			m_free_chunks.pop_back();
+			return chunk;
+		}
+		return static_cast<std::byte*>(
+		    get_allocator().allocate(CHUNK_SIZE, CHUNK_ALIGNMENT));
+	}
+
+	void EntitySystem::parallel_for_each_chunk_internal(
+	    ComponentMask _mask,
+	    void*         _context,
+	    ChunkFunction _function) const
+	{
+		// 一致するチャンクを並べてから、チャンク単位で分ける
+		struct ChunkRef
+		{
+			const Archetype* archetype;
+			size_t           chunk;
+		};
+		std::pmr::vector<ChunkRef> chunks(&get_allocator());
+		for ( const Archetype& archetype : m_archetypes )
+		{
+			if ( (archetype.mask & _mask) != _mask )
+			{
+				continue;
+			}
+			for ( size_t i = 0; i < archetype.chunks.size(); ++i )
+			{
+				chunks.push_back({&archetype, i});
+			}
+		}
+
+		bavil::core::SystemManager* context =
+		    bavil::core::SystemManager::GetCurrent();
+		if ( context == nullptr || chunks.size() <= 1 )
+		{
+			for ( const ChunkRef& chunk : chunks )
+			{
+				_function(_context, *chunk.archetype, chunk.chunk);
+			}
+			return;
+		}
+
+		TaskSystem::Get(*context).parallel_for(
+		    chunks.size(),
+		    1,
+		    [&](size_t _begin, size_t _end)
+		    {
+			    for ( size_t i = _begin; i < _end; ++i )
+			    {
+				    _function(_context, *chunks[i].archetype, chunks[i].chunk);
+			    }
+		    });
+	}
+
+} // namespace bavil
@@ -0,0 +1,77 @@
+#include "core/bavil_event_bus_system.h"
+
+#include <stdexcept>
+
+namespace bavil
+{
+
+	namespace
+	{
+		std::atomic<size_t> s_event_type_id = 0;
+	} // namespace
+
+	size_t EventBusSystem::GeneratedEventTypeIdInternal()
+	{
+		// チャンネルの配列を超えて参照しない様に、リリースビルドでも失敗させる
+		const size_t id = s_event_type_id++;
+		if ( id >= MAX_EVENT_TYPE_NUM )
+		{
+			throw std::length_error("EventBusSystem: too many event types");
+		}
+		return id;
+	}
+
+	void EventBusSystem::initialize(bavil::core::SystemManager& _system_manager)
+	{
+	}
+
+	void EventBusSystem::finalize()
+	{
+		std::lock_guard lock(m_channel_mutex);
+		for ( auto& channel : m_channels )
+		{
+			channel.store(nullptr, std::memory_order_relaxed);
+		}
+		m_channel_storage.clear();
+	}
+
+	void EventBusSystem::dispatch()
+	{
+		// 配信中に新しい型のチャンネルが作られても良い様に、数を確定してから回す
+		size_t channel_num = 0;
+		{
+			std::lock_guard lock(m_channel_mutex);
+			channel_num = m_channel_storage.size();
+		}
+
+		for ( size_t i = 0; i < channel_num; ++i )
+		{
+			EventChannelBase* channel = nullptr;
+			{
+				std::lock_guard lock(m_channel_mutex);
+				channel = m_channel_storage[i].get();
+			}
+			channel->dispatch();
+		}
+	}
+
+	EventBusSystem::EventChannelBase* EventBusSystem::create_channel(
+	    size_t _id, ChannelFactory _factory)
+	{
+		std::lock_guard lock(m_channel_mutex);
+
+		// 他のスレッドが先に作成している場合はそれを返す
+		EventChannelBase* channel = m_channels[_id].load(std::memory_order_acquire);
+		if ( channel != nullptr )
+		{
+			return channel;
+		}
+
+		auto new_channel = _factory(&get_allocator());
+		channel          = new_channel.get();
+		m_channel_storage.push_back(std::move(new_channel));
+		m_channels[_id].store(channel, std::memory_order_release);
+		return channel;
+	}
+
+} // namespace bavil
@@ -0,0 +1,174 @@
+#include "core/bavil_frame_allocator_system.h"
+
+#include <atomic>
+
+namespace bavil
+{
+
+	namespace
+	{
+		// システムのインスタンスを識別する為のID
+		std::atomic<u64> s_instance_id = 0;
+
+		// スレッド毎のアリーナのキャッシュ
+		struct ThreadArenaCache
+		{
+			u64   instance_id = 0;
+			void* arenas      = nullptr;
+		};
+		thread_local ThreadArenaCache t_arena_cache;
+	} // namespace
+
+	FrameAllocatorSystem::FrameAllocatorSystem(
+	    bavil::core::SystemAllocator& _allocator)
+	    : m_arena_allocator(&_allocator)
+	    , m_instance_id(++s_instance_id)
+	{
+		for ( size_t i = 0; i < BUFFER_NUM; ++i )
+		{
+			m_frame_arenas[i].set_upstream(m_arena_allocator);
+			m_frame_resources[i] = LinearArenaResource(&m_frame_arenas[i]);
+		}
+	}
+
+	void FrameAllocatorSystem::initialize(
+	    bavil::core::SystemManager& _system_manager)
+	{
+		set_frame_capacity(DEFAULT_FRAME_CAPACITY);
+	}
+
+	void FrameAllocatorSystem::finalize()
+	{
+		std::lock_guard lock(m_thread_mutex);
+		m_thread_arenas.clear();
+	}
+
+	void FrameAllocatorSystem::begin_frame()
+	{
+		m_current_buffer = (m_current_buffer + 1) % BUFFER_NUM;
+		m_frame_count++;
+
+		// 2フレーム前に使用していたバッファを開放する
+		m_frame_arenas[m_current_buffer].reset();
+
+		std::lock_guard lock(m_thread_mutex);
+		for ( auto& thread_arenas : m_thread_arenas )
+		{
+			thread_arenas->arenas[m_current_buffer].reset();
+		}
+	}
+
+	void FrameAllocatorSystem::set_frame_capacity(size_t _capacity)
+	{
+		for ( LinearArena& arena : m_frame_arenas )
+		{
+			arena.reserve(_capacity);
+		}
+	}
+
+	void FrameAllocatorSystem::set_thread_capacity(size_t _capacity)
+	{
+		std::lock_guard lock(m_thread_mutex);
+		m_thread_capacity = _capacity;
+		for ( auto& thread_arenas : m_thread_arenas )
+		{
+			for ( LinearArena& arena : thread_arenas->arenas )
+			{
+				arena.reserve(_capacity);
+			}
+		}
+	}
+
+	LinearArena& FrameAllocatorSystem::get_thread_arena()
+	{
+		return get_thread_arenas().arenas[m_current_buffer];
+	}
+
+	std::pmr::memory_resource* FrameAllocatorSystem::get_thread_memory_resource()
+	{
+		return &get_thread_arenas().resources[m_current_buffer];
+	}
+
+	FrameAllocatorSystem::ThreadArenas& FrameAllocatorSystem::get_thread_arenas()
+	{
+		// 同じシステムで取得済みであればロック無しで返す
+		if ( t_arena_cache.instance_id == m_instance_id )
+		{
+			return *static_cast<ThreadArenas*>(t_arena_cache.arenas);
+		}
+
+		std::lock_guard lock(m_thread_mutex);
+
+		const std::thread::id thread_id = std::this_thread::get_id();
+		ThreadArenas*         result    = nullptr;
+		for ( auto& thread_arenas : m_thread_arenas )
+		{
+			if ( thread_arenas->thread_id == thread_id )
+			{
+				result = thread_arenas.get();
+				break;
+			}
+		}
+
+		if ( result == nullptr )
+		{
+			auto new_arenas       = std::make_unique<ThreadArenas>();
+			new_arenas->thread_id = thread_id;
+			for ( size_t i = 0; i < BUFFER_NUM; ++i )
+			{
+				new_arenas->arenas[i].set_upstream(m_arena_allocator);
+				new_arenas->arenas[i].reserve(m_thread_capacity);
+				new_arenas->resources[i] = LinearArenaResource(&new_arenas->arenas[i]);
+			}
+			result = new_arenas.get();
+			m_thread_arenas.push_back(std::move(new_arenas));
+		}
+
+		t_arena_cache.instance_id = m_instance_id;
+		t_arena_cache.arenas      = result;
+		return *result;
+	}
+
+	FrameAllocatorStatistics FrameAllocatorSystem::get_statistics() const
+	{
+		FrameAllocatorStatistics result = {};
+
+		const LinearArena& current = m_frame_arenas[m_current_buffer];
+		result.used_bytes          = current.get_used_bytes();
+		for ( const LinearArena& arena : m_frame_arenas )
+		{
+			result.capacity_bytes += arena.get_capacity();
+			result.overflow_count += arena.get_overflow_count();
+			if ( result.high_water_mark < arena.get_high_water_mark() )
+			{
+				result.high_water_mark = arena.get_high_water_mark();
+			}
+		}
+		return result;
+	}
+
+	FrameAllocatorStatistics FrameAllocatorSystem::get_thread_statistics() const
+	{
+		FrameAllocatorStatistics result = {};
+
+		std::lock_guard lock(m_thread_mutex);
+		for ( const auto& thread_arenas : m_thread_arenas )
+		{
+			size_t high_water_mark = 0;
+			result.used_bytes +=
+			    thread_arenas->arenas[m_current_buffer].get_used_bytes();
+			for ( const LinearArena& arena : thread_arenas->arenas )
+			{
+				result.capacity_bytes += arena.get_capacity();
+				result.overflow_count += arena.get_overflow_count();
+				if ( high_water_mark < arena.get_high_water_mark() )
+				{
+					high_water_mark = arena.get_high_water_mark();
+				}
+			}
+			result.high_water_mark += high_water_mark;
+		}
+		return result;
+	}
+
+} // namespace bavil
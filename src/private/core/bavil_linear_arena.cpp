@@ -0,0 +1,145 @@
+#include "core/bavil_linear_arena.h"
+
+#include <cstdint>
+
+namespace bavil
+{
+
+	namespace
+	{
+		// オーバーフローブロックの最小サイズ
+		constexpr size_t MIN_OVERFLOW_BLOCK_SIZE = 4 * 1024;
+		// バッファのアライメント
+		constexpr size_t BUFFER_ALIGNMENT = alignof(std::max_align_t);
+
+		std::byte* align_pointer(std::byte* _ptr, size_t _alignment) noexcept
+		{
+			const auto address = reinterpret_cast<std::uintptr_t>(_ptr);
+			const auto aligned = (address + (_alignment - 1)) & ~(_alignment - 1);
+			return _ptr + (aligned - address);
+		}
+	} // namespace
+
+	LinearArena::LinearArena(size_t _capacity, std::pmr::memory_resource* _upstream)
+	    : m_upstream(_upstream)
+	{
+		reserve(_capacity);
+	}
+
+	LinearArena::~LinearArena()
+	{
+		release_overflow_blocks();
+		if ( m_buffer )
+		{
+			m_upstream->deallocate(m_buffer, m_capacity, BUFFER_ALIGNMENT);
+		}
+	}
+
+	void* LinearArena::allocate(size_t _size, size_t _alignment)
+	{
+		std::byte* aligned = align_pointer(m_buffer + m_offset, _alignment);
+		const auto end     = static_cast<size_t>(aligned - m_buffer) + _size;
+
+		if ( m_buffer != nullptr && end <= m_capacity )
+		{
+			m_offset = end;
+			return aligned;
+		}
+
+		return allocate_overflow(_size, _alignment);
+	}
+
+	void* LinearArena::allocate_overflow(size_t _size, size_t _alignment)
+	{
+		// 現在のオーバーフローブロックに収まるか確認する
+		if ( !m_overflow_blocks.empty() )
+		{
+			const Block& block   = m_overflow_blocks.back();
+			std::byte*   aligned = align_pointer(block.data + m_overflow_block_used,
+			                                     _alignment);
+			const auto   end     = static_cast<size_t>(aligned - block.data) + _size;
+			if ( end <= block.size )
+			{
+				m_overflow_used_bytes += end - m_overflow_block_used;
+				m_overflow_block_used = end;
+				return aligned;
+			}
+		}
+
+		// 新しいブロックを確保する
+		size_t block_size = _size + _alignment;
+		if ( block_size < m_capacity )
+		{
+			block_size = m_capacity;
+		}
+		if ( block_size < MIN_OVERFLOW_BLOCK_SIZE )
+		{
+			block_size = MIN_OVERFLOW_BLOCK_SIZE;
+		}
+
+		Block block = {};
+		block.data =
+		    static_cast<std::byte*>(m_upstream->allocate(block_size, BUFFER_ALIGNMENT));
+		block.size = block_size;
+		m_overflow_blocks.push_back(block);
+		m_overflow_count++;
+
+		std::byte* aligned    = align_pointer(block.data, _alignment);
+		m_overflow_block_used = static_cast<size_t>(aligned - block.data) + _size;
+		m_overflow_used_bytes += m_overflow_block_used;
+		return aligned;
+	}
+
+	void LinearArena::release_overflow_blocks()
+	{
+		for ( const Block& block : m_overflow_blocks )
+		{
+			m_upstream->deallocate(block.data, block.size, BUFFER_ALIGNMENT);
+		}
+		m_overflow_blocks.clear();
+		m_overflow_block_used = 0;
+	}
+
+	void LinearArena::reset()
+	{
+		const size_t used = get_used_bytes();
+		if ( m_high_water_mark < used )
+		{
+			m_high_water_mark = used;
+		}
+
+		m_offset              = 0;
+		m_overflow_used_bytes = 0;
+
+		// オーバーフローしていたら次回から収まるように拡張する
+		if ( !m_overflow_blocks.empty() )
+		{
+			release_overflow_blocks();
+			reserve(m_high_water_mark + m_high_water_mark / 2);
+		}
+	}
+
+	void LinearArena::reserve(size_t _capacity)
+	{
+		if ( _capacity <= m_capacity )
+		{
+			return;
+		}
+
+		// 使用中のメモリを無効にしない様に、未使用の時だけ拡張する
+		if ( get_used_bytes() != 0 )
+		{
+			return;
+		}
+
+		std::byte* new_buffer =
+		    static_cast<std::byte*>(m_upstream->allocate(_capacity, BUFFER_ALIGNMENT));
+		if ( m_buffer )
+		{
+			m_upstream->deallocate(m_buffer, m_capacity, BUFFER_ALIGNMENT);
+		}
+		m_buffer   = new_buffer;
+		m_capacity = _capacity;
+	}
+
+} // namespace bavil
@@ -0,0 +1,29 @@
+#include "core/bavil_multicast_delegate.h"
+
+#include "core/bavil_system_manager.h"
+#include "core/bavil_task_system.h"
+
+namespace bavil
+{
+
+	void ParallelBroadcastInternal(size_t _count,
+	                               size_t _min_chunk_size,
+	                               void*  _context,
+	                               void (*_function)(void*  _context,
+	                                                 size_t _begin,
+	                                                 size_t _end))
+	{
+		bavil::core::SystemManager* context =
+		    bavil::core::SystemManager::GetCurrent();
+		if ( context == nullptr )
+		{
+			_function(_context, 0, _count);
+			return;
+		}
+		TaskSystem::Get(*context).parallel_for(
+		    _count,
+		    _min_chunk_size,
+		    [&](size_t _begin, size_t _end) { _function(_context, _begin, _end); });
+	}
+
+} // namespace bavil
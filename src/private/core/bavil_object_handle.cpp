@@ -43,6 +43,26 @@ namespace bavil
 		return 0;
 	}
 
+	ObjectBinding ObjectHandleBase::get_binding() const
+	{
+		ObjectBinding result = {};
+		if ( const auto* item =
+		         ObjectSystem::Get().get_object_array_internal(*this) )
+		{
+			if ( item->ObjectPtr != nullptr )
+			{
+				result.index      = m_index;
+				result.generation = item->Generation;
+			}
+		}
+		return result;
+	}
+
+	bool ObjectBinding::is_alive() const
+	{
+		return ObjectSystem::Get().is_alive_internal(*this);
+	}
+
 	ObjectBase* ObjectHandleBase::get_object_internal() const
 	{
 		// オブジェクトシステム経由でオブジェクトを取得する
@@ -1,5 +1,7 @@
 #include "core/bavil_object_system.h"
 
+#include <algorithm>
+
 //#include <optick.h>
 
 bavil::ObjectArrayItem* __debug__bavil_object_array_top = nullptr;
@@ -23,8 +25,7 @@ namespace bavil
 		{
 			if ( item.ObjectPtr )
 			{
-				delete item.ObjectPtr;
-				item.ObjectPtr = nullptr;
+				destroy_object_internal(item);
 			}
 		}
 	}
@@ -80,6 +81,29 @@ namespace bavil
 		return nullptr;
 	}
 
+	[[nodiscard]] bool ObjectSystem::is_alive_internal(
+	    const ObjectBinding& _binding) const
+	{
+		if ( _binding.index < 0 || m_objects.size() <= _binding.index )
+		{
+			return false;
+		}
+
+		const ObjectArrayItem& item = m_objects[_binding.index];
+		return item.ObjectPtr != nullptr && item.Generation == _binding.generation;
+	}
+
+	void ObjectSystem::invalidate_bindings_internal(
+	    const ObjectHandleBase& _handle)
+	{
+		if ( ObjectArrayItem* item = get_object_array_internal(_handle);
+		     item != nullptr && item->ObjectPtr != nullptr )
+		{
+			item->Generation++;
+			ObjectBinding::s_destroy_serial.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
 	// オブジェクトの参照を加算する
 	void ObjectSystem::object_reference_increment_internal(
 	    const ObjectHandleBase& _handle)
@@ -100,19 +124,22 @@ namespace bavil
 			if ( item->ReferenceNum == 0 )
 			{
 				// 参照数が0になったので削除する必要が有る
-				delete item->ObjectPtr;
-				item->ObjectPtr = nullptr;
+				destroy_object_internal(*item);
 				m_object_num--;
 			}
 		}
 	}
 
 	ObjectHandleBase ObjectSystem::create_object_internal(int32_t     _free_index,
-	                                                      ObjectBase* new_object)
+	                                                      ObjectBase* new_object,
+	                                                      size_t      _size,
+	                                                      size_t      _alignment)
 	{
-		int32_t index  = _free_index;
-		auto&   item   = m_objects[index];
-		item.ObjectPtr = new_object;
+		int32_t index        = _free_index;
+		auto&   item         = m_objects[index];
+		item.ObjectPtr       = new_object;
+		item.ObjectSize      = _size;
+		item.ObjectAlignment = _alignment;
 
 		m_object_num++;
 
@@ -122,6 +149,29 @@ namespace bavil
 		return ObjectHandleBase(index);
 	}
 
+	void ObjectSystem::destroy_object_internal(ObjectArrayItem& _item)
+	{
+		// 派生クラスの先頭アドレスで確保しているので、そのアドレスで解放する
+		void* memory = dynamic_cast<void*>(_item.ObjectPtr);
+
+		// 破棄を行う
+		_item.ObjectPtr->destruct();
+		_item.ObjectPtr->~ObjectBase();
+		get_allocator().deallocate(memory, _item.ObjectSize, _item.ObjectAlignment);
+
+		_item.ObjectPtr       = nullptr;
+		_item.ObjectSize      = 0;
+		_item.ObjectAlignment = 0;
+
+		// 破棄前に取得した ObjectBinding を無効にする
+		_item.Generation++;
+		ObjectBinding::s_destroy_serial.fetch_add(1, std::memory_order_relaxed);
+
+		// 空いた位置から次の空きを検索する
+		m_free_index =
+		    std::min(m_free_index, static_cast<size_t>(&_item - m_objects.data()));
+	}
+
 	int32_t ObjectSystem::generated_free_index()
 	{
 		int32_t result = -1;
@@ -0,0 +1,578 @@
+#include "core/bavil_spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bavil
+{
+
+	namespace
+	{
+		using Vector3 = bavil::math::Vector3;
+		using AABB    = bavil::math::AABB;
+
+		/**
+		 * @brief 要素の配列を番号で管理する索引の基底クラス
+		 * 削除した要素の番号は次の追加で再利用する
+		 */
+		template<class Entry>
+		class EntryTableIndex : public SpatialIndex
+		{
+		public:
+			explicit EntryTableIndex(std::pmr::memory_resource* _resource)
+			    : m_entries(_resource)
+			    , m_free_ids(_resource)
+			{
+			}
+
+			virtual size_t size() const noexcept override
+			{
+				return m_entries.size() - m_free_ids.size();
+			}
+
+		protected:
+			u32 allocate_entry(bavil::Actor* _actor, const Vector3& _position)
+			{
+				u32 id = 0;
+				if ( !m_free_ids.empty() )
+				{
+					id = m_free_ids.back();
+					m_free_ids.pop_back();
+				}
+				else
+				{
+					id = static_cast<u32>(m_entries.size());
+					m_entries.emplace_back();
+				}
+				m_entries[id].actor    = _actor;
+				m_entries[id].position = _position;
+				return id;
+			}
+
+			void free_entry(u32 _id)
+			{
+				m_entries[_id].actor = nullptr;
+				m_free_ids.push_back(_id);
+			}
+
+			void clear_entries() noexcept
+			{
+				m_entries.clear();
+				m_free_ids.clear();
+			}
+
+			// 配列から要素の番号を取り除き、末尾の要素を移す
+			void swap_remove(std::pmr::vector<u32>& _ids, u32 _slot) noexcept
+			{
+				const u32 last        = _ids.back();
+				_ids[_slot]           = last;
+				m_entries[last].slot  = _slot;
+				_ids.pop_back();
+			}
+
+			// 配列の要素のうち境界ボックスに含まれる要素を呼び出す
+			void query_ids(const std::pmr::vector<u32>& _ids,
+			               const AABB&                  _aabb,
+			               bool                         _is_inside,
+			               void*                        _context,
+			               QueryFunction                _function) const
+			{
+				for ( const u32 id : _ids )
+				{
+					const Entry& entry = m_entries[id];
+					if ( _is_inside || _aabb.contains(entry.position) )
+					{
+						_function(_context, *entry.actor, entry.position);
+					}
+				}
+			}
+
+		protected:
+			std::pmr::vector<Entry> m_entries;
+			std::pmr::vector<u32>   m_free_ids;
+		};
+
+		struct HashedGridEntry
+		{
+			bavil::Actor* actor = nullptr;
+			Vector3       position;
+			// 格納している格子のキーと、格子の配列での位置
+			u64 cell = 0;
+			u32 slot = 0;
+		};
+
+		/**
+		 * @brief 一定の大きさの格子に分けた索引
+		 * 要素が存在する格子のみを、格子の座標をまとめたキーのハッシュで保持する
+		 */
+		class HashedGridIndex final : public EntryTableIndex<HashedGridEntry>
+		{
+		public:
+			HashedGridIndex(const SpatialIndexSettings& _settings,
+			                std::pmr::memory_resource*  _resource);
+
+			virtual u32 insert(bavil::Actor*  _actor,
+			                   const Vector3& _position) override;
+
+			virtual void update(u32 _id, const Vector3& _position) override;
+
+			virtual void remove(u32 _id) override;
+
+			virtual void clear() override;
+
+		protected:
+			virtual void query_aabb_internal(const AABB&   _aabb,
+			                                 void*         _context,
+			                                 QueryFunction _function) const override;
+
+		private:
+			// 格子の座標は各軸21ビットに収めてキーにまとめる
+			static constexpr s32 COORDINATE_MIN = -(1 << 20);
+			static constexpr s32 COORDINATE_MAX = (1 << 20) - 1;
+
+			struct CellHash
+			{
+				size_t operator()(u64 _key) const noexcept
+				{
+					// 近い格子のキーが偏らないように混ぜる
+					_key ^= _key >> 33;
+					_key *= 0xff51afd7ed558ccdull;
+					_key ^= _key >> 33;
+					return static_cast<size_t>(_key);
+				}
+			};
+
+			s32 to_coordinate(f32 _value) const noexcept
+			{
+				// 数値でない座標は変換せずに最小の格子にまとめる
+				const f32 coordinate = std::floor(_value * m_inverse_cell_size);
+				if ( std::isnan(coordinate) )
+				{
+					return COORDINATE_MIN;
+				}
+				if ( coordinate <= static_cast<f32>(COORDINATE_MIN) )
+				{
+					return COORDINATE_MIN;
+				}
+				if ( coordinate >= static_cast<f32>(COORDINATE_MAX) )
+				{
+					return COORDINATE_MAX;
+				}
+				return static_cast<s32>(coordinate);
+			}
+
+			static u64 to_key(s32 _x, s32 _y, s32 _z) noexcept
+			{
+				constexpr u64 MASK = (1ull << 21) - 1;
+				return ((static_cast<u64>(_x - COORDINATE_MIN) & MASK) << 42) |
+				       ((static_cast<u64>(_y - COORDINATE_MIN) & MASK) << 21) |
+				       (static_cast<u64>(_z - COORDINATE_MIN) & MASK);
+			}
+
+			u64 to_key(const Vector3& _position) const noexcept
+			{
+				return to_key(to_coordinate(_position.x),
+				              to_coordinate(_position.y),
+				              to_coordinate(_position.z));
+			}
+
+			void link(u32 _id, u64 _key);
+			void unlink(u32 _id);
+
+		private:
+			using CellMap =
+			    std::pmr::unordered_map<u64, std::pmr::vector<u32>, CellHash>;
+
+			f32     m_inverse_cell_size;
+			CellMap m_cells;
+		};
+
+		HashedGridIndex::HashedGridIndex(const SpatialIndexSettings& _settings,
+		                                 std::pmr::memory_resource*  _resource)
+		    : EntryTableIndex(_resource)
+		    , m_inverse_cell_size(1.0f / _settings.cell_size)
+		    , m_cells(_resource)
+		{
+		}
+
+		u32 HashedGridIndex::insert(bavil::Actor* _actor, const Vector3& _position)
+		{
+			const u32 id = allocate_entry(_actor, _position);
+			link(id, to_key(_position));
+			return id;
+		}
+
+		void HashedGridIndex::update(u32 _id, const Vector3& _position)
+		{
+			HashedGridEntry& entry = m_entries[_id];
+			entry.position         = _position;
+
+			// 格子が変わった場合のみ移し替える
+			const u64 key = to_key(_position);
+			if ( key != entry.cell )
+			{
+				unlink(_id);
+				link(_id, key);
+			}
+		}
+
+		void HashedGridIndex::remove(u32 _id)
+		{
+			unlink(_id);
+			free_entry(_id);
+		}
+
+		void HashedGridIndex::clear()
+		{
+			clear_entries();
+			m_cells.clear();
+		}
+
+		void HashedGridIndex::link(u32 _id, u64 _key)
+		{
+			std::pmr::vector<u32>& cell = m_cells.try_emplace(_key).first->second;
+
+			HashedGridEntry& entry = m_entries[_id];
+			entry.cell             = _key;
+			entry.slot             = static_cast<u32>(cell.size());
+			cell.push_back(_id);
+		}
+
+		void HashedGridIndex::unlink(u32 _id)
+		{
+			const HashedGridEntry& entry = m_entries[_id];
+
+			auto it = m_cells.find(entry.cell);
+			swap_remove(it->second, entry.slot);
+			// 空の格子は保持しない
+			if ( it->second.empty() )
+			{
+				m_cells.erase(it);
+			}
+		}
+
+		void HashedGridIndex::query_aabb_internal(const AABB&   _aabb,
+		                                          void*         _context,
+		                                          QueryFunction _function) const
+		{
+			const s32 min_x = to_coordinate(_aabb.min.x);
+			const s32 min_y = to_coordinate(_aabb.min.y);
+			const s32 min_z = to_coordinate(_aabb.min.z);
+			const s32 max_x = to_coordinate(_aabb.max.x);
+			const s32 max_y = to_coordinate(_aabb.max.y);
+			const s32 max_z = to_coordinate(_aabb.max.z);
+			if ( max_x < min_x || max_y < min_y || max_z < min_z )
+			{
+				return;
+			}
+
+			// 範囲の格子の数が要素の存在する格子より多い場合は、存在する格子を全て調べる
+			const u64 cell_num = static_cast<u64>(max_x - min_x + 1) *
+			                     static_cast<u64>(max_y - min_y + 1) *
+			                     static_cast<u64>(max_z - min_z + 1);
+			if ( cell_num > m_cells.size() )
+			{
+				for ( const auto& [key, cell] : m_cells )
+				{
+					query_ids(cell, _aabb, false, _context, _function);
+				}
+				return;
+			}
+
+			for ( s32 x = min_x; x <= max_x; ++x )
+			{
+				for ( s32 y = min_y; y <= max_y; ++y )
+				{
+					for ( s32 z = min_z; z <= max_z; ++z )
+					{
+						auto it = m_cells.find(to_key(x, y, z));
+						if ( it != m_cells.end() )
+						{
+							query_ids(it->second, _aabb, false, _context, _function);
+						}
+					}
+				}
+			}
+		}
+
+		struct OctreeEntry
+		{
+			bavil::Actor* actor = nullptr;
+			Vector3       position;
+			// 格納している葉と、葉の配列での位置
+			u32 node = 0;
+			u32 slot = 0;
+		};
+
+		/**
+		 * @brief 要素が多い範囲ほど細かく8分割する索引
+		 * 要素は常に葉に格納し、葉の要素数が上限を超えた時に分割する
+		 * 分割する範囲の外の要素は、分割せずに別の配列にまとめて保持する
+		 */
+		class OctreeIndex final : public EntryTableIndex<OctreeEntry>
+		{
+		public:
+			OctreeIndex(const SpatialIndexSettings& _settings,
+			            std::pmr::memory_resource*  _resource);
+
+			virtual u32 insert(bavil::Actor*  _actor,
+			                   const Vector3& _position) override;
+
+			virtual void update(u32 _id, const Vector3& _position) override;
+
+			virtual void remove(u32 _id) override;
+
+			virtual void clear() override;
+
+		protected:
+			virtual void query_aabb_internal(const AABB&   _aabb,
+			                                 void*         _context,
+			                                 QueryFunction _function) const override;
+
+		private:
+			// 範囲外の要素を格納している事を表す葉の番号
+			static constexpr u32 OUTSIDE_NODE = INVALID_ID;
+
+			struct Node
+			{
+				AABB bounds;
+				// 8つの子の先頭の番号(葉の場合は無効)
+				u32 first_child = INVALID_ID;
+				// 葉に格納している要素
+				std::pmr::vector<u32> ids;
+			};
+
+			void link(u32 _id);
+			void unlink(u32 _id);
+			// 葉を分割して要素を子に移す
+			void split(u32 _node);
+
+			u32 find_child(const Node& _node, const Vector3& _position) const
+			{
+				const Vector3 center = _node.bounds.get_center();
+				return _node.first_child + (_position.x >= center.x ? 1 : 0) +
+				       (_position.y >= center.y ? 2 : 0) +
+				       (_position.z >= center.z ? 4 : 0);
+			}
+
+			void query_node(u32           _node,
+			                const AABB&   _aabb,
+			                void*         _context,
+			                QueryFunction _function) const;
+
+		private:
+			std::pmr::memory_resource* m_resource;
+			f32                        m_min_node_size;
+			u32                        m_leaf_capacity;
+			std::pmr::vector<Node>     m_nodes;
+			std::pmr::vector<u32>      m_outside_ids;
+		};
+
+		OctreeIndex::OctreeIndex(const SpatialIndexSettings& _settings,
+		                         std::pmr::memory_resource*  _resource)
+		    : EntryTableIndex(_resource)
+		    , m_resource(_resource)
+		    , m_min_node_size(_settings.cell_size)
+		    , m_leaf_capacity(std::max(_settings.leaf_capacity, 1u))
+		    , m_nodes(_resource)
+		    , m_outside_ids(_resource)
+		{
+			m_nodes.push_back(
+			    {_settings.bounds, INVALID_ID, std::pmr::vector<u32>(m_resource)});
+		}
+
+		u32 OctreeIndex::insert(bavil::Actor* _actor, const Vector3& _position)
+		{
+			const u32 id = allocate_entry(_actor, _position);
+			link(id);
+			return id;
+		}
+
+		void OctreeIndex::update(u32 _id, const Vector3& _position)
+		{
+			OctreeEntry& entry = m_entries[_id];
+			entry.position     = _position;
+
+			// 同じ葉に留まる場合は移し替えない
+			if ( entry.node == OUTSIDE_NODE
+			         ? !m_nodes[0].bounds.contains(_position)
+			         : m_nodes[entry.node].bounds.contains(_position) )
+			{
+				return;
+			}
+			unlink(_id);
+			link(_id);
+		}
+
+		void OctreeIndex::remove(u32 _id)
+		{
+			unlink(_id);
+			free_entry(_id);
+		}
+
+		void OctreeIndex::clear()
+		{
+			clear_entries();
+			m_nodes.resize(1);
+			m_nodes[0].first_child = INVALID_ID;
+			m_nodes[0].ids.clear();
+			m_outside_ids.clear();
+		}
+
+		void OctreeIndex::link(u32 _id)
+		{
+			OctreeEntry& entry = m_entries[_id];
+			if ( !m_nodes[0].bounds.contains(entry.position) )
+			{
+				entry.node = OUTSIDE_NODE;
+				entry.slot = static_cast<u32>(m_outside_ids.size());
+				m_outside_ids.push_back(_id);
+				return;
+			}
+
+			u32 node = 0;
+			while ( m_nodes[node].first_child != INVALID_ID )
+			{
+				node = find_child(m_nodes[node], entry.position);
+			}
+
+			entry.node = node;
+			entry.slot = static_cast<u32>(m_nodes[node].ids.size());
+			m_nodes[node].ids.push_back(_id);
+			if ( m_nodes[node].ids.size() > m_leaf_capacity )
+			{
+				split(node);
+			}
+		}
+
+		void OctreeIndex::unlink(u32 _id)
+		{
+			const OctreeEntry& entry = m_entries[_id];
+			auto& ids =
+			    entry.node == OUTSIDE_NODE ? m_outside_ids : m_nodes[entry.node].ids;
+			swap_remove(ids, entry.slot);
+		}
+
+		void OctreeIndex::split(u32 _node)
+		{
+			const AABB bounds = m_nodes[_node].bounds;
+			if ( (bounds.max.x - bounds.min.x) * 0.5f < m_min_node_size )
+			{
+				return;
+			}
+
+			// 子を追加すると配列が再確保されるので、参照は追加後に取得する
+			const Vector3 center      = bounds.get_center();
+			const u32     first_child = static_cast<u32>(m_nodes.size());
+			for ( u32 i = 0; i < 8; ++i )
+			{
+				const AABB child_bounds = {
+				    {(i & 1) ? center.x : bounds.min.x,
+				     (i & 2) ? center.y : bounds.min.y,
+				     (i & 4) ? center.z : bounds.min.z},
+				    {(i & 1) ? bounds.max.x : center.x,
+				     (i & 2) ? bounds.max.y : center.y,
+				     (i & 4) ? bounds.max.z : center.z}};
+				m_nodes.push_back(
+				    {child_bounds, INVALID_ID, std::pmr::vector<u32>(m_resource)});
+			}
+
+			std::pmr::vector<u32> ids = std::move(m_nodes[_node].ids);
+			m_nodes[_node].ids        = std::pmr::vector<u32>(m_resource);
+			m_nodes[_node].first_child = first_child;
+
+			for ( const u32 id : ids )
+			{
+				OctreeEntry& entry = m_entries[id];
+				const u32    child = find_child(m_nodes[_node], entry.position);
+				entry.node         = child;
+				entry.slot         = static_cast<u32>(m_nodes[child].ids.size());
+				m_nodes[child].ids.push_back(id);
+			}
+
+			// 1つの子に偏った場合はさらに分割する
+			for ( u32 child = first_child; child < first_child + 8; ++child )
+			{
+				if ( m_nodes[child].ids.size() > m_leaf_capacity )
+				{
+					split(child);
+				}
+			}
+		}
+
+		void OctreeIndex::query_aabb_internal(const AABB&   _aabb,
+		                                      void*         _context,
+		                                      QueryFunction _function) const
+		{
+			query_ids(m_outside_ids, _aabb, false, _context, _function);
+			query_node(0, _aabb, _context, _function);
+		}
+
+		void OctreeIndex::query_node(u32           _node,
+		                             const AABB&   _aabb,
+		                             void*         _context,
+		                             QueryFunction _function) const
+		{
+			const Node& node = m_nodes[_node];
+			if ( !_aabb.intersects(node.bounds) )
+			{
+				return;
+			}
+			if ( node.first_child == INVALID_ID )
+			{
+				// 葉が全て含まれる場合は要素毎に調べる必要が無い
+				const bool is_inside = _aabb.contains(node.bounds);
+				query_ids(node.ids, _aabb, is_inside, _context, _function);
+				return;
+			}
+			for ( u32 i = 0; i < 8; ++i )
+			{
+				query_node(node.first_child + i, _aabb, _context, _function);
+			}
+		}
+
+	} // namespace
+
+	std::unique_ptr<SpatialIndex> SpatialIndex::Create(
+	    const SpatialIndexSettings& _settings, std::pmr::memory_resource* _resource)
+	{
+		// 格子の大きさが0以下だと近傍の検索で半径が広がらず、八分木の分割も
+		// 止まらないので、リリースビルドでも失敗させる
+		if ( _settings.type != SpatialIndexType::None &&
+		     !(_settings.cell_size > 0.0f && std::isfinite(_settings.cell_size)) )
+		{
+			throw std::invalid_argument(
+			    "SpatialIndex: cell_size must be positive and finite");
+		}
+		if ( _settings.type == SpatialIndexType::Octree )
+		{
+			const auto is_valid_range = [](f32 _min, f32 _max)
+			{
+				return std::isfinite(_min) && std::isfinite(_max) && _min <= _max;
+			};
+			const AABB& bounds = _settings.bounds;
+			if ( !is_valid_range(bounds.min.x, bounds.max.x) ||
+			     !is_valid_range(bounds.min.y, bounds.max.y) ||
+			     !is_valid_range(bounds.min.z, bounds.max.z) )
+			{
+				throw std::invalid_argument(
+				    "SpatialIndex: octree bounds must be finite");
+			}
+		}
+
+		switch ( _settings.type )
+		{
+		case SpatialIndexType::HashedGrid:
+			return std::make_unique<HashedGridIndex>(_settings, _resource);
+		case SpatialIndexType::Octree:
+			return std::make_unique<OctreeIndex>(_settings, _resource);
+		default:
+			return nullptr;
+		}
+	}
+
+} // namespace bavil
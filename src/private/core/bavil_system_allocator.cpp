@@ -0,0 +1,43 @@
+#include "core/bavil_system_allocator.h"
+
+namespace bavil::core
+{
+
+	void* SystemAllocator::do_allocate(size_t _bytes, size_t _alignment)
+	{
+		const size_t live_bytes =
+		    m_live_bytes.fetch_add(_bytes, std::memory_order_relaxed) + _bytes;
+
+		// 予算を超えた場合は即座に失敗させる
+		const size_t budget_bytes = get_budget();
+		if ( budget_bytes != 0 && live_bytes > budget_bytes )
+		{
+			m_live_bytes.fetch_sub(_bytes, std::memory_order_relaxed);
+			throw std::bad_alloc();
+		}
+
+		void* result = m_upstream->allocate(_bytes, _alignment);
+
+		m_allocation_num.fetch_add(1, std::memory_order_relaxed);
+
+		// 最大確保バイト数を更新する
+		size_t peak_bytes = m_peak_bytes.load(std::memory_order_relaxed);
+		while ( peak_bytes < live_bytes &&
+		        !m_peak_bytes.compare_exchange_weak(peak_bytes,
+		                                            live_bytes,
+		                                            std::memory_order_relaxed) )
+		{
+		}
+
+		return result;
+	}
+
+	void SystemAllocator::do_deallocate(void* _p, size_t _bytes, size_t _alignment)
+	{
+		m_upstream->deallocate(_p, _bytes, _alignment);
+
+		m_live_bytes.fetch_sub(_bytes, std::memory_order_relaxed);
+		m_allocation_num.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+} // namespace bavil::core
@@ -1,39 +1,87 @@
 #include "core/bavil_system_manager.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace bavil::core
 {
 
 	SystemManager::SystemManager() noexcept
 	{
-		m_instance = this;
+		t_current_context = this;
 	}
 
 	SystemManager::~SystemManager() noexcept
 	{
-		m_instance = nullptr;
-	}
-
-	SystemManager& SystemManager::Get()
-	{
-		return *m_instance;
+		if ( t_current_context == this )
+		{
+			t_current_context = nullptr;
+		}
 	}
 
 	void SystemManager::finalize()
 	{
-		for ( auto& [id, system] : system_maps )
+		// 依存先より先に終了させる為に、初期化が完了した順の逆順で終了する
+		while ( !m_initialized_systems.empty() )
 		{
+			SystemInterface* system = m_initialized_systems.back();
+			m_initialized_systems.pop_back();
+
 			system->finalize();
+
+			m_systems[system->get_system_id()] = nullptr;
 			delete system;
 		}
 
-		system_maps.clear();
+		m_systems.clear();
+	}
+
+	void SystemManager::register_system(size_t _id, SystemInterface* _system)
+	{
+		if ( m_systems.size() <= _id )
+		{
+			m_systems.resize(_id + 1, nullptr);
+		}
+		m_systems[_id] = _system;
+	}
+
+	SystemAllocator& SystemManager::get_system_allocator(size_t _system_id)
+	{
+		if ( m_allocators.size() <= _system_id )
+		{
+			m_allocators.resize(_system_id + 1);
+		}
+
+		auto& allocator = m_allocators[_system_id];
+		if ( !allocator )
+		{
+			allocator = std::make_unique<SystemAllocator>(_system_id);
+		}
+		return *allocator;
+	}
+
+	std::vector<SystemMemoryReport> SystemManager::get_memory_report() const
+	{
+		std::vector<SystemMemoryReport> result;
+		result.reserve(m_allocators.size());
+
+		// システムID順に並んでいる
+		for ( const auto& allocator : m_allocators )
+		{
+			if ( allocator )
+			{
+				result.push_back(allocator->get_report());
+			}
+		}
+
+		return result;
 	}
 
 	size_t SystemManager::GetneratedSystemIdInternal()
 	{
-		static size_t s_id = 0;
-		s_id++;
-		return s_id;
+		// 複数のコンテキストから同時に生成される可能性がある
+		static std::atomic<size_t> s_id = 0;
+		return ++s_id;
 	}
 
 } // namespace bavil::core
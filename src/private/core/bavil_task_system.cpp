@@ -0,0 +1,177 @@
+#include "core/bavil_task_system.h"
+
+#include <algorithm>
+
+namespace bavil
+{
+
+	namespace
+	{
+		// ワーカースレッド間で負荷を均す為に、スレッド数より細かく分割する
+		constexpr size_t CHUNK_NUM_PER_THREAD = 4;
+	} // namespace
+
+	void TaskSystem::initialize(bavil::core::SystemManager& _system_manager)
+	{
+		m_system_manager = &_system_manager;
+
+		// 呼び出したスレッドも実行に参加するので、その分を除く
+		const size_t hardware_num = std::thread::hardware_concurrency();
+		start_workers(hardware_num > 1 ? hardware_num - 1 : 0);
+	}
+
+	void TaskSystem::finalize()
+	{
+		stop_workers();
+		m_system_manager = nullptr;
+	}
+
+	void TaskSystem::set_worker_num(size_t _worker_num)
+	{
+		stop_workers();
+		start_workers(_worker_num);
+	}
+
+	void TaskSystem::parallel_for_internal(size_t        _count,
+	                                       size_t        _min_chunk_size,
+	                                       void*         _context,
+	                                       RangeFunction _function)
+	{
+		if ( _count == 0 )
+		{
+			return;
+		}
+
+		const size_t thread_num = m_workers.size() + 1;
+		const size_t chunk_size =
+		    std::max({_min_chunk_size,
+		              (_count + thread_num * CHUNK_NUM_PER_THREAD - 1) /
+		                  (thread_num * CHUNK_NUM_PER_THREAD),
+		              size_t(1)});
+		const size_t chunk_num = (_count + chunk_size - 1) / chunk_size;
+
+		if ( m_workers.empty() || chunk_num <= 1 )
+		{
+			_function(_context, 0, _count);
+			return;
+		}
+
+		Job job;
+		job.context    = _context;
+		job.function   = _function;
+		job.count      = _count;
+		job.chunk_size = chunk_size;
+		job.chunk_num  = chunk_num;
+
+		{
+			std::lock_guard lock(m_mutex);
+			m_jobs.push_back(&job);
+		}
+		m_wake_condition.notify_all();
+
+		execute(job);
+
+		// 全てのチャンクは取り出し済みなので、実行中のワーカースレッドが終わるのを待つ
+		// ジョブはスタックに置いているので、例外を投げ直すのも待った後にする
+		std::unique_lock lock(m_mutex);
+		std::erase(m_jobs, &job);
+		m_done_condition.wait(lock,
+		                      [&]()
+		                      {
+			                      return job.worker_num == 0;
+		                      });
+		if ( job.exception != nullptr )
+		{
+			std::rethrow_exception(job.exception);
+		}
+	}
+
+	void TaskSystem::execute(Job& _job)
+	{
+		try
+		{
+			for ( ;; )
+			{
+				const size_t chunk =
+				    _job.next_chunk.fetch_add(1, std::memory_order_relaxed);
+				if ( chunk >= _job.chunk_num )
+				{
+					return;
+				}
+
+				const size_t begin = chunk * _job.chunk_size;
+				const size_t end   = std::min(begin + _job.chunk_size, _job.count);
+				_job.function(_job.context, begin, end);
+			}
+		}
+		catch ( ... )
+		{
+			_job.next_chunk.store(_job.chunk_num, std::memory_order_relaxed);
+
+			std::lock_guard lock(m_mutex);
+			if ( _job.exception == nullptr )
+			{
+				_job.exception = std::current_exception();
+			}
+		}
+	}
+
+	void TaskSystem::start_workers(size_t _worker_num)
+	{
+		m_is_stopping = false;
+		m_workers.reserve(_worker_num);
+		for ( size_t i = 0; i < _worker_num; ++i )
+		{
+			m_workers.emplace_back(&TaskSystem::worker_main, this);
+		}
+	}
+
+	void TaskSystem::stop_workers()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_is_stopping = true;
+		}
+		m_wake_condition.notify_all();
+
+		for ( std::thread& worker : m_workers )
+		{
+			worker.join();
+		}
+		m_workers.clear();
+	}
+
+	void TaskSystem::worker_main()
+	{
+		bavil::core::SystemManager::ScopedContext context(*m_system_manager);
+
+		std::unique_lock lock(m_mutex);
+		for ( ;; )
+		{
+			m_wake_condition.wait(lock,
+			                      [&]()
+			                      {
+				                      return m_is_stopping || !m_jobs.empty();
+			                      });
+			if ( m_is_stopping )
+			{
+				return;
+			}
+
+			Job* job = m_jobs.back();
+			job->worker_num++;
+			lock.unlock();
+
+			execute(*job);
+
+			lock.lock();
+			// 取り出すチャンクが無くなったジョブは他のワーカースレッドに渡さない
+			std::erase(m_jobs, job);
+			if ( --job->worker_num == 0 )
+			{
+				m_done_condition.notify_all();
+			}
+		}
+	}
+
+} // namespace bavil
@@ -0,0 +1,332 @@
+#include "core/bavil_timer_system.h"
+
+#include <cmath>
+
+namespace bavil
+{
+
+	namespace
+	{
+		// 秒数からティック数に変換する時の誤差の許容量(ティック単位)
+		constexpr f64 TICK_EPSILON = 1.0e-3;
+
+		// 秒数を切り上げたティック数に変換する
+		u64 to_ticks_ceil(f32 _seconds, f32 _tick_interval) noexcept
+		{
+			const f64 ticks = static_cast<f64>(_seconds) / _tick_interval;
+			if ( ticks <= 0.0 )
+			{
+				return 0;
+			}
+			return static_cast<u64>(std::ceil(ticks - TICK_EPSILON));
+		}
+
+		// 指定した段のホイールの先頭のスロット番号を取得する
+		constexpr u32 get_wheel_offset(u32 _level) noexcept
+		{
+			return _level == 0 ? 0
+			                   : TimerSystem::ROOT_WHEEL_SIZE +
+			                         TimerSystem::WHEEL_SIZE * (_level - 1);
+		}
+
+		// 指定した段のホイールのシフト量を取得する
+		constexpr u32 get_wheel_shift(u32 _level) noexcept
+		{
+			return _level == 0 ? 0
+			                   : TimerSystem::ROOT_WHEEL_BITS +
+			                         TimerSystem::WHEEL_BITS * (_level - 1);
+		}
+	} // namespace
+
+	TimerSystem::TimerSystem(bavil::core::SystemAllocator& _allocator)
+	    : m_nodes(&_allocator)
+	    , m_callbacks(&_allocator)
+	{
+		m_list_heads.fill(TimerHandle::INVALID_INDEX);
+	}
+
+	void TimerSystem::initialize(bavil::core::SystemManager& _system_manager) {}
+
+	void TimerSystem::finalize()
+	{
+		m_nodes.clear();
+		m_callbacks.clear();
+		m_list_heads.fill(TimerHandle::INVALID_INDEX);
+		m_free_head        = TimerHandle::INVALID_INDEX;
+		m_active_timer_num = 0;
+	}
+
+	TimerHandle TimerSystem::schedule(f32 _delay, Callback _callback, f32 _interval)
+	{
+		const u64 delay_ticks = to_ticks_ceil(_delay, m_tick_interval);
+
+		u64 interval_ticks = 0;
+		if ( _interval > 0.0f )
+		{
+			interval_ticks = to_ticks_ceil(_interval, m_tick_interval);
+			interval_ticks = interval_ticks > 0 ? interval_ticks : 1;
+		}
+
+		return schedule_ticks(delay_ticks, std::move(_callback), interval_ticks);
+	}
+
+	TimerHandle TimerSystem::schedule_ticks(u64      _delay_ticks,
+	                                        Callback _callback,
+	                                        u64      _interval_ticks)
+	{
+		const u32 index = allocate_node();
+
+		// 最低でも次のティックで実行する
+		const u64 delay_ticks = _delay_ticks > 0 ? _delay_ticks - 1 : 0;
+
+		TimerNode& node     = m_nodes[index];
+		node.expire_tick    = m_current_tick + delay_ticks;
+		node.interval_ticks = _interval_ticks;
+		node.state          = TimerState::Scheduled;
+		m_callbacks[index]  = std::move(_callback);
+
+		add_node(index);
+		m_active_timer_num++;
+
+		return {index, node.generation};
+	}
+
+	bool TimerSystem::cancel(TimerHandle _handle)
+	{
+		if ( !is_active(_handle) )
+		{
+			return false;
+		}
+
+		TimerNode& node = m_nodes[_handle.index];
+		if ( node.state == TimerState::Firing )
+		{
+			// 実行中は実行後に開放する
+			node.state = TimerState::Cancelled;
+		}
+		else
+		{
+			unlink_node(_handle.index);
+			free_node(_handle.index);
+		}
+		m_active_timer_num--;
+		return true;
+	}
+
+	bool TimerSystem::is_active(TimerHandle _handle) const noexcept
+	{
+		if ( _handle.index >= m_nodes.size() )
+		{
+			return false;
+		}
+
+		const TimerNode& node = m_nodes[_handle.index];
+		return node.generation == _handle.generation &&
+		       (node.state == TimerState::Scheduled ||
+		        node.state == TimerState::Firing);
+	}
+
+	void TimerSystem::tick(f32 _delta_seconds)
+	{
+		m_time_accumulator += _delta_seconds;
+
+		const auto ticks = static_cast<u64>(m_time_accumulator / m_tick_interval +
+		                                    TICK_EPSILON);
+		m_time_accumulator -= static_cast<f64>(ticks) * m_tick_interval;
+		m_time_accumulator = m_time_accumulator > 0.0 ? m_time_accumulator : 0.0;
+
+		advance_ticks(ticks);
+	}
+
+	void TimerSystem::advance_ticks(u64 _ticks)
+	{
+		for ( u64 i = 0; i < _ticks; ++i )
+		{
+			// タイマーが無ければホイールを回す必要は無い
+			if ( m_active_timer_num == 0 )
+			{
+				m_current_tick += _ticks - i;
+				break;
+			}
+			advance_tick();
+		}
+	}
+
+	void TimerSystem::advance_tick()
+	{
+		// 1段目が一周したら上の段のスロットを下の段に降ろす
+		const u32 root_index =
+		    static_cast<u32>(m_current_tick & (ROOT_WHEEL_SIZE - 1));
+		if ( root_index == 0 )
+		{
+			for ( u32 level = 1; level < WHEEL_LEVEL_NUM; ++level )
+			{
+				cascade(level);
+				const u64 index = (m_current_tick >> get_wheel_shift(level)) &
+				                  (WHEEL_SIZE - 1);
+				if ( index != 0 )
+				{
+					break;
+				}
+			}
+		}
+
+		// 期限切れのスロットをまとめて期限切れのリストに移す
+		u32& slot_head = m_list_heads[root_index];
+		if ( slot_head != TimerHandle::INVALID_INDEX )
+		{
+			for ( u32 index = slot_head; index != TimerHandle::INVALID_INDEX;
+			      index     = m_nodes[index].next )
+			{
+				m_nodes[index].list = EXPIRED_LIST;
+			}
+			m_list_heads[EXPIRED_LIST] = slot_head;
+			slot_head                  = TimerHandle::INVALID_INDEX;
+		}
+
+		const u64 fired_tick = m_current_tick;
+		m_current_tick++;
+
+		// 期限切れのリストを先頭から順に実行する
+		u32& expired_head = m_list_heads[EXPIRED_LIST];
+		while ( expired_head != TimerHandle::INVALID_INDEX )
+		{
+			const u32 index = expired_head;
+			unlink_node(index);
+
+			m_nodes[index].state = TimerState::Firing;
+
+			// コールバック内の登録で配列が再確保されても良い様に取り出して呼ぶ
+			Callback callback = std::move(m_callbacks[index]);
+			callback();
+
+			TimerNode& node = m_nodes[index];
+			if ( node.state == TimerState::Firing && node.interval_ticks > 0 )
+			{
+				node.state         = TimerState::Scheduled;
+				node.expire_tick   = fired_tick + node.interval_ticks;
+				m_callbacks[index] = std::move(callback);
+				add_node(index);
+			}
+			else
+			{
+				if ( node.state == TimerState::Firing )
+				{
+					m_active_timer_num--;
+				}
+				free_node(index);
+			}
+		}
+	}
+
+	void TimerSystem::cascade(u32 _level)
+	{
+		const u64 index =
+		    (m_current_tick >> get_wheel_shift(_level)) & (WHEEL_SIZE - 1);
+		const u32 list = get_wheel_offset(_level) + static_cast<u32>(index);
+
+		// リストを切り離して、現在のティックを基準に登録し直す
+		u32 node_index     = m_list_heads[list];
+		m_list_heads[list] = TimerHandle::INVALID_INDEX;
+		while ( node_index != TimerHandle::INVALID_INDEX )
+		{
+			const u32 next = m_nodes[node_index].next;
+			add_node(node_index);
+			node_index = next;
+		}
+	}
+
+	void TimerSystem::add_node(u32 _index)
+	{
+		const TimerNode& node = m_nodes[_index];
+
+		u64 expire = node.expire_tick;
+		if ( expire < m_current_tick )
+		{
+			expire = m_current_tick;
+		}
+
+		u64 delta = expire - m_current_tick;
+		if ( delta > MAX_WHEEL_TICKS )
+		{
+			// ホイールに収まらない場合は最上段に置いて、降りてきた時に登録し直す
+			delta  = MAX_WHEEL_TICKS;
+			expire = m_current_tick + delta;
+		}
+
+		u32 level = 0;
+		while ( level + 1 < WHEEL_LEVEL_NUM &&
+		        delta >= (u64(1) << get_wheel_shift(level + 1)) )
+		{
+			level++;
+		}
+
+		const u64 mask  = level == 0 ? ROOT_WHEEL_SIZE - 1 : WHEEL_SIZE - 1;
+		const u64 index = (expire >> get_wheel_shift(level)) & mask;
+		link_node(_index, get_wheel_offset(level) + static_cast<u32>(index));
+	}
+
+	void TimerSystem::link_node(u32 _index, u32 _list)
+	{
+		TimerNode& node = m_nodes[_index];
+		u32&       head = m_list_heads[_list];
+
+		node.list = _list;
+		node.prev = TimerHandle::INVALID_INDEX;
+		node.next = head;
+		if ( head != TimerHandle::INVALID_INDEX )
+		{
+			m_nodes[head].prev = _index;
+		}
+		head = _index;
+	}
+
+	void TimerSystem::unlink_node(u32 _index)
+	{
+		TimerNode& node = m_nodes[_index];
+
+		if ( node.prev != TimerHandle::INVALID_INDEX )
+		{
+			m_nodes[node.prev].next = node.next;
+		}
+		else
+		{
+			m_list_heads[node.list] = node.next;
+		}
+
+		if ( node.next != TimerHandle::INVALID_INDEX )
+		{
+			m_nodes[node.next].prev = node.prev;
+		}
+
+		node.prev = TimerHandle::INVALID_INDEX;
+		node.next = TimerHandle::INVALID_INDEX;
+		node.list = TimerHandle::INVALID_INDEX;
+	}
+
+	u32 TimerSystem::allocate_node()
+	{
+		if ( m_free_head != TimerHandle::INVALID_INDEX )
+		{
+			const u32 index = m_free_head;
+			m_free_head     = m_nodes[index].next;
+			return index;
+		}
+
+		m_nodes.emplace_back();
+		m_callbacks.emplace_back();
+		return static_cast<u32>(m_nodes.size() - 1);
+	}
+
+	void TimerSystem::free_node(u32 _index)
+	{
+		TimerNode& node = m_nodes[_index];
+		node.state      = TimerState::Free;
+		node.generation++;
+		node.next   = m_free_head;
+		m_free_head = _index;
+
+		m_callbacks[_index] = nullptr;
+	}
+
+} // namespace bavil
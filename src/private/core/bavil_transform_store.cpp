@@ -0,0 +1,435 @@
+#include "core/bavil_transform_store.h"
+#include "math/bavil_angle.h"
+#include "math/bavil_quaternion.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define BAVIL_TRANSFORM_STORE_SSE2 1
+#include <emmintrin.h>
+#else
+#define BAVIL_TRANSFORM_STORE_SSE2 0
+#endif
+
+namespace bavil
+{
+
+	namespace
+	{
+#if BAVIL_TRANSFORM_STORE_SSE2
+
+		/**
+		 * @brief 4つの角度(ラジアン)のsinとcosをまとめて計算する
+		 * π/2単位の象限で[-π/4, π/4]に縮めてから多項式で近似する
+		 */
+		void sincos_ps(__m128 _x, __m128& _sin, __m128& _cos) noexcept
+		{
+			// π/2を3つに分けて引くことで縮めた時の誤差を減らす
+			constexpr f32 PIDIV2_1 = 1.5703125f;
+			constexpr f32 PIDIV2_2 = 4.837512969970703125e-4f;
+			constexpr f32 PIDIV2_3 = 7.54978995489188216e-8f;
+
+			const __m128i quadrant =
+			    _mm_cvtps_epi32(_mm_mul_ps(_x, _mm_set1_ps(2.0f / math::PI<f32>)));
+			const __m128 q = _mm_cvtepi32_ps(quadrant);
+
+			__m128 r = _mm_sub_ps(_x, _mm_mul_ps(q, _mm_set1_ps(PIDIV2_1)));
+			r        = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PIDIV2_2)));
+			r        = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PIDIV2_3)));
+
+			const __m128 z = _mm_mul_ps(r, r);
+
+			__m128 sin_r = _mm_set1_ps(-1.9515295891e-4f);
+			sin_r = _mm_add_ps(_mm_mul_ps(sin_r, z), _mm_set1_ps(8.3321608736e-3f));
+			sin_r = _mm_add_ps(_mm_mul_ps(sin_r, z), _mm_set1_ps(-1.6666654611e-1f));
+			sin_r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sin_r, z), r), r);
+
+			__m128 cos_r = _mm_set1_ps(2.443315711809948e-5f);
+			cos_r = _mm_add_ps(_mm_mul_ps(cos_r, z), _mm_set1_ps(-1.3887316255e-3f));
+			cos_r = _mm_add_ps(_mm_mul_ps(cos_r, z), _mm_set1_ps(4.1666645683e-2f));
+			cos_r = _mm_mul_ps(_mm_mul_ps(cos_r, z), z);
+			cos_r = _mm_add_ps(cos_r, _mm_mul_ps(z, _mm_set1_ps(-0.5f)));
+			cos_r = _mm_add_ps(cos_r, _mm_set1_ps(1.0f));
+
+			// 奇数の象限はsinとcosを入れ替える
+			const __m128i one  = _mm_set1_epi32(1);
+			const __m128i odd  = _mm_and_si128(quadrant, one);
+			const __m128  swap = _mm_castsi128_ps(_mm_cmpeq_epi32(odd, one));
+			const __m128 s =
+			    _mm_or_ps(_mm_and_ps(swap, cos_r), _mm_andnot_ps(swap, sin_r));
+			const __m128 c =
+			    _mm_or_ps(_mm_and_ps(swap, sin_r), _mm_andnot_ps(swap, cos_r));
+
+			// 象限の2ビット目を符号ビットに移して反転する
+			const __m128i two          = _mm_set1_epi32(2);
+			const __m128i sin_quadrant = _mm_and_si128(quadrant, two);
+			const __m128i cos_quadrant =
+			    _mm_and_si128(_mm_add_epi32(quadrant, one), two);
+			const __m128 sin_sign =
+			    _mm_castsi128_ps(_mm_slli_epi32(sin_quadrant, 30));
+			const __m128 cos_sign =
+			    _mm_castsi128_ps(_mm_slli_epi32(cos_quadrant, 30));
+
+			_sin = _mm_xor_ps(s, sin_sign);
+			_cos = _mm_xor_ps(c, cos_sign);
+		}
+
+		/**
+		 * @brief 4つの角度(度)の半分のsinとcosを計算する
+		 * ToQuaternion() と同じく360度で割った余りを使う
+		 */
+		void half_angle_sincos(const f32* _degrees,
+		                       __m128&    _sin,
+		                       __m128&    _cos) noexcept
+		{
+			const __m128 degrees = _mm_loadu_ps(_degrees);
+			const __m128 winding = _mm_cvtepi32_ps(
+			    _mm_cvttps_epi32(_mm_mul_ps(degrees, _mm_set1_ps(1.0f / 360.0f))));
+			const __m128 no_winding =
+			    _mm_sub_ps(degrees, _mm_mul_ps(winding, _mm_set1_ps(360.0f)));
+			const __m128 half_radians =
+			    _mm_mul_ps(no_winding, _mm_set1_ps(math::DEG_TO_RAD<f32> * 0.5f));
+			sincos_ps(half_radians, _sin, _cos);
+		}
+
+#endif
+	} // namespace
+
+	TransformStore::TransformStore(std::pmr::memory_resource* _resource)
+	    : m_positions(_resource)
+	    , m_rotations(_resource)
+	    , m_scales(_resource)
+	    , m_previous_positions(_resource)
+	    , m_previous_rotations(_resource)
+	    , m_previous_scales(_resource)
+	    , m_previous_flags(_resource)
+	    , m_matrices(_resource)
+	    , m_dirty_flags(_resource)
+	    , m_changed_flags(_resource)
+	    , m_owners(_resource)
+	{
+	}
+
+	void TransformStore::add(Transform& _transform)
+	{
+		if ( _transform.is_valid() )
+		{
+			return;
+		}
+
+		// 登録されていない間に設定した値を引き継ぐ
+		const bavil::math::Vector3& position = _transform.m_position;
+		const bavil::math::Rotator& rotation = _transform.m_rotation;
+		const bavil::math::Vector3& scale    = _transform.m_scale;
+		m_positions.push_back(position.x, position.y, position.z);
+		m_rotations.push_back(rotation.pitch, rotation.yaw, rotation.roll);
+		m_scales.push_back(scale.x, scale.y, scale.z);
+		m_previous_positions.push_back(position.x, position.y, position.z);
+		m_previous_rotations.push_back(rotation.pitch, rotation.yaw, rotation.roll);
+		m_previous_scales.push_back(scale.x, scale.y, scale.z);
+		m_previous_flags.push_back(0);
+		m_matrices.push_back(_transform.m_matrix);
+		m_dirty_flags.push_back(_transform.m_is_dirty ? 1 : 0);
+		// 追加した位置をワールド行列や索引に反映させる
+		m_changed_flags.push_back(1);
+		m_owners.push_back(&_transform);
+
+		_transform.m_store = this;
+		_transform.m_index = m_owners.size() - 1;
+	}
+
+	void TransformStore::remove(Transform& _transform)
+	{
+		if ( _transform.m_store != this )
+		{
+			return;
+		}
+
+		// 末尾の要素を削除する要素の位置に移す
+		const size_t index = _transform.m_index;
+		detach(index);
+		m_positions.swap_remove(index);
+		m_rotations.swap_remove(index);
+		m_scales.swap_remove(index);
+		m_previous_positions.swap_remove(index);
+		m_previous_rotations.swap_remove(index);
+		m_previous_scales.swap_remove(index);
+		m_previous_flags[index]  = m_previous_flags.back();
+		m_matrices[index]        = m_matrices.back();
+		m_dirty_flags[index]     = m_dirty_flags.back();
+		m_changed_flags[index]   = m_changed_flags.back();
+		m_owners[index]          = m_owners.back();
+		m_owners[index]->m_index = index;
+		m_previous_flags.pop_back();
+		m_matrices.pop_back();
+		m_dirty_flags.pop_back();
+		m_changed_flags.pop_back();
+		m_owners.pop_back();
+
+		_transform.m_store = nullptr;
+		_transform.m_index = 0;
+	}
+
+	void TransformStore::clear() noexcept
+	{
+		for ( size_t i = 0; i < m_owners.size(); ++i )
+		{
+			detach(i);
+			m_owners[i]->m_store = nullptr;
+			m_owners[i]->m_index = 0;
+		}
+		m_positions.clear();
+		m_rotations.clear();
+		m_scales.clear();
+		m_previous_positions.clear();
+		m_previous_rotations.clear();
+		m_previous_scales.clear();
+		m_previous_flags.clear();
+		m_matrices.clear();
+		m_dirty_flags.clear();
+		m_changed_flags.clear();
+		m_owners.clear();
+	}
+
+	void TransformStore::update_matrices() noexcept
+	{
+		const size_t num   = m_owners.size();
+		size_t       index = 0;
+#if BAVIL_TRANSFORM_STORE_SSE2
+		for ( ; index + SIMD_WIDTH <= num; index += SIMD_WIDTH )
+		{
+			const u8* flags = &m_dirty_flags[index];
+			if ( (flags[0] | flags[1] | flags[2] | flags[3]) != 0 )
+			{
+				update_matrices_simd(index);
+			}
+		}
+#endif
+		// SIMD_WIDTHに満たない残りは1つずつ作り直す
+		for ( ; index < num; ++index )
+		{
+			if ( m_dirty_flags[index] != 0 )
+			{
+				update_matrix(index);
+			}
+		}
+	}
+
+	void TransformStore::clear_changed() noexcept
+	{
+		std::fill(m_changed_flags.begin(), m_changed_flags.end(), u8(0));
+	}
+
+	void TransformStore::save_previous()
+	{
+		m_previous_positions.x = m_positions.x;
+		m_previous_positions.y = m_positions.y;
+		m_previous_positions.z = m_positions.z;
+		m_previous_rotations.x = m_rotations.x;
+		m_previous_rotations.y = m_rotations.y;
+		m_previous_rotations.z = m_rotations.z;
+		m_previous_scales.x    = m_scales.x;
+		m_previous_scales.y    = m_scales.y;
+		m_previous_scales.z    = m_scales.z;
+		m_previous_flags.assign(m_owners.size(), 1);
+	}
+
+	bavil::math::Matrix44 TransformStore::get_interpolated_matrix(
+	    size_t _index,
+	    f32    _alpha) const noexcept
+	{
+		using Vector3    = bavil::math::Vector3;
+		using Rotator    = bavil::math::Rotator;
+		using Quaternion = bavil::math::Quaternion;
+		using Matrix44   = bavil::math::Matrix44;
+
+		const Vector3 position = {
+		    m_positions.x[_index], m_positions.y[_index], m_positions.z[_index]};
+		const Rotator rotation = {
+		    m_rotations.x[_index], m_rotations.y[_index], m_rotations.z[_index]};
+		const Vector3 scale = {
+		    m_scales.x[_index], m_scales.y[_index], m_scales.z[_index]};
+
+		const bool has_previous = m_previous_flags[_index] != 0;
+		const bool is_position_changed =
+		    has_previous && (m_previous_positions.x[_index] != position.x ||
+		                     m_previous_positions.y[_index] != position.y ||
+		                     m_previous_positions.z[_index] != position.z);
+		const bool is_rotation_changed =
+		    has_previous && (m_previous_rotations.x[_index] != rotation.pitch ||
+		                     m_previous_rotations.y[_index] != rotation.yaw ||
+		                     m_previous_rotations.z[_index] != rotation.roll);
+		const bool is_scale_changed =
+		    has_previous && (m_previous_scales.x[_index] != scale.x ||
+		                     m_previous_scales.y[_index] != scale.y ||
+		                     m_previous_scales.z[_index] != scale.z);
+
+		// 変わっていない場合は作り直し済みの行列を使う
+		if ( !is_position_changed && !is_rotation_changed && !is_scale_changed &&
+		     m_dirty_flags[_index] == 0 )
+		{
+			return m_matrices[_index];
+		}
+
+		Quaternion quaternion = bavil::math::ToQuaternion(rotation);
+		if ( is_rotation_changed )
+		{
+			const Quaternion previous = bavil::math::ToQuaternion(
+			    Rotator(m_previous_rotations.x[_index],
+			            m_previous_rotations.y[_index],
+			            m_previous_rotations.z[_index]));
+			quaternion = Quaternion::Slerp(previous, quaternion, _alpha);
+		}
+
+		Matrix44 matrix;
+		if ( is_scale_changed )
+		{
+			const Vector3 previous = {m_previous_scales.x[_index],
+			                          m_previous_scales.y[_index],
+			                          m_previous_scales.z[_index]};
+			matrix = Matrix44::Scaling(Vector3::Lerp(previous, scale, _alpha));
+		}
+		else
+		{
+			matrix = Matrix44::Scaling(scale);
+		}
+		matrix *= Matrix44(quaternion);
+		if ( is_position_changed )
+		{
+			const Vector3 previous = {m_previous_positions.x[_index],
+			                          m_previous_positions.y[_index],
+			                          m_previous_positions.z[_index]};
+			matrix *= Matrix44::Translate(Vector3::Lerp(previous, position, _alpha));
+		}
+		else
+		{
+			matrix *= Matrix44::Translate(position);
+		}
+		return matrix;
+	}
+
+	bavil::math::Matrix44 TransformStore::MakeMatrix(
+	    const bavil::math::Vector3& _position,
+	    const bavil::math::Rotator& _rotation,
+	    const bavil::math::Vector3& _scale) noexcept
+	{
+		bavil::math::Matrix44 matrix = bavil::math::Matrix44::Scaling(_scale);
+		matrix *= bavil::math::Matrix44(bavil::math::ToQuaternion(_rotation));
+		matrix *= bavil::math::Matrix44::Translate(_position);
+		return matrix;
+	}
+
+	void TransformStore::update_matrix(size_t _index) noexcept
+	{
+		const bavil::math::Vector3 position = {
+		    m_positions.x[_index], m_positions.y[_index], m_positions.z[_index]};
+		const bavil::math::Rotator rotation = {
+		    m_rotations.x[_index], m_rotations.y[_index], m_rotations.z[_index]};
+		const bavil::math::Vector3 scale = {
+		    m_scales.x[_index], m_scales.y[_index], m_scales.z[_index]};
+
+		m_matrices[_index]    = MakeMatrix(position, rotation, scale);
+		m_dirty_flags[_index] = 0;
+	}
+
+	void TransformStore::detach(size_t _index) noexcept
+	{
+		Transform& transform = *m_owners[_index];
+		transform.m_position = {
+		    m_positions.x[_index], m_positions.y[_index], m_positions.z[_index]};
+		transform.m_rotation = {
+		    m_rotations.x[_index], m_rotations.y[_index], m_rotations.z[_index]};
+		transform.m_scale = {
+		    m_scales.x[_index], m_scales.y[_index], m_scales.z[_index]};
+		transform.m_matrix   = m_matrices[_index];
+		transform.m_is_dirty = m_dirty_flags[_index] != 0;
+	}
+
+	void TransformStore::update_matrices_simd(
+	    [[maybe_unused]] size_t _begin) noexcept
+	{
+#if BAVIL_TRANSFORM_STORE_SSE2
+		// 回転をクォータニオンにする(ToQuaternion()と同じ計算)
+		__m128 sp, cp, sy, cy, sr, cr;
+		half_angle_sincos(&m_rotations.x[_begin], sp, cp);
+		half_angle_sincos(&m_rotations.y[_begin], sy, cy);
+		half_angle_sincos(&m_rotations.z[_begin], sr, cr);
+
+		const __m128 cr_sp = _mm_mul_ps(cr, sp);
+		const __m128 cr_cp = _mm_mul_ps(cr, cp);
+		const __m128 sr_sp = _mm_mul_ps(sr, sp);
+		const __m128 sr_cp = _mm_mul_ps(sr, cp);
+
+		const __m128 qx = _mm_sub_ps(_mm_mul_ps(cr_sp, sy), _mm_mul_ps(sr_cp, cy));
+		const __m128 qy = _mm_sub_ps(
+		    _mm_setzero_ps(),
+		    _mm_add_ps(_mm_mul_ps(cr_sp, cy), _mm_mul_ps(sr_cp, sy)));
+		const __m128 qz = _mm_sub_ps(_mm_mul_ps(cr_cp, sy), _mm_mul_ps(sr_sp, cy));
+		const __m128 qw = _mm_add_ps(_mm_mul_ps(cr_cp, cy), _mm_mul_ps(sr_sp, sy));
+
+		// クォータニオンから回転行列を作る(Matrix44(Quaternion)と同じ計算)
+		const __m128 qx2 = _mm_add_ps(qx, qx);
+		const __m128 qy2 = _mm_add_ps(qy, qy);
+		const __m128 qz2 = _mm_add_ps(qz, qz);
+		const __m128 xx  = _mm_mul_ps(qx, qx2);
+		const __m128 yy  = _mm_mul_ps(qy, qy2);
+		const __m128 zz  = _mm_mul_ps(qz, qz2);
+		const __m128 xy  = _mm_mul_ps(qx, qy2);
+		const __m128 xz  = _mm_mul_ps(qx, qz2);
+		const __m128 yz  = _mm_mul_ps(qy, qz2);
+		const __m128 wx  = _mm_mul_ps(qw, qx2);
+		const __m128 wy  = _mm_mul_ps(qw, qy2);
+		const __m128 wz  = _mm_mul_ps(qw, qz2);
+
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		// スケール、回転、平行移動の順に掛けた行列の各行
+		// スケールは回転行列の行に、平行移動は4行目にそのまま入る
+		const __m128 scale_x = _mm_loadu_ps(&m_scales.x[_begin]);
+		const __m128 scale_y = _mm_loadu_ps(&m_scales.y[_begin]);
+		const __m128 scale_z = _mm_loadu_ps(&m_scales.z[_begin]);
+
+		__m128 rows[4][4] = {
+		    {_mm_mul_ps(scale_x, _mm_sub_ps(one, _mm_add_ps(yy, zz))),
+		     _mm_mul_ps(scale_x, _mm_add_ps(xy, wz)),
+		     _mm_mul_ps(scale_x, _mm_sub_ps(xz, wy)),
+		     _mm_setzero_ps()},
+		    {_mm_mul_ps(scale_y, _mm_sub_ps(xy, wz)),
+		     _mm_mul_ps(scale_y, _mm_sub_ps(one, _mm_add_ps(xx, zz))),
+		     _mm_mul_ps(scale_y, _mm_add_ps(yz, wx)),
+		     _mm_setzero_ps()},
+		    {_mm_mul_ps(scale_z, _mm_add_ps(xz, wy)),
+		     _mm_mul_ps(scale_z, _mm_sub_ps(yz, wx)),
+		     _mm_mul_ps(scale_z, _mm_sub_ps(one, _mm_add_ps(xx, yy))),
+		     _mm_setzero_ps()},
+		    {_mm_loadu_ps(&m_positions.x[_begin]),
+		     _mm_loadu_ps(&m_positions.y[_begin]),
+		     _mm_loadu_ps(&m_positions.z[_begin]),
+		     one},
+		};
+
+		// 成分毎に並んでいるので転置して行列毎の行にする
+		for ( auto& row : rows )
+		{
+			_MM_TRANSPOSE4_PS(row[0], row[1], row[2], row[3]);
+		}
+
+		// 変更されていない行列は書き換えない
+		for ( size_t lane = 0; lane < SIMD_WIDTH; ++lane )
+		{
+			const size_t index = _begin + lane;
+			if ( m_dirty_flags[index] == 0 )
+			{
+				continue;
+			}
+			bavil::math::Matrix44& matrix = m_matrices[index];
+			for ( size_t row = 0; row < 4; ++row )
+			{
+				_mm_storeu_ps(matrix.m[row], rows[row][lane]);
+			}
+			m_dirty_flags[index] = 0;
+		}
+#endif
+	}
+
+} // namespace bavil
@@ -1,18 +1,742 @@
 #include "core/bavil_world_system.h"
 #include "core/bavil_object_system.h"
+#include "core/bavil_task_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
 
 namespace bavil
 {
 
+	WorldSystem::WorldSystem(bavil::core::SystemAllocator& _allocator)
+	    : m_actors(&_allocator)
+	    , m_transform_store(&_allocator)
+	    , m_hierarchy(&_allocator)
+	    , m_world_matrices(&_allocator)
+	    , m_updated_flags(&_allocator)
+	    , m_tick_actors(&_allocator)
+	    , m_parallel_tick_actors(&_allocator)
+	    , m_bounds_tree(&_allocator)
+	    , m_moved_bounds_actors(&_allocator)
+	    , m_interpolated_matrices(&_allocator)
+	{
+	}
+
 	void WorldSystem::initialize(bavil::core::SystemManager& _system_manager)
 	{
 		// オブジェクトシステムに依存している
 		_system_manager.get_system<bavil::ObjectSystem>();
 	}
 
-	void WorldSystem::finalize() {}
+	void WorldSystem::finalize()
+	{
+		for ( bavil::Actor* actor : m_actors )
+		{
+			actor->m_world_index     = Actor::INVALID_WORLD_INDEX;
+			actor->m_hierarchy_index = Actor::INVALID_WORLD_INDEX;
+			actor->m_parent          = nullptr;
+			actor->m_tick_index      = Actor::INVALID_WORLD_INDEX;
+			actor->m_spatial_id      = SpatialIndex::INVALID_ID;
+			actor->m_bounds_id       = AABBTree::INVALID_ID;
+		}
+		m_actors.clear();
+		m_transform_store.clear();
+		m_hierarchy.clear();
+		m_world_matrices.clear();
+		m_updated_flags.clear();
+		m_tick_actors.clear();
+		m_parallel_tick_actors.clear();
+		m_removed_tick_actor_num = 0;
+		m_spatial_index.reset();
+		m_bounds_tree.clear();
+		m_moved_bounds_actors.clear();
+		m_fixed_step_accumulator = 0.0f;
+		m_interpolation_alpha    = 1.0f;
+		m_interpolated_matrices.clear();
+	}
+
+	void WorldSystem::add_actor(bavil::Actor* _actor)
+	{
+		if ( _actor == nullptr || _actor->is_in_world() )
+		{
+			return;
+		}
+
+		_actor->m_world_index = m_actors.size();
+		m_actors.push_back(_actor);
+		m_transform_store.add(_actor->m_transform);
+		register_tick(_actor);
+		if ( m_spatial_index != nullptr )
+		{
+			_actor->m_spatial_id =
+			    m_spatial_index->insert(_actor, get_world_position(*_actor));
+		}
+		update_bounds(*_actor);
+	}
+
+	void WorldSystem::remove_actor(bavil::Actor* _actor)
+	{
+		if ( _actor == nullptr || !_actor->is_in_world() )
+		{
+			return;
+		}
+
+		// 他のワールドに登録されているアクターは削除しない
+		const size_t index = _actor->m_world_index;
+		if ( m_actors.size() <= index || m_actors[index] != _actor )
+		{
+			return;
+		}
+
+		// 子はルートとして残し、親から取り外す
+		// 最後の子を取り外した時点でルートは階層から取り除かれる
+		while ( _actor->m_hierarchy_index != Actor::INVALID_WORLD_INDEX &&
+		        m_hierarchy[_actor->m_hierarchy_index].descendant_num > 0 )
+		{
+			// 最初の子は直後に並んでいる
+			detach_actor(m_hierarchy[_actor->m_hierarchy_index + 1].actor);
+		}
+		detach_actor(_actor);
+		unregister_tick(_actor);
+		if ( m_spatial_index != nullptr )
+		{
+			m_spatial_index->remove(_actor->m_spatial_id);
+			_actor->m_spatial_id = SpatialIndex::INVALID_ID;
+		}
+		unregister_bounds(*_actor);
+
+		// 末尾のアクターを削除するアクターの位置に移す
+		bavil::Actor* last  = m_actors.back();
+		m_actors[index]     = last;
+		last->m_world_index = index;
+		m_actors.pop_back();
+		m_transform_store.remove(_actor->m_transform);
+
+		_actor->m_world_index = Actor::INVALID_WORLD_INDEX;
+	}
+
+	bool WorldSystem::attach_actor(bavil::Actor* _child, bavil::Actor* _parent)
+	{
+		if ( _child == nullptr || _parent == nullptr || !_child->is_in_world() ||
+		     !_parent->is_in_world() )
+		{
+			return false;
+		}
+
+		// 親が子孫の場合は循環するので取り付けない
+		for ( const bavil::Actor* actor = _parent; actor != nullptr;
+		      actor                     = actor->m_parent )
+		{
+			if ( actor == _child )
+			{
+				return false;
+			}
+		}
+		if ( _child->m_parent == _parent )
+		{
+			return true;
+		}
+
+		bavil::Actor* old_parent = _child->m_parent;
+
+		auto subtree     = extract_subtree(_child);
+		_child->m_parent = _parent;
+		if ( old_parent != nullptr )
+		{
+			prune_hierarchy_root(old_parent);
+		}
+
+		// 親が階層に無い場合はルートとして追加する
+		if ( _parent->m_hierarchy_index == Actor::INVALID_WORLD_INDEX )
+		{
+			_parent->m_hierarchy_index = m_hierarchy.size();
+			m_hierarchy.push_back({_parent});
+			m_world_matrices.emplace_back();
+		}
+
+		// 親の子孫の末尾に挿入する
+		u32          index    = static_cast<u32>(_parent->m_hierarchy_index);
+		const size_t position = index + 1 + m_hierarchy[index].descendant_num;
+		for ( ; index != INVALID_HIERARCHY_INDEX; index = m_hierarchy[index].parent )
+		{
+			m_hierarchy[index].descendant_num += static_cast<u32>(subtree.size());
+		}
+		insert_subtree(position, subtree);
+
+		return true;
+	}
+
+	void WorldSystem::detach_actor(bavil::Actor* _child)
+	{
+		if ( _child == nullptr || _child->m_parent == nullptr )
+		{
+			return;
+		}
+
+		bavil::Actor* old_parent = _child->m_parent;
+
+		auto subtree     = extract_subtree(_child);
+		_child->m_parent = nullptr;
+		prune_hierarchy_root(old_parent);
+
+		// 子が居る場合はルートとして階層に残す
+		if ( subtree.size() > 1 )
+		{
+			insert_subtree(m_hierarchy.size(), subtree);
+		}
+		else
+		{
+			// 階層から外れたので自身の位置をそのまま索引に反映する
+			_child->m_hierarchy_index = Actor::INVALID_WORLD_INDEX;
+			update_spatial_index(*_child);
+			update_bounds(*_child);
+		}
+	}
+
+	const bavil::math::Matrix44& WorldSystem::get_world_matrix(
+	    const bavil::Actor& _actor) const noexcept
+	{
+		if ( _actor.m_hierarchy_index < m_world_matrices.size() &&
+		     m_hierarchy[_actor.m_hierarchy_index].actor == &_actor )
+		{
+			return m_world_matrices[_actor.m_hierarchy_index];
+		}
+		return _actor.get_transform().get_matrix();
+	}
+
+	bavil::math::Vector3 WorldSystem::get_world_position(
+	    const bavil::Actor& _actor) const noexcept
+	{
+		if ( _actor.m_hierarchy_index < m_world_matrices.size() &&
+		     m_hierarchy[_actor.m_hierarchy_index].actor == &_actor )
+		{
+			const bavil::math::Matrix44& matrix =
+			    m_world_matrices[_actor.m_hierarchy_index];
+			return {matrix._41, matrix._42, matrix._43};
+		}
+		return _actor.get_transform().get_position();
+	}
+
+	bavil::math::AABB WorldSystem::get_world_bounds(
+	    const bavil::Actor& _actor) const noexcept
+	{
+		if ( !_actor.has_local_bounds() )
+		{
+			const bavil::math::Vector3 position = get_world_position(_actor);
+			return {position, position};
+		}
+		return bavil::math::AABB::Transform(_actor.get_local_bounds(),
+		                                    get_world_matrix(_actor));
+	}
+
+	void WorldSystem::raycast(std::span<const bavil::math::Ray> _rays,
+	                          std::span<bavil::RaycastHit>      _hits) const
+	{
+		const size_t ray_num = std::min(_rays.size(), _hits.size());
+
+		// 木は判定中に変更されないので、半直線を分けて並列に判定できる
+		bavil::core::SystemManager* context =
+		    bavil::core::SystemManager::GetCurrent();
+		if ( context == nullptr || ray_num <= PARALLEL_RAYCAST_CHUNK_SIZE )
+		{
+			m_bounds_tree.raycast(_rays.first(ray_num), _hits.first(ray_num));
+			return;
+		}
+
+		// 半直線をまとめて判定する単位で分ける
+		constexpr size_t PACKET_SIZE = AABBTree::RAY_PACKET_SIZE;
+		const size_t     packet_num  = (ray_num + PACKET_SIZE - 1) / PACKET_SIZE;
+		TaskSystem::Get(*context).parallel_for(
+		    packet_num,
+		    PARALLEL_RAYCAST_CHUNK_SIZE / PACKET_SIZE,
+		    [&](size_t _begin, size_t _end)
+		    {
+			    const size_t begin = _begin * PACKET_SIZE;
+			    const size_t num   = std::min(_end * PACKET_SIZE, ray_num) - begin;
+			    m_bounds_tree.raycast(_rays.subspan(begin, num),
+			                          _hits.subspan(begin, num));
+		    });
+	}
+
+	bavil::RaycastHit WorldSystem::raycast(const bavil::math::Ray& _ray) const
+	{
+		bavil::RaycastHit hit;
+		m_bounds_tree.raycast({&_ray, 1}, {&hit, 1});
+		return hit;
+	}
+
+	void WorldSystem::set_spatial_index(const bavil::SpatialIndexSettings& _settings)
+	{
+		// 設定が不正な場合は例外を投げるので、生成できてから置き換える
+		auto spatial_index = bavil::SpatialIndex::Create(
+		    _settings, m_actors.get_allocator().resource());
+		m_spatial_index_settings = _settings;
+		m_spatial_index          = std::move(spatial_index);
+
+		for ( bavil::Actor* actor : m_actors )
+		{
+			actor->m_spatial_id = SpatialIndex::INVALID_ID;
+			if ( m_spatial_index != nullptr )
+			{
+				actor->m_spatial_id =
+				    m_spatial_index->insert(actor, get_world_position(*actor));
+			}
+		}
+	}
+
+	size_t WorldSystem::find_nearest_actors(const bavil::math::Vector3& _position,
+	                                        std::span<bavil::Actor*> _result) const
+	{
+		const size_t result_num = std::min(_result.size(), m_actors.size());
+		if ( result_num == 0 )
+		{
+			return 0;
+		}
+
+		// 半径内で見つかったアクターより近いアクターは半径の外に存在しないので、
+		// 必要な数が見つかるまで半径を広げる
+		std::pmr::vector<std::pair<f32, bavil::Actor*>> candidates(
+		    m_actors.get_allocator());
+		f32 radius = m_spatial_index != nullptr
+		                 ? m_spatial_index_settings.cell_size
+		                 : std::numeric_limits<f32>::infinity();
+		while ( true )
+		{
+			candidates.clear();
+			const f32 radius_sqr = radius * radius;
+			query_aabb(
+			    bavil::math::AABB::FromSphere(_position, radius),
+			    [&](bavil::Actor& _actor, const bavil::math::Vector3& _point)
+			    {
+				    using Vector3 = bavil::math::Vector3;
+				    const f32 distance_sqr = Vector3::DistanceSqr(_position, _point);
+				    if ( distance_sqr <= radius_sqr )
+				    {
+					    candidates.emplace_back(distance_sqr, &_actor);
+				    }
+			    });
+			if ( candidates.size() >= result_num || std::isinf(radius) )
+			{
+				break;
+			}
+			radius *= 2.0f;
+		}
+
+		const size_t found_num = std::min(result_num, candidates.size());
+		std::partial_sort(candidates.begin(),
+		                  candidates.begin() + found_num,
+		                  candidates.end(),
+		                  [](const auto& _a, const auto& _b)
+		                  {
+			                  return _a.first < _b.first;
+		                  });
+		for ( size_t i = 0; i < found_num; ++i )
+		{
+			_result[i] = candidates[i].second;
+		}
+		return found_num;
+	}
+
+	void WorldSystem::update_transforms()
+	{
+		// 行列の作り直しの印は get_matrix() でも消えるので、前回の更新からの変更の印を
+		// 階層の要素毎に記録しておく
+		const size_t node_num = m_hierarchy.size();
+		m_updated_flags.resize(node_num);
+		for ( size_t i = 0; i < node_num; ++i )
+		{
+			const HierarchyNode&    node      = m_hierarchy[i];
+			const bavil::Transform& transform = node.actor->get_transform();
+			m_updated_flags[i] = node.is_dirty || transform.is_changed();
+		}
+
+		// 親子関係を持たないアクターは位置をそのまま索引に反映する
+		// 境界ボックスは行列が必要なので、作り直した後に反映する
+		// トランスフォームの配列はアクターの配列と同じ順に並んでいる
+		if ( m_spatial_index != nullptr || m_bounds_tree.size() > 0 )
+		{
+			m_transform_store.for_each_changed(
+			    [&](size_t _index)
+			    {
+				    bavil::Actor* actor = m_actors[_index];
+				    if ( actor->m_hierarchy_index != Actor::INVALID_WORLD_INDEX )
+				    {
+					    return;
+				    }
+				    if ( m_spatial_index != nullptr )
+				    {
+					    const bavil::Transform& transform = actor->get_transform();
+					    m_spatial_index->update(actor->m_spatial_id,
+					                            transform.get_position());
+				    }
+				    if ( actor->m_bounds_id != AABBTree::INVALID_ID )
+				    {
+					    m_moved_bounds_actors.push_back(actor);
+				    }
+			    });
+		}
+
+		m_transform_store.update_matrices();
+
+		for ( bavil::Actor* actor : m_moved_bounds_actors )
+		{
+			update_bounds(*actor);
+		}
+		m_moved_bounds_actors.clear();
+
+		// 親は子より前に並んでいるので、親の計算結果を使って子を計算できる
+		for ( size_t i = 0; i < node_num; ++i )
+		{
+			HierarchyNode&          node      = m_hierarchy[i];
+			const bavil::Transform& transform = node.actor->get_transform();
+
+			const bool is_parent_updated = node.parent != INVALID_HIERARCHY_INDEX &&
+			                               m_updated_flags[node.parent];
+			const bool is_updated = m_updated_flags[i] || is_parent_updated;
+
+			m_updated_flags[i] = is_updated;
+			if ( !is_updated )
+			{
+				continue;
+			}
+
+			if ( node.parent != INVALID_HIERARCHY_INDEX )
+			{
+				m_world_matrices[i] =
+				    transform.get_matrix() * m_world_matrices[node.parent];
+			}
+			else
+			{
+				m_world_matrices[i] = transform.get_matrix();
+			}
+			node.is_dirty = false;
+			update_spatial_index(*node.actor);
+			update_bounds(*node.actor);
+		}
+
+		m_transform_store.clear_changed();
+	}
+
+	void WorldSystem::tick(f32 _delta_seconds)
+	{
+		if ( m_is_ticking )
+		{
+			return;
+		}
+		m_is_ticking = true;
+
+		// 呼び出し中に追加されたアクターは呼ばない
+		const size_t                parallel_num = m_parallel_tick_actors.size();
+		bavil::core::SystemManager* context =
+		    bavil::core::SystemManager::GetCurrent();
+		if ( context != nullptr && parallel_num > PARALLEL_TICK_CHUNK_SIZE )
+		{
+			TaskSystem::Get(*context).parallel_for(
+			    parallel_num,
+			    PARALLEL_TICK_CHUNK_SIZE,
+			    [&](size_t _begin, size_t _end)
+			    {
+				    for ( size_t i = _begin; i < _end; ++i )
+				    {
+					    if ( bavil::Actor* actor = m_parallel_tick_actors[i] )
+					    {
+						    actor->tick(_delta_seconds);
+					    }
+				    }
+			    });
+		}
+		else
+		{
+			for ( size_t i = 0; i < parallel_num; ++i )
+			{
+				if ( bavil::Actor* actor = m_parallel_tick_actors[i] )
+				{
+					actor->tick(_delta_seconds);
+				}
+			}
+		}
+
+		// 順に呼び出すアクターは他のアクターの登録、削除を行う事がある
+		const size_t serial_num = m_tick_actors.size();
+		for ( size_t i = 0; i < serial_num; ++i )
+		{
+			if ( bavil::Actor* actor = m_tick_actors[i] )
+			{
+				actor->tick(_delta_seconds);
+			}
+		}
+
+		m_is_ticking = false;
+		if ( m_removed_tick_actor_num > 0 )
+		{
+			compact_tick_actors(m_tick_actors);
+			compact_tick_actors(m_parallel_tick_actors);
+			m_removed_tick_actor_num = 0;
+		}
+	}
+
+	void WorldSystem::register_tick(bavil::Actor* _actor)
+	{
+		if ( !_actor->is_tick_enabled() ||
+		     _actor->m_tick_index != Actor::INVALID_WORLD_INDEX )
+		{
+			return;
+		}
+
+		auto& actors         = get_tick_actors(*_actor);
+		_actor->m_tick_index = actors.size();
+		actors.push_back(_actor);
+	}
+
+	void WorldSystem::unregister_tick(bavil::Actor* _actor)
+	{
+		const size_t index = _actor->m_tick_index;
+		if ( index == Actor::INVALID_WORLD_INDEX )
+		{
+			return;
+		}
+
+		auto& actors = get_tick_actors(*_actor);
+
+		// 呼び出し中は位置を変えずに空きにしておき、終わってから詰める
+		if ( m_is_ticking )
+		{
+			actors[index] = nullptr;
+			++m_removed_tick_actor_num;
+		}
+		else
+		{
+			bavil::Actor* last = actors.back();
+			actors[index]      = last;
+			last->m_tick_index = index;
+			actors.pop_back();
+		}
+		_actor->m_tick_index = Actor::INVALID_WORLD_INDEX;
+	}
+
+	void WorldSystem::compact_tick_actors(std::pmr::vector<bavil::Actor*>& _actors)
+	{
+		std::erase(_actors, nullptr);
+		for ( size_t i = 0; i < _actors.size(); ++i )
+		{
+			_actors[i]->m_tick_index = i;
+		}
+	}
+
+	void WorldSystem::update_bounds(bavil::Actor& _actor)
+	{
+		if ( !_actor.has_local_bounds() )
+		{
+			return;
+		}
+
+		const bavil::math::AABB bounds = get_world_bounds(_actor);
+		if ( _actor.m_bounds_id == AABBTree::INVALID_ID )
+		{
+			_actor.m_bounds_id = m_bounds_tree.insert(&_actor, bounds);
+		}
+		else
+		{
+			m_bounds_tree.update(_actor.m_bounds_id, bounds);
+		}
+	}
+
+	void WorldSystem::unregister_bounds(bavil::Actor& _actor)
+	{
+		if ( _actor.m_bounds_id != AABBTree::INVALID_ID )
+		{
+			m_bounds_tree.remove(_actor.m_bounds_id);
+			_actor.m_bounds_id = AABBTree::INVALID_ID;
+		}
+	}
+
+	std::pmr::vector<WorldSystem::HierarchyNode> WorldSystem::extract_subtree(
+	    bavil::Actor* _actor)
+	{
+		std::pmr::vector<HierarchyNode> result(m_hierarchy.get_allocator());
+
+		if ( _actor->m_hierarchy_index == Actor::INVALID_WORLD_INDEX )
+		{
+			result.push_back({_actor});
+			return result;
+		}
+
+		const size_t begin = _actor->m_hierarchy_index;
+		const size_t end   = begin + 1 + m_hierarchy[begin].descendant_num;
 
-	void WorldSystem::add_actor(bavil::Actor* _actor) {}
-	void WorldSystem::remove_actor(bavil::Actor* _actor) {}
+		// 祖先の子孫の数から除く
+		u32 index = m_hierarchy[begin].parent;
+		for ( ; index != INVALID_HIERARCHY_INDEX; index = m_hierarchy[index].parent )
+		{
+			m_hierarchy[index].descendant_num -= static_cast<u32>(end - begin);
+		}
+
+		result.assign(m_hierarchy.begin() + begin, m_hierarchy.begin() + end);
+		m_hierarchy.erase(m_hierarchy.begin() + begin, m_hierarchy.begin() + end);
+		m_world_matrices.erase(m_world_matrices.begin() + begin,
+		                       m_world_matrices.begin() + end);
+		renumber_hierarchy(begin);
+
+		return result;
+	}
+
+	void WorldSystem::insert_subtree(
+	    size_t _position, const std::pmr::vector<HierarchyNode>& _subtree)
+	{
+		m_hierarchy.insert(
+		    m_hierarchy.begin() + _position, _subtree.begin(), _subtree.end());
+		m_world_matrices.insert(m_world_matrices.begin() + _position,
+		                        _subtree.size(),
+		                        bavil::math::Matrix44());
+
+		// 親が変わったのでワールド行列を計算し直す
+		m_hierarchy[_position].is_dirty = true;
+		renumber_hierarchy(_position);
+	}
+
+	void WorldSystem::prune_hierarchy_root(bavil::Actor* _actor)
+	{
+		const size_t index = _actor->m_hierarchy_index;
+		if ( index == Actor::INVALID_WORLD_INDEX || _actor->m_parent != nullptr ||
+		     m_hierarchy[index].descendant_num > 0 )
+		{
+			return;
+		}
+
+		m_hierarchy.erase(m_hierarchy.begin() + index);
+		m_world_matrices.erase(m_world_matrices.begin() + index);
+		_actor->m_hierarchy_index = Actor::INVALID_WORLD_INDEX;
+		renumber_hierarchy(index);
+	}
+
+	void WorldSystem::renumber_hierarchy(size_t _begin)
+	{
+		// 親は子より前に並んでいるので、変更した位置より前の要素は振り直す必要が無い
+		for ( size_t i = _begin; i < m_hierarchy.size(); ++i )
+		{
+			m_hierarchy[i].actor->m_hierarchy_index = i;
+		}
+		for ( size_t i = _begin; i < m_hierarchy.size(); ++i )
+		{
+			HierarchyNode& node = m_hierarchy[i];
+			if ( const bavil::Actor* parent = node.actor->m_parent )
+			{
+				node.parent = static_cast<u32>(parent->m_hierarchy_index);
+			}
+			else
+			{
+				node.parent = INVALID_HIERARCHY_INDEX;
+			}
+		}
+	}
+
+	void WorldSystem::set_fixed_step_settings(const FixedStepSettings& _settings)
+	{
+		// 間隔が0や負の値では補間係数を求められず、更新しない回数は意味が無いので、
+		// リリースビルドでも失敗させる
+		if ( !(_settings.step_seconds > 0.0f) ||
+		     !std::isfinite(_settings.step_seconds) )
+		{
+			throw std::invalid_argument(
+			    "WorldSystem: step_seconds must be positive and finite");
+		}
+		if ( _settings.max_step_num == 0 )
+		{
+			throw std::invalid_argument(
+			    "WorldSystem: max_step_num must be at least 1");
+		}
+		m_fixed_step_settings = _settings;
+	}
+
+	u32 WorldSystem::advance_fixed_step_internal(f32          _delta_seconds,
+	                                             void*        _context,
+	                                             StepFunction _function)
+	{
+		const f32 step_seconds = m_fixed_step_settings.step_seconds;
+
+		// 更新が経過時間に追い付かない場合に溜まり続けない様に、上限を超えた分は捨てる
+		const f32 max_seconds =
+		    step_seconds * static_cast<f32>(m_fixed_step_settings.max_step_num);
+		// 負の値や数値でない経過時間は進めない
+		const f32 delta_seconds =
+		    std::isfinite(_delta_seconds) ? std::max(_delta_seconds, 0.0f) : 0.0f;
+		m_fixed_step_accumulator =
+		    std::min(m_fixed_step_accumulator + delta_seconds, max_seconds);
+
+		u32 step_num = 0;
+		while ( m_fixed_step_accumulator >= step_seconds &&
+		        step_num < m_fixed_step_settings.max_step_num )
+		{
+			m_transform_store.save_previous();
+			tick(step_seconds);
+			if ( _function != nullptr )
+			{
+				_function(_context, step_seconds);
+			}
+			update_transforms();
+
+			m_fixed_step_accumulator -= step_seconds;
+			++step_num;
+		}
+
+		m_fixed_step_accumulator = std::max(m_fixed_step_accumulator, 0.0f);
+		m_interpolation_alpha =
+		    std::min(m_fixed_step_accumulator / step_seconds, 1.0f);
+		return step_num;
+	}
+
+	void WorldSystem::update_interpolated_matrices()
+	{
+		const size_t actor_num = m_actors.size();
+		const f32    alpha     = m_interpolation_alpha;
+		m_interpolated_matrices.resize(actor_num);
+
+		// トランスフォームの配列はアクターの配列と同じ順に並んでいる
+		auto interpolate = [&](size_t _begin, size_t _end)
+		{
+			for ( size_t i = _begin; i < _end; ++i )
+			{
+				m_interpolated_matrices[i] =
+				    m_transform_store.get_interpolated_matrix(i, alpha);
+			}
+		};
+		bavil::core::SystemManager* context =
+		    bavil::core::SystemManager::GetCurrent();
+		if ( context != nullptr && actor_num > PARALLEL_INTERPOLATE_CHUNK_SIZE )
+		{
+			TaskSystem::Get(*context).parallel_for(
+			    actor_num, PARALLEL_INTERPOLATE_CHUNK_SIZE, interpolate);
+		}
+		else
+		{
+			interpolate(0, actor_num);
+		}
+
+		// 親は子より前に並んでいるので、補間済みの親の行列を掛けられる
+		for ( const HierarchyNode& node : m_hierarchy )
+		{
+			if ( node.parent == INVALID_HIERARCHY_INDEX )
+			{
+				continue;
+			}
+			const size_t index  = node.actor->m_world_index;
+			const size_t parent = m_hierarchy[node.parent].actor->m_world_index;
+			m_interpolated_matrices[index] *= m_interpolated_matrices[parent];
+		}
+	}
+
+	const bavil::math::Matrix44& WorldSystem::get_interpolated_matrix(
+	    const bavil::Actor& _actor) const noexcept
+	{
+		const size_t index = _actor.m_world_index;
+		if ( index >= m_interpolated_matrices.size() || m_actors[index] != &_actor )
+		{
+			return get_world_matrix(_actor);
+		}
+		return m_interpolated_matrices[index];
+	}
 
 } // namespace bavil
@@ -28,7 +28,7 @@ namespace bavil::math
 
 		Quaternion result = {};
 		result.x          = +cr * sp * sy - sr * cp * cy;
-		result.y          = -cr * sp * cy - sr * cp * sr;
+		result.y          = -cr * sp * cy - sr * cp * sy;
 		result.z          = +cr * cp * sy - sr * sp * cy;
 		result.w          = +cr * cp * cy + sr * sp * sy;
 
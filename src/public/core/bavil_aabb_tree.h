@@ -0,0 +1,196 @@
+#pragma once
+
+#include <concepts>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "bavil_type.h"
+#include "math/bavil_aabb.h"
+#include "math/bavil_ray.h"
+
+namespace bavil
+{
+
+	class Actor;
+
+	/**
+	 * @brief 半直線の判定結果
+	 */
+	struct RaycastHit
+	{
+		// 最も近くで当たったアクター(当たらなかった場合はnullptr)
+		bavil::Actor* actor = nullptr;
+		// 始点から当たった位置までの距離
+		f32 distance = std::numeric_limits<f32>::infinity();
+
+		bool is_hit() const noexcept
+		{
+			return actor != nullptr;
+		}
+	};
+
+	/**
+	 * @brief アクターの境界ボックスを格納する動的な境界ボリューム階層
+	 * 葉には少し広げた境界ボックスを持たせ、その中で動いている間は木を組み替えない
+	 * 葉の挿入は表面積の合計が最も増えない位置を枝を刈りながら探し、
+	 * 根までの経路で回転して高さを揃える
+	 * 半直線はRAY_PACKET_SIZE本ずつまとめて木を辿り、境界ボックスとの判定を
+	 * SIMDで同時に行う
+	 */
+	class AABBTree
+	{
+	public:
+		static constexpr u32 INVALID_ID = static_cast<u32>(-1);
+		// 葉の境界ボックスを広げる既定の距離
+		static constexpr f32 DEFAULT_MARGIN = 0.1f;
+		// raycast() で1回に木を辿る半直線の数
+		static constexpr size_t RAY_PACKET_SIZE = 4;
+
+		explicit AABBTree(std::pmr::memory_resource* _resource,
+		                  f32                        _margin = DEFAULT_MARGIN);
+
+		AABBTree(const AABBTree&)            = delete;
+		AABBTree& operator=(const AABBTree&) = delete;
+
+		/**
+		 * @brief 要素を追加する
+		 * @return 要素の番号
+		*/
+		u32 insert(bavil::Actor* _actor, const bavil::math::AABB& _bounds);
+
+		/**
+		 * @brief 要素の境界ボックスを更新する
+		 * 広げた境界ボックスに収まっている場合は木を組み替えない
+		 * @return 木に挿入し直した場合はtrue
+		*/
+		bool update(u32 _id, const bavil::math::AABB& _bounds);
+
+		void remove(u32 _id);
+
+		void clear() noexcept;
+
+		size_t size() const noexcept
+		{
+			return m_leaf_num;
+		}
+
+		/**
+		 * @brief 木の高さを取得する(葉のみの場合は0)
+		*/
+		u32 get_height() const noexcept
+		{
+			return m_root != INVALID_ID ? m_links[m_root].height : 0;
+		}
+
+		/**
+		 * @brief 要素の境界ボックスを取得する
+		*/
+		const bavil::math::AABB& get_bounds(u32 _id) const noexcept
+		{
+			return m_leaves[_id].bounds;
+		}
+
+		/**
+		 * @brief 要素の広げた境界ボックスを取得する
+		*/
+		const bavil::math::AABB& get_fat_bounds(u32 _id) const noexcept
+		{
+			return m_nodes[_id].bounds;
+		}
+
+		/**
+		 * @brief 境界ボックスと重なる要素を呼び出す
+		 * @param _func void(Actor&)で呼び出す関数
+		*/
+		template<class Func>
+			requires(std::invocable<Func&, bavil::Actor&>)
+		void query_aabb(const bavil::math::AABB& _aabb, Func&& _func) const
+		{
+			query_aabb_internal(_aabb,
+			                    &_func,
+			                    [](void* _context, bavil::Actor& _actor)
+			                    {
+				                    (*static_cast<std::remove_reference_t<Func>*>(
+				                        _context))(_actor);
+			                    });
+		}
+
+		/**
+		 * @brief 半直線毎に最も近くで当たった要素を求める
+		 * @param _rays 判定する半直線
+		 * @param _hits 判定結果を格納する配列(_raysと同じ要素数が必要)
+		*/
+		void raycast(std::span<const bavil::math::Ray> _rays,
+		             std::span<RaycastHit>             _hits) const;
+
+	private:
+		// 挿入する位置を探す時に調べる節点の最大数
+		static constexpr u32 MAX_INSERT_CANDIDATE_NUM = 256;
+
+		using QueryFunction = void (*)(void* _context, bavil::Actor& _actor);
+
+		// 木を辿る時に読む節点の値(2つで1つのキャッシュラインに収まる)
+		struct alignas(32) Node
+		{
+			// 内部の節点は子の境界ボックスを囲み、葉は広げた境界ボックスを持つ
+			bavil::math::AABB bounds;
+			u32               children[2] = {INVALID_ID, INVALID_ID};
+
+			bool is_leaf() const noexcept
+			{
+				return children[0] == INVALID_ID;
+			}
+		};
+
+		// 木を組み替える時に使う節点の値
+		struct Link
+		{
+			u32 parent = INVALID_ID;
+			// 葉からの高さ(葉は0)
+			u32 height = 0;
+		};
+
+		// 葉の値(内部の節点では使わない)
+		struct Leaf
+		{
+			// 広げる前の境界ボックス
+			bavil::math::AABB bounds;
+			bavil::Actor*     actor = nullptr;
+		};
+
+		void query_aabb_internal(const bavil::math::AABB& _aabb,
+		                         void*                    _context,
+		                         QueryFunction            _function) const;
+
+		// RAY_PACKET_SIZE本以下の半直線で木を辿る
+		void raycast_packet(const bavil::math::Ray* _rays,
+		                    RaycastHit*             _hits,
+		                    size_t                  _num) const;
+
+		u32  allocate_node();
+		void free_node(u32 _id);
+		void insert_leaf(u32 _leaf);
+		void remove_leaf(u32 _leaf);
+		// 根までの経路の境界ボックスと高さを直し、偏りがあれば回転する
+		void refit_ancestors(u32 _id);
+		// 子から境界ボックスと高さを求め直す
+		void refit(u32 _id) noexcept;
+		// 左右の子の高さが2以上違う場合に回転し、部分木の新しい根を返す
+		u32 balance(u32 _id);
+		// 親が指している子を付け替える(根の場合は根を付け替える)
+		void replace_child(u32 _parent, u32 _old_child, u32 _new_child);
+
+	private:
+		// 節点の値は番号毎に別の配列に分けて持つ
+		std::pmr::vector<Node> m_nodes;
+		std::pmr::vector<Link> m_links;
+		std::pmr::vector<Leaf> m_leaves;
+		std::pmr::vector<u32>  m_free_ids;
+		u32                    m_root     = INVALID_ID;
+		size_t                 m_leaf_num = 0;
+		f32                    m_margin   = DEFAULT_MARGIN;
+	};
+
+} // namespace bavil
@@ -1,66 +1,28 @@
 #pragma once
 
+#include "bavil_type.h"
+#include "core/bavil_entity.h"
 #include "core/bavil_object_base.h"
-#include "math/bavil_vector3.h"
-#include "math/bavil_rotator.h"
-#include "math/bavil_matrix44.h"
+#include "core/bavil_transform_store.h"
+#include "math/bavil_aabb.h"
 
 namespace bavil
 {
 
-	class Transform
-	{
-	public:
-		const bavil::math::Matrix44& get_matrix() const noexcept
-		{
-			return m_cash_matrix;
-		}
-
-		bavil::math::Vector3 get_position() const noexcept
-		{
-			return m_position;
-		}
-		bavil::math::Rotator get_rotation() const noexcept
-		{
-			return m_rotation;
-		}
-		bavil::math::Vector3 get_scale() const noexcept
-		{
-			return m_scale;
-		}
-
-		void set_position(bavil::math::Vector3 _position) noexcept
-		{
-			m_position = _position;
-			recash();
-		}
-		void get_rotation(bavil::math::Rotator _rotation) noexcept
-		{
-			m_rotation = _rotation;
-			recash();
-		}
-		void set_scale(bavil::math::Vector3 _scale) noexcept
-		{
-			m_scale = _scale;
-			recash();
-		}
-
-	private:
-		void recash() noexcept;
-
-	private:
-		bavil::math::Vector3  m_position;
-		bavil::math::Rotator  m_rotation;
-		bavil::math::Vector3  m_scale;
-		bavil::math::Matrix44 m_cash_matrix;
-		bool                  m_is_recash_request = false;
-	};
+	class WorldSystem;
 
 	class Actor : public ObjectBase
 	{
+		friend class WorldSystem;
+		friend class EntitySystem;
+		friend class ActorPoolSystem;
+
 	public:
 		using SuperType = ObjectBase;
 
+		// ワールドに登録されていない事を表す番号
+		static constexpr size_t INVALID_WORLD_INDEX = static_cast<size_t>(-1);
+
 		Actor() {}
 
 		/**
@@ -72,6 +34,44 @@ namespace bavil
 		 */
 		virtual void destruct() override;
 
+		/**
+		 * @brief ActorPoolSystem に返却された時に呼ばれる
+		 * ワールドから外した後に呼ばれるので、次の再利用に向けて状態を戻す
+		 */
+		virtual void reset() {}
+		/**
+		 * @brief ActorPoolSystem から再利用された時に construct() の代わりに呼ばれる
+		 * ワールドに登録し直し、トランスフォームを書き込んだ後に呼ばれる
+		 */
+		virtual void reactivate() {}
+
+		/**
+		 * @brief 毎フレーム WorldSystem::tick() から呼ばれる
+		 * set_tick_enabled() で有効にしたアクターのみ呼ばれる
+		 * @param _delta_seconds 前のフレームからの経過時間(秒)
+		 */
+		virtual void tick([[maybe_unused]] f32 _delta_seconds) {}
+
+		/**
+		 * @brief tick() を呼び出すか設定する
+		*/
+		void set_tick_enabled(bool _enabled);
+
+		bool is_tick_enabled() const noexcept
+		{
+			return m_is_tick_enabled;
+		}
+
+		bool is_tick_thread_safe() const noexcept
+		{
+			return m_is_tick_thread_safe;
+		}
+
+		/**
+		 * @brief トランスフォームを取得する
+		 * 値はワールドのトランスフォームの配列に格納されるので、
+		 * ワールドに登録されている間のみ値を変更できる
+		*/
 		Transform& get_transform() noexcept
 		{
 			return m_transform;
@@ -82,8 +82,88 @@ namespace bavil
 			return m_transform;
 		}
 
+		/**
+		 * @brief ローカル座標での境界ボックスを設定する
+		 * 境界ボックスを持つアクターはワールドの半直線や重なりの判定の対象になる
+		*/
+		void set_local_bounds(const bavil::math::AABB& _bounds);
+
+		/**
+		 * @brief 境界ボックスを取り除き、判定の対象から外す
+		*/
+		void clear_local_bounds();
+
+		bool has_local_bounds() const noexcept
+		{
+			return m_has_local_bounds;
+		}
+
+		const bavil::math::AABB& get_local_bounds() const noexcept
+		{
+			return m_local_bounds;
+		}
+
+		/**
+		 * @brief ワールドに登録されているか確認する
+		*/
+		bool is_in_world() const noexcept
+		{
+			return m_world_index != INVALID_WORLD_INDEX;
+		}
+
+		/**
+		 * @brief EntitySystem::bridge_actor() で登録したエンティティを取得する
+		 * @return 登録していない場合は無効な値
+		*/
+		Entity get_entity() const noexcept
+		{
+			return m_entity;
+		}
+
+		/**
+		 * @brief 親のアクターを取得する
+		 * @return 親が居ない場合はnullptr
+		*/
+		Actor* get_parent() const noexcept
+		{
+			return m_parent;
+		}
+
+	protected:
+		/**
+		 * @brief tick() を他のアクターと並列に呼び出せる事を宣言する
+		 * tick() の中で自身以外のアクターへの書き込みや、ワールドへの登録、削除を
+		 * 行わない場合のみ有効にできる
+		*/
+		void set_tick_thread_safe(bool _thread_safe);
+
 	protected:
 		Transform m_transform;
+
+	private:
+		// ワールドのアクター配列での位置
+		size_t m_world_index = INVALID_WORLD_INDEX;
+		// ワールドの階層の配列での位置(親子関係を持たない場合は無効)
+		size_t m_hierarchy_index = INVALID_WORLD_INDEX;
+		// 親のアクター
+		Actor* m_parent = nullptr;
+		// ワールドのtickを呼び出す配列での位置
+		size_t m_tick_index          = INVALID_WORLD_INDEX;
+		// ワールドの空間の索引での番号
+		u32    m_spatial_id          = static_cast<u32>(-1);
+		// ワールドの境界ボックスの木での番号
+		u32    m_bounds_id           = static_cast<u32>(-1);
+		bool   m_is_tick_enabled     = false;
+		bool   m_is_tick_thread_safe = false;
+		bool   m_has_local_bounds    = false;
+		// ローカル座標での境界ボックス
+		bavil::math::AABB m_local_bounds;
+		// エンティティシステムに登録したエンティティ
+		Entity m_entity;
+		// 生成したアクターのプールの型ID(プールで生成していない場合は無効)
+		u32  m_pool_id    = static_cast<u32>(-1);
+		// プールに返却されて未使用か
+		bool m_is_in_pool = false;
 	};
 
 	template<class T> concept ActorConcepts = requires(T obj)
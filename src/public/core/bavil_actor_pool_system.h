@@ -0,0 +1,158 @@
+#pragma once
+
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "bavil_type.h"
+#include "core/bavil_actor.h"
+#include "core/bavil_object_handle.h"
+#include "core/bavil_object_system.h"
+#include "core/bavil_system_manager.h"
+#include "math/bavil_rotator.h"
+#include "math/bavil_vector3.h"
+
+namespace bavil
+{
+
+	class WorldSystem;
+
+	/**
+	 * @brief アクターの型毎のプールの設定
+	 */
+	struct ActorPoolSettings
+	{
+		// 事前に生成しておくアクターの数
+		size_t warm_num = 0;
+		// 保持しておく未使用のアクターの最大数(超えた分は返却時に削除する)
+		size_t max_free_num = std::numeric_limits<size_t>::max();
+	};
+
+	/**
+	 * @brief 同じ型のアクターを削除せずに保持し、次の生成で再利用するシステム
+	 * 返却したアクターはワールドから外して Actor::reset() を呼び、
+	 * 型毎の未使用の配列に積む
+	 * 生成時は未使用の配列から取り出してワールドに登録し直し、トランスフォームを
+	 * 書き込んでから Actor::reactivate() を呼ぶので、確保と construct() を行わない
+	 * 未使用のアクターが無い場合は ObjectSystem で新しく生成する
+	 */
+	class ActorPoolSystem : public bavil::core::SystemBase<ActorPoolSystem>
+	{
+	public:
+		explicit ActorPoolSystem(bavil::core::SystemAllocator& _allocator);
+
+		virtual void initialize(
+		    bavil::core::SystemManager& _system_manager) override;
+
+		virtual void finalize() override;
+
+		/**
+		 * @brief プールの型IDを取得する
+		*/
+		template<ActorConcepts T>
+		static size_t GetPoolTypeId()
+		{
+			static const size_t s_id = GeneratedPoolTypeIdInternal();
+			return s_id;
+		}
+
+		/**
+		 * @brief 型毎のプールを設定する
+		 * 未使用のアクターが warm_num に満たない場合はその数まで生成し、
+		 * max_free_num を超える場合は超えた分を削除する
+		*/
+		template<ActorConcepts T>
+		void configure(const ActorPoolSettings& _settings)
+		{
+			configure_internal(get_pool<T>(), _settings);
+		}
+
+		/**
+		 * @brief プールからアクターを取り出してワールドに登録する
+		 * 再利用したアクターはトランスフォームを書き込んでから reactivate() を呼ぶ
+		*/
+		template<ActorConcepts T>
+		[[nodiscard]] ObjectHandle<T> spawn(
+		    const bavil::math::Vector3& _position,
+		    const bavil::math::Rotator& _rotation = bavil::math::Rotator())
+		{
+			return ObjectHandle<T>(
+			    spawn_internal(get_pool<T>(), _position, _rotation));
+		}
+
+		/**
+		 * @brief アクターをプールに返却する
+		 * 返却するハンドルが最後の参照の場合のみプールに積み、取得済みの
+		 * ObjectBinding は無効になる
+		 * 他にハンドルが残っているアクターや、プールから生成していないアクター、
+		 * 未使用の数が max_free_num に達している場合はハンドルを手放すだけで、
+		 * 他に参照が無ければ削除される
+		*/
+		template<ActorConcepts T>
+		void despawn(ObjectHandle<T>&& _actor)
+		{
+			despawn_internal(std::move(_actor));
+		}
+
+		/**
+		 * @brief 未使用のアクターの数を取得する
+		*/
+		template<ActorConcepts T>
+		size_t get_free_num() const noexcept
+		{
+			const size_t id = GetPoolTypeId<T>();
+			return id < m_pools.size() ? m_pools[id].free_actors.size() : 0;
+		}
+
+	private:
+		using ActorFactory = ObjectHandleBase (*)(ObjectSystem& _object_system);
+
+		struct Pool
+		{
+			explicit Pool(std::pmr::memory_resource* _resource)
+			    : free_actors(_resource)
+			{
+			}
+
+			ActorFactory      create = nullptr;
+			ActorPoolSettings settings;
+			// ワールドから外した未使用のアクター
+			std::pmr::vector<ObjectHandleBase> free_actors;
+		};
+
+		template<ActorConcepts T>
+		u32 get_pool()
+		{
+			const size_t id = GetPoolTypeId<T>();
+			while ( m_pools.size() <= id )
+			{
+				m_pools.emplace_back(m_pools.get_allocator().resource());
+			}
+			if ( m_pools[id].create == nullptr )
+			{
+				m_pools[id].create = [](ObjectSystem& _object_system)
+				{ return ObjectHandleBase(_object_system.create_object<T>()); };
+			}
+			return static_cast<u32>(id);
+		}
+
+		static size_t GeneratedPoolTypeIdInternal();
+
+		// プールの型のアクターを新しく生成する
+		ObjectHandleBase create_actor(u32 _pool_id);
+		bavil::Actor*    get_actor(const ObjectHandleBase& _handle) const;
+
+		void             configure_internal(u32                      _pool_id,
+		                                    const ActorPoolSettings& _settings);
+		ObjectHandleBase spawn_internal(u32                         _pool_id,
+		                                const bavil::math::Vector3& _position,
+		                                const bavil::math::Rotator& _rotation);
+		void             despawn_internal(ObjectHandleBase&& _actor);
+
+	private:
+		bavil::ObjectSystem*   m_object_system = nullptr;
+		bavil::WorldSystem*    m_world_system  = nullptr;
+		std::pmr::vector<Pool> m_pools;
+	};
+
+} // namespace bavil
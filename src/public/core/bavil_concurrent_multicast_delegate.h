@@ -0,0 +1,307 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/bavil_multicast_delegate.h"
+
+namespace bavil
+{
+
+	namespace detail
+	{
+		// 読み込み側のカウンタの分割数
+		inline constexpr size_t CONCURRENT_DELEGATE_STRIPE_NUM = 16;
+
+		// スレッド毎に使用するカウンタの番号
+		inline size_t get_concurrent_delegate_stripe() noexcept
+		{
+			static std::atomic<size_t> s_next_stripe = 0;
+			thread_local const size_t  t_stripe =
+			    s_next_stripe++ % CONCURRENT_DELEGATE_STRIPE_NUM;
+			return t_stripe;
+		}
+
+		// このスレッドで実行中のブロードキャストの深さ
+		inline thread_local size_t t_concurrent_broadcast_depth = 0;
+	} // namespace detail
+
+	template<class T, class FunctionType = std::function<T>>
+	class ConcurrentMulticastDelegate;
+
+	/**
+	 * @brief 複数のスレッドから使用できるマルチキャストデリゲート
+	 * ブロードキャストは不変のスナップショットをアトミックなポインタから読むだけでロックを取らない
+	 * 登録と削除は新しいスナップショットを作成して差し替え、読み込み中のスレッドが
+	 * 居なくなってから古いスナップショットを破棄する
+	 */
+	template<class... Args, class FunctionType>
+	class ConcurrentMulticastDelegate<void(Args...), FunctionType>
+	{
+		static_assert(std::copy_constructible<FunctionType>,
+		              "snapshots copy the stored functions");
+
+	public:
+		ConcurrentMulticastDelegate() = default;
+
+		ConcurrentMulticastDelegate(const ConcurrentMulticastDelegate&) = delete;
+		ConcurrentMulticastDelegate& operator=(
+		    const ConcurrentMulticastDelegate&) = delete;
+
+		~ConcurrentMulticastDelegate()
+		{
+			delete m_snapshot.load(std::memory_order_relaxed);
+			for ( Snapshot* snapshot : m_retired_snapshots )
+			{
+				delete snapshot;
+			}
+		}
+
+		/**
+		 * @brief デリゲートを登録する
+		 * @param func デリゲート
+		 * @return
+		*/
+		template<class Func>
+			requires(std::constructible_from<FunctionType, Func>)
+		DelegateHandle add(Func func)
+		{
+			DelegateHandle handle;
+			{
+				std::lock_guard lock(m_write_mutex);
+
+				// 削除したハンドルを再利用しない様に、通し番号を世代に振り分ける
+				handle = {static_cast<uint32_t>(m_handle_counter),
+				          static_cast<uint32_t>(m_handle_counter >> 32)};
+				m_handle_counter++;
+
+				auto* snapshot = copy_snapshot();
+				snapshot->functions.emplace_back(std::move(func));
+				snapshot->handles.push_back(handle);
+				publish(snapshot);
+			}
+			reclaim();
+
+			return handle;
+		}
+
+		/**
+		 * @brief デリゲートを削除する
+		 * @param _handle ハンドル
+		*/
+		void remove(DelegateHandle _handle)
+		{
+			{
+				std::lock_guard lock(m_write_mutex);
+
+				const Snapshot* current = m_snapshot.load(std::memory_order_relaxed);
+				if ( current == nullptr || !current->contains(_handle) )
+				{
+					return;
+				}
+
+				auto* snapshot = new Snapshot();
+				snapshot->functions.reserve(current->functions.size() - 1);
+				snapshot->handles.reserve(current->handles.size() - 1);
+				for ( size_t i = 0; i < current->handles.size(); ++i )
+				{
+					if ( current->handles[i] != _handle )
+					{
+						snapshot->functions.push_back(current->functions[i]);
+						snapshot->handles.push_back(current->handles[i]);
+					}
+				}
+				publish(snapshot);
+			}
+			reclaim();
+		}
+
+		/**
+		 * @brief 登録したイベントをクリアする
+		*/
+		void clear()
+		{
+			{
+				std::lock_guard lock(m_write_mutex);
+				publish(nullptr);
+			}
+			reclaim();
+		}
+
+		bool is_valid(DelegateHandle _handle) const
+		{
+			ReadScope scope(*this);
+			return scope.snapshot != nullptr && scope.snapshot->contains(_handle);
+		}
+
+		bool has_delegates() const
+		{
+			return get_delegate_num() > 0;
+		}
+
+		size_t get_delegate_num() const
+		{
+			ReadScope scope(*this);
+			return scope.snapshot != nullptr ? scope.snapshot->functions.size()
+			                                 : 0;
+		}
+
+		/**
+		 * @brief イベントの呼び出し
+		 * どのスレッドからでも呼び出せ、呼び出し開始時点で登録されていたデリゲートを呼ぶ
+		 * @param ...args
+		*/
+		void broadcast(Args... args) const
+		{
+			ReadScope scope(*this);
+			if ( scope.snapshot == nullptr )
+			{
+				return;
+			}
+
+			detail::t_concurrent_broadcast_depth++;
+			for ( const FunctionType& target : scope.snapshot->functions )
+			{
+				target(args...);
+			}
+			detail::t_concurrent_broadcast_depth--;
+		}
+
+	private:
+		struct Snapshot
+		{
+			std::vector<FunctionType>   functions;
+			std::vector<DelegateHandle> handles;
+
+			bool contains(DelegateHandle _handle) const
+			{
+				for ( DelegateHandle handle : handles )
+				{
+					if ( handle == _handle )
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+		};
+
+		// 読み込み中のスレッドの数
+		// 書き込み側はエポックを切り替えて、古いエポックのカウンタが0になるのを待つ
+		struct alignas(64) ReaderCounter
+		{
+			std::atomic<size_t> count[2] = {};
+		};
+
+		// スナップショットを読んでいる間カウンタを保持する
+		struct ReadScope
+		{
+			explicit ReadScope(const ConcurrentMulticastDelegate& _delegate) noexcept
+			    : counter(
+			          _delegate.m_readers[detail::get_concurrent_delegate_stripe()])
+			    , epoch(_delegate.m_epoch.load(std::memory_order_seq_cst))
+			{
+				counter.count[epoch].fetch_add(1, std::memory_order_seq_cst);
+				snapshot = _delegate.m_snapshot.load(std::memory_order_seq_cst);
+			}
+
+			~ReadScope()
+			{
+				counter.count[epoch].fetch_sub(1, std::memory_order_release);
+			}
+
+			ReaderCounter&  counter;
+			size_t          epoch    = 0;
+			const Snapshot* snapshot = nullptr;
+		};
+
+		Snapshot* copy_snapshot() const
+		{
+			const Snapshot* current = m_snapshot.load(std::memory_order_relaxed);
+			return current != nullptr ? new Snapshot(*current) : new Snapshot();
+		}
+
+		// m_write_mutex をロックした状態で呼ぶ
+		void publish(Snapshot* _snapshot)
+		{
+			Snapshot* old =
+			    m_snapshot.exchange(_snapshot, std::memory_order_seq_cst);
+			if ( old != nullptr )
+			{
+				m_retired_snapshots.push_back(old);
+			}
+		}
+
+		// 差し替えたスナップショットを破棄する
+		// 読み込みの完了を待つ間に m_write_mutex を保持していると、ブロードキャスト中の
+		// スレッドからの書き込みと待ち合ってしまうので、ロックを分けている
+		void reclaim()
+		{
+			// ブロードキャスト中のスレッドは自分が読み込み中なので待てない
+			// 破棄は次の書き込みまで遅らせる
+			if ( detail::t_concurrent_broadcast_depth > 0 )
+			{
+				return;
+			}
+
+			std::lock_guard        reclaim_lock(m_reclaim_mutex);
+			std::vector<Snapshot*> retired;
+			{
+				std::lock_guard lock(m_write_mutex);
+				retired.swap(m_retired_snapshots);
+			}
+			if ( retired.empty() )
+			{
+				return;
+			}
+
+			synchronize();
+
+			for ( Snapshot* snapshot : retired )
+			{
+				delete snapshot;
+			}
+		}
+
+		// 差し替える前のスナップショットを読んでいるスレッドが居なくなるまで待つ
+		void synchronize()
+		{
+			// エポックを読んでからカウンタを増やすまでの間に切り替わる場合があるので
+			// 両方のエポックについて待つ
+			for ( size_t i = 0; i < 2; ++i )
+			{
+				const size_t old_epoch = m_epoch.load(std::memory_order_relaxed);
+				m_epoch.store(old_epoch ^ 1, std::memory_order_seq_cst);
+
+				for ( const ReaderCounter& reader : m_readers )
+				{
+					const auto& count = reader.count[old_epoch];
+					while ( count.load(std::memory_order_seq_cst) != 0 )
+					{
+						std::this_thread::yield();
+					}
+				}
+			}
+		}
+
+	private:
+		using ReaderCounters =
+		    std::array<ReaderCounter, detail::CONCURRENT_DELEGATE_STRIPE_NUM>;
+
+		std::atomic<Snapshot*> m_snapshot = nullptr;
+		std::atomic<size_t>    m_epoch    = 0;
+		mutable ReaderCounters m_readers;
+
+		// 書き込み側のみ使用する
+		std::mutex             m_write_mutex;
+		std::mutex             m_reclaim_mutex;
+		std::vector<Snapshot*> m_retired_snapshots;
+		uint64_t               m_handle_counter = 0;
+	};
+
+} // namespace bavil
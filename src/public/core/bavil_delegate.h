@@ -0,0 +1,153 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "core/bavil_inline_function.h"
+
+namespace bavil
+{
+
+	template<class T, size_t Size = 48>
+	class Delegate;
+
+	/**
+	 * @brief 1つの関数だけを登録するデリゲート
+	 * 関数は内部のバッファに保持してヒープを使用せず、呼び出しは1回の間接呼び出しで済む
+	 * デフォルトのサイズでは1キャッシュライン(64バイト)に収まる
+	 * コピーは出来ず、ムーブのみ可能
+	 * @tparam Size 内部のバッファのバイト数
+	 */
+	template<class R, class... Args, size_t Size>
+	class Delegate<R(Args...), Size>
+	{
+	public:
+		using FunctionType = InlineFunction<R(Args...), Size>;
+
+		Delegate() noexcept = default;
+
+		Delegate(std::nullptr_t) noexcept {}
+
+		template<class Func>
+			requires(!std::same_as<std::remove_cvref_t<Func>, Delegate> &&
+		             std::constructible_from<FunctionType, Func>)
+		Delegate(Func&& _func)
+		    : m_function(std::forward<Func>(_func))
+		{
+		}
+
+		/**
+		 * @brief ラムダ式や関数ポインタを登録する
+		 * 既に登録されている関数は破棄する
+		*/
+		template<class Func>
+			requires(std::constructible_from<FunctionType, Func>)
+		void bind(Func&& _func)
+		{
+			m_function = std::forward<Func>(_func);
+		}
+
+		/**
+		 * @brief 関数を登録する
+		 * 関数のアドレスをテンプレート引数で受け取るので、関数ポインタを保持せず直接呼び出す
+		 * @tparam Function 関数のポインタ
+		*/
+		template<auto Function>
+			requires(std::is_invocable_r_v<R, decltype(Function), Args...>)
+		void bind_static()
+		{
+			m_function = StaticFunction<Function>{};
+		}
+
+		/**
+		 * @brief オブジェクトのメンバ関数を登録する
+		 * オブジェクトのポインタのみを保持してメンバ関数を直接呼び出す
+		 * オブジェクトの寿命は管理しないので、破棄する前に unbind() する必要がある
+		 * @tparam Method メンバ関数のポインタ
+		 * @param _object オブジェクト
+		*/
+		template<auto Method, class T>
+			requires(std::is_invocable_r_v<R, decltype(Method), T*, Args...>)
+		void bind_member(T* _object)
+		{
+			m_function = MemberFunction<Method, T>{_object};
+		}
+
+		/**
+		 * @brief 登録した関数を破棄する
+		*/
+		void unbind() noexcept
+		{
+			m_function.reset();
+		}
+
+		bool is_bound() const noexcept
+		{
+			return static_cast<bool>(m_function);
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return is_bound();
+		}
+
+		/**
+		 * @brief 登録した関数を呼び出す
+		 * 関数が登録されているかは確認しないので、事前に is_bound() で確認する必要がある
+		*/
+		R execute(Args... _args) const
+		{
+			return m_function(std::forward<Args>(_args)...);
+		}
+
+		R operator()(Args... _args) const
+		{
+			return m_function(std::forward<Args>(_args)...);
+		}
+
+		/**
+		 * @brief 関数が登録されている場合のみ呼び出す
+		 * @return 呼び出した場合はtrue
+		*/
+		bool execute_if_bound(Args... _args) const
+			requires(std::is_void_v<R>)
+		{
+			if ( !is_bound() )
+			{
+				return false;
+			}
+			m_function(std::forward<Args>(_args)...);
+			return true;
+		}
+
+	private:
+		// 関数を直接呼び出す関数オブジェクト
+		template<auto Function>
+		struct StaticFunction
+		{
+			R operator()(Args... _args) const
+			{
+				return std::invoke(Function, std::forward<Args>(_args)...);
+			}
+		};
+
+		// メンバ関数を直接呼び出す関数オブジェクト
+		template<auto Method, class T>
+		struct MemberFunction
+		{
+			T* object;
+
+			R operator()(Args... _args) const
+			{
+				return std::invoke(Method, object, std::forward<Args>(_args)...);
+			}
+		};
+
+	private:
+		FunctionType m_function;
+	};
+
+} // namespace bavil
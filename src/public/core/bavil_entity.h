@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bavil
+{
+
+	/**
+	 * @brief EntitySystem で生成したエンティティを指す
+	 * ObjectBinding と同じく番号と世代の組で、破棄後に番号が再利用されても
+	 * 世代が変わるので古い値は無効になる
+	 */
+	struct Entity
+	{
+		int64_t  index      = -1;
+		uint32_t generation = 0;
+
+		constexpr bool is_valid() const noexcept
+		{
+			return index != -1;
+		}
+
+		friend constexpr bool operator==(const Entity&, const Entity&) = default;
+	};
+
+} // namespace bavil
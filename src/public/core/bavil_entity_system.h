@@ -0,0 +1,520 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "bavil_type.h"
+#include "core/bavil_entity.h"
+#include "core/bavil_system_manager.h"
+
+namespace bavil
+{
+
+	class Actor;
+
+	/**
+	 * @brief アクターとエンティティを結び付けるコンポーネント
+	 * EntitySystem::bridge_actor() で追加する
+	 */
+	struct ActorComponent
+	{
+		bavil::Actor* actor = nullptr;
+	};
+
+	template<class T> concept ComponentConcepts =
+	    std::is_object_v<T> && !std::is_const_v<T> &&
+	    std::is_move_constructible_v<T> && std::is_destructible_v<T>;
+
+	/**
+	 * @brief コンポーネントの組み合わせ毎にエンティティをまとめて保持するシステム
+	 * 同じ組み合わせ(アーキタイプ)のエンティティは固定の大きさのチャンクに詰めて格納し、
+	 * チャンクの中ではコンポーネント毎に連続した配列に並べる
+	 * コンポーネントを追加、削除したエンティティは別のアーキタイプへ移し、
+	 * 空いた位置には末尾のエンティティを移すので、チャンクは常に前から詰まっている
+	 * 検索は組み合わせを含むアーキタイプのチャンクを順に辿るだけで済み、
+	 * チャンク毎に TaskSystem のワーカースレッドへ分けて並列にも処理できる
+	 */
+	class EntitySystem : public bavil::core::SystemBase<EntitySystem>
+	{
+	public:
+		// 登録できるコンポーネントの型の最大数
+		static constexpr size_t MAX_COMPONENT_TYPE_NUM = 64;
+		// チャンクの大きさ(バイト)
+		static constexpr size_t CHUNK_SIZE = 16 * 1024;
+		// チャンクの先頭のアライメント(これを超えるアライメントの型は格納できない)
+		static constexpr size_t CHUNK_ALIGNMENT = 64;
+
+		// コンポーネントの型IDのビットを立てた組み合わせ
+		using ComponentMask = u64;
+
+		explicit EntitySystem(bavil::core::SystemAllocator& _allocator);
+
+		virtual void initialize(
+		    bavil::core::SystemManager& _system_manager) override;
+
+		virtual void finalize() override;
+
+		/**
+		 * @brief コンポーネントの型IDを取得する
+		 * 型の数が MAX_COMPONENT_TYPE_NUM を超えた場合は std::length_error を投げる
+		*/
+		template<ComponentConcepts T>
+		static size_t GetComponentTypeId()
+		{
+			static const size_t s_id =
+			    GeneratedComponentTypeIdInternal(MakeComponentInfo<T>());
+			return s_id;
+		}
+
+		/**
+		 * @brief コンポーネントの組み合わせを取得する
+		*/
+		template<ComponentConcepts... Ts>
+		static ComponentMask GetComponentMask()
+		{
+			return (ComponentMask(0) | ... |
+			        (ComponentMask(1) << GetComponentTypeId<Ts>()));
+		}
+
+		/**
+		 * @brief エンティティを生成する
+		 * コンポーネントの組み合わせがチャンクに収まらない場合は std::length_error を投げる
+		 * @param _components エンティティに持たせるコンポーネント(型は重複できない)
+		*/
+		template<ComponentConcepts... Ts>
+		Entity create_entity(Ts... _components)
+		{
+			const ComponentMask mask = GetComponentMask<Ts...>();
+			assert(std::popcount(mask) == static_cast<int>(sizeof...(Ts)));
+
+			const Entity entity = allocate_entity(find_or_create_archetype(mask));
+			const EntityRecord& record = m_records[entity.index];
+			(::new (get_component_pointer(record, GetComponentTypeId<Ts>()))
+			     Ts(std::move(_components)),
+			 ...);
+			return entity;
+		}
+
+		/**
+		 * @brief エンティティを破棄する
+		 * 破棄済みのエンティティの場合は何もしない
+		*/
+		void destroy_entity(Entity _entity);
+
+		/**
+		 * @brief エンティティが生存しているか確認する
+		*/
+		bool is_alive(Entity _entity) const noexcept
+		{
+			return _entity.index >= 0 &&
+			       static_cast<size_t>(_entity.index) < m_records.size() &&
+			       m_records[_entity.index].archetype != INVALID_ARCHETYPE &&
+			       m_records[_entity.index].generation == _entity.generation;
+		}
+
+		size_t get_entity_num() const noexcept
+		{
+			return m_entity_num;
+		}
+
+		size_t get_archetype_num() const noexcept
+		{
+			return m_archetypes.size();
+		}
+
+		/**
+		 * @brief コンポーネントを追加する
+		 * 既に持っている場合は値を置き換える
+		 * 組み合わせがチャンクに収まらない場合は std::length_error を投げ、
+		 * エンティティは変更しない
+		 * @return 追加したコンポーネント(別のエンティティを変更するまで有効)
+		*/
+		template<ComponentConcepts T>
+		T& add_component(Entity _entity, T _component = T())
+		{
+			assert(is_alive(_entity));
+			if ( T* component = get_component<T>(_entity) )
+			{
+				*component = std::move(_component);
+				return *component;
+			}
+
+			const size_t id = GetComponentTypeId<T>();
+			move_entity(_entity,
+			            get_entity_mask(_entity) | (ComponentMask(1) << id));
+			return *::new (get_component_pointer(m_records[_entity.index], id))
+			    T(std::move(_component));
+		}
+
+		/**
+		 * @brief コンポーネントを削除する
+		 * 持っていない場合は何もしない
+		*/
+		template<ComponentConcepts T>
+		void remove_component(Entity _entity)
+		{
+			if ( has_component<T>(_entity) )
+			{
+				move_entity(_entity,
+				            get_entity_mask(_entity) & ~GetComponentMask<T>());
+			}
+		}
+
+		template<ComponentConcepts T>
+		bool has_component(Entity _entity) const noexcept
+		{
+			return is_alive(_entity) &&
+			       (get_entity_mask(_entity) & GetComponentMask<T>()) != 0;
+		}
+
+		/**
+		 * @brief コンポーネントを取得する
+		 * @return 持っていない場合はnullptr
+		*/
+		template<ComponentConcepts T>
+		T* get_component(Entity _entity) const noexcept
+		{
+			if ( !is_alive(_entity) )
+			{
+				return nullptr;
+			}
+			return static_cast<T*>(get_component_pointer(
+			    m_records[_entity.index], GetComponentTypeId<T>()));
+		}
+
+		/**
+		 * @brief アクターをエンティティとして登録する
+		 * エンティティは ActorComponent を持ち、アクターの削除時に破棄される
+		 * 登録済みのアクターの場合は登録済みのエンティティを返す
+		*/
+		Entity bridge_actor(bavil::Actor& _actor);
+
+		/**
+		 * @brief 指定したコンポーネントを全て持つエンティティのチャンクを順に呼び出す
+		 * 型にconstを付けたコンポーネントは読み込み専用の配列で渡す
+		 * 呼び出し中にエンティティの生成、破棄、コンポーネントの追加、削除は出来ない
+		 * @param _func void(std::span<const Entity>, std::span<Ts>...)で呼び出す関数
+		*/
+		template<class... Ts, class Func>
+			requires(
+			    std::invocable<Func&, std::span<const Entity>, std::span<Ts>...>)
+		void for_each_chunk(Func&& _func)
+		{
+			visit_chunks<Ts...>(_func);
+		}
+
+		/**
+		 * @brief for_each_chunk() の読み込み専用版
+		 * 型には全てconstを付ける
+		*/
+		template<class... Ts, class Func>
+			requires(
+			    (std::is_const_v<Ts> && ...) &&
+			    std::invocable<Func&, std::span<const Entity>, std::span<Ts>...>)
+		void for_each_chunk(Func&& _func) const
+		{
+			visit_chunks<Ts...>(_func);
+		}
+
+		/**
+		 * @brief 指定したコンポーネントを全て持つエンティティを順に呼び出す
+		 * @param _func void(Ts&...)かvoid(Entity, Ts&...)で呼び出す関数
+		*/
+		template<class... Ts, class Func>
+		void for_each(Func&& _func)
+		{
+			for_each_chunk<Ts...>(
+			    [&](std::span<const Entity> _entities, std::span<Ts>... _components)
+			    { invoke_entities(_func, _entities, _components...); });
+		}
+
+		/**
+		 * @brief for_each() の読み込み専用版
+		 * 型には全てconstを付ける
+		*/
+		template<class... Ts, class Func>
+			requires((std::is_const_v<Ts> && ...))
+		void for_each(Func&& _func) const
+		{
+			for_each_chunk<Ts...>(
+			    [&](std::span<const Entity> _entities, std::span<Ts>... _components)
+			    { invoke_entities(_func, _entities, _components...); });
+		}
+
+		/**
+		 * @brief for_each_chunk() をチャンク毎に TaskSystem のワーカースレッドで
+		 * 並列に呼び出す
+		 * 関数は同時に複数のスレッドから呼ばれるが、同じチャンクは1度だけ渡す
+		*/
+		template<class... Ts, class Func>
+			requires(
+			    std::invocable<Func&, std::span<const Entity>, std::span<Ts>...>)
+		void parallel_for_each_chunk(Func&& _func)
+		{
+			parallel_visit_chunks<Ts...>(_func);
+		}
+
+		/**
+		 * @brief parallel_for_each_chunk() の読み込み専用版
+		 * 型には全てconstを付ける
+		*/
+		template<class... Ts, class Func>
+			requires(
+			    (std::is_const_v<Ts> && ...) &&
+			    std::invocable<Func&, std::span<const Entity>, std::span<Ts>...>)
+		void parallel_for_each_chunk(Func&& _func) const
+		{
+			parallel_visit_chunks<Ts...>(_func);
+		}
+
+		/**
+		 * @brief for_each() をチャンク毎に TaskSystem のワーカースレッドで
+		 * 並列に呼び出す
+		*/
+		template<class... Ts, class Func>
+		void parallel_for_each(Func&& _func)
+		{
+			parallel_for_each_chunk<Ts...>(
+			    [&](std::span<const Entity> _entities, std::span<Ts>... _components)
+			    { invoke_entities(_func, _entities, _components...); });
+		}
+
+		/**
+		 * @brief parallel_for_each() の読み込み専用版
+		 * 型には全てconstを付ける
+		*/
+		template<class... Ts, class Func>
+			requires((std::is_const_v<Ts> && ...))
+		void parallel_for_each(Func&& _func) const
+		{
+			parallel_for_each_chunk<Ts...>(
+			    [&](std::span<const Entity> _entities, std::span<Ts>... _components)
+			    { invoke_entities(_func, _entities, _components...); });
+		}
+
+	private:
+		static constexpr u32 INVALID_ARCHETYPE = static_cast<u32>(-1);
+		static constexpr u32 INVALID_OFFSET    = static_cast<u32>(-1);
+
+		// 型を消したコンポーネントの操作
+		struct ComponentInfo
+		{
+			u32 size      = 0;
+			u32 alignment = 0;
+			// 移動先に構築して移動元を破棄する(nullptrの場合はメモリをコピーする)
+			void (*relocate)(void* _dst, void* _src) = nullptr;
+			// nullptrの場合は破棄が不要
+			void (*destruct)(void* _component) = nullptr;
+		};
+
+		// アーキタイプのチャンク内のコンポーネントの配列
+		struct Column
+		{
+			u32 offset = INVALID_OFFSET;
+			u32 size   = 0;
+		};
+
+		// 同じコンポーネントの組み合わせを持つエンティティの集まり
+		// チャンクの先頭にエンティティの配列、続けて型ID順にコンポーネントの配列を置く
+		struct Archetype
+		{
+			explicit Archetype(std::pmr::memory_resource* _resource)
+			    : component_ids(_resource)
+			    , chunks(_resource)
+			{
+			}
+
+			ComponentMask mask = 0;
+			// 格納するコンポーネントの型ID(昇順)
+			std::pmr::vector<u32> component_ids;
+			// 型IDで引けるコンポーネントの配列
+			std::array<Column, MAX_COMPONENT_TYPE_NUM> columns = {};
+			// 1つのチャンクに格納できるエンティティの数
+			size_t                       chunk_capacity = 0;
+			std::pmr::vector<std::byte*> chunks;
+			size_t                       entity_num = 0;
+
+			size_t get_chunk_entity_num(size_t _chunk) const noexcept
+			{
+				return std::min(entity_num - _chunk * chunk_capacity,
+				                chunk_capacity);
+			}
+
+			Entity* get_entities(size_t _chunk) const noexcept
+			{
+				return reinterpret_cast<Entity*>(chunks[_chunk]);
+			}
+
+			void* get_component(size_t _id, size_t _row) const noexcept
+			{
+				const Column& column = columns[_id];
+				return chunks[_row / chunk_capacity] + column.offset +
+				       (_row % chunk_capacity) * column.size;
+			}
+		};
+
+		struct EntityRecord
+		{
+			u32 archetype  = INVALID_ARCHETYPE;
+			u32 generation = 0;
+			// アーキタイプの先頭のチャンクからの位置
+			size_t row = 0;
+		};
+
+		using ChunkFunction = void (*)(void*            _context,
+		                               const Archetype& _archetype,
+		                               size_t           _chunk);
+
+		template<class T>
+		static constexpr ComponentInfo MakeComponentInfo()
+		{
+			static_assert(alignof(T) <= CHUNK_ALIGNMENT);
+
+			ComponentInfo info;
+			info.size      = sizeof(T);
+			info.alignment = alignof(T);
+			if constexpr ( !std::is_trivially_copyable_v<T> )
+			{
+				info.relocate = [](void* _dst, void* _src)
+				{
+					T* src = static_cast<T*>(_src);
+					::new (_dst) T(std::move(*src));
+					src->~T();
+				};
+			}
+			if constexpr ( !std::is_trivially_destructible_v<T> )
+			{
+				info.destruct = [](void* _component)
+				{ static_cast<T*>(_component)->~T(); };
+			}
+			return info;
+		}
+
+		template<class... Ts, class Func>
+		static void invoke_chunk(const Archetype& _archetype,
+		                         size_t           _chunk,
+		                         Func&            _func)
+		{
+			const size_t num  = _archetype.get_chunk_entity_num(_chunk);
+			std::byte*   data = _archetype.chunks[_chunk];
+			_func(std::span<const Entity>(_archetype.get_entities(_chunk), num),
+			      std::span<Ts>(
+			          reinterpret_cast<Ts*>(
+			              data + _archetype
+			                         .columns[GetComponentTypeId<
+			                             std::remove_const_t<Ts>>()]
+			                         .offset),
+			          num)...);
+		}
+
+		// constの有無は呼び出し側の for_each_chunk() で確認する
+		template<class... Ts, class Func>
+		void visit_chunks(Func& _func) const
+		{
+			const ComponentMask mask =
+			    GetComponentMask<std::remove_const_t<Ts>...>();
+			for ( const Archetype& archetype : m_archetypes )
+			{
+				if ( (archetype.mask & mask) != mask )
+				{
+					continue;
+				}
+				for ( size_t i = 0; i < archetype.chunks.size(); ++i )
+				{
+					invoke_chunk<Ts...>(archetype, i, _func);
+				}
+			}
+		}
+
+		template<class... Ts, class Func>
+		void parallel_visit_chunks(Func& _func) const
+		{
+			parallel_for_each_chunk_internal(
+			    GetComponentMask<std::remove_const_t<Ts>...>(),
+			    const_cast<void*>(static_cast<const void*>(&_func)),
+			    [](void* _context, const Archetype& _archetype, size_t _chunk)
+			    {
+				    invoke_chunk<Ts...>(
+				        _archetype, _chunk, *static_cast<Func*>(_context));
+			    });
+		}
+
+		template<class Func, class... Ts>
+		static void invoke_entities(Func&                   _func,
+		                            std::span<const Entity> _entities,
+		                            std::span<Ts>... _components)
+		{
+			for ( size_t i = 0; i < _entities.size(); ++i )
+			{
+				if constexpr ( std::invocable<Func&, Entity, Ts&...> )
+				{
+					_func(_entities[i], _components[i]...);
+				}
+				else
+				{
+					_func(_components[i]...);
+				}
+			}
+		}
+
+		void* get_component_pointer(const EntityRecord& _record,
+		                            size_t              _id) const noexcept
+		{
+			const Archetype& archetype = m_archetypes[_record.archetype];
+			if ( (archetype.mask & (ComponentMask(1) << _id)) == 0 )
+			{
+				return nullptr;
+			}
+			return archetype.get_component(_id, _record.row);
+		}
+
+		ComponentMask get_entity_mask(Entity _entity) const noexcept
+		{
+			return m_archetypes[m_records[_entity.index].archetype].mask;
+		}
+
+		static size_t GeneratedComponentTypeIdInternal(
+		    const ComponentInfo& _info);
+
+		// 組み合わせが一致するアーキタイプを探し、無ければ作る
+		u32 find_or_create_archetype(ComponentMask _mask);
+
+		// コンポーネントを構築していないエンティティをアーキタイプの末尾に追加する
+		Entity allocate_entity(u32 _archetype);
+		size_t allocate_row(Archetype& _archetype, Entity _entity);
+		// 構築済みのコンポーネントが無い位置に末尾のエンティティを移して詰める
+		void remove_row(Archetype& _archetype, size_t _row);
+		// 組み合わせが異なるアーキタイプへ移す(追加したコンポーネントは構築しない)
+		void move_entity(Entity _entity, ComponentMask _mask);
+
+		std::byte* allocate_chunk();
+
+		void parallel_for_each_chunk_internal(ComponentMask _mask,
+		                                      void*         _context,
+		                                      ChunkFunction _function) const;
+
+	private:
+		// 型IDで引けるコンポーネントの操作(型IDの生成時に1度だけ書き込む)
+		static std::array<ComponentInfo, MAX_COMPONENT_TYPE_NUM>
+		    s_component_infos;
+
+		std::pmr::vector<Archetype>                  m_archetypes;
+		std::pmr::unordered_map<ComponentMask, u32>  m_archetype_ids;
+		std::pmr::vector<EntityRecord>               m_records;
+		std::pmr::vector<int64_t>                    m_free_indices;
+		// 空になったチャンク(全てのアーキタイプで共用する)
+		std::pmr::vector<std::byte*> m_free_chunks;
+		size_t                       m_entity_num = 0;
+	};
+
+} // namespace bavil
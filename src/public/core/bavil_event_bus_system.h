@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "core/bavil_multicast_delegate.h"
+#include "core/bavil_system_manager.h"
+
+namespace bavil
+{
+
+	/**
+	 * @brief 型毎のキューに積んだイベントをまとめて配信するイベントバス
+	 * publish()はどのスレッドからでも呼び出せ、イベントは型毎の連続したキューに積まれる
+	 * dispatch()を呼んだ時点で、型毎にキューの内容を配列として購読者へ一度に渡す
+	 */
+	class EventBusSystem : public bavil::core::SystemBase<EventBusSystem>
+	{
+	public:
+		// 登録できるイベントの型の最大数
+		static constexpr size_t MAX_EVENT_TYPE_NUM = 256;
+
+		virtual void initialize(
+		    bavil::core::SystemManager& _system_manager) override;
+
+		virtual void finalize() override;
+
+		/**
+		 * @brief イベントの型IDを取得する
+		 * 型の数が MAX_EVENT_TYPE_NUM を超えた場合は std::length_error を投げる
+		*/
+		template<class E>
+		static size_t GetEventTypeId()
+		{
+			static const size_t s_id = GeneratedEventTypeIdInternal();
+			return s_id;
+		}
+
+		/**
+		 * @brief イベントを購読する
+		 * @param _func イベントの配列を受け取る関数
+		 * @return 購読を解除する為のハンドル
+		*/
+		template<class E, class Func>
+			requires(std::invocable<Func, std::span<const E>>)
+		DelegateHandle subscribe(Func _func)
+		{
+			return get_channel<E>().handlers.add(std::move(_func));
+		}
+
+		/**
+		 * @brief イベントの購読を解除する
+		*/
+		template<class E>
+		void unsubscribe(DelegateHandle _handle)
+		{
+			get_channel<E>().handlers.remove(_handle);
+		}
+
+		/**
+		 * @brief イベントをキューに積む
+		 * どのスレッドからでも呼び出せる
+		*/
+		template<class E>
+		void publish(E _event)
+		{
+			auto&           channel = get_channel<std::remove_cvref_t<E>>();
+			std::lock_guard lock(channel.mutex);
+			channel.queue.push_back(std::move(_event));
+		}
+
+		/**
+		 * @brief 複数のイベントをまとめてキューに積む
+		 * どのスレッドからでも呼び出せる
+		*/
+		template<class E>
+		void publish_batch(std::span<const E> _events)
+		{
+			auto&           channel = get_channel<std::remove_cv_t<E>>();
+			std::lock_guard lock(channel.mutex);
+			channel.queue.insert(
+			    channel.queue.end(), _events.begin(), _events.end());
+		}
+
+		/**
+		 * @brief 全ての型のイベントを配信する
+		 * 型の登録順に配信し、配信中に積まれたイベントは次の呼び出しで配信する
+		 * 購読者の中から呼び出した場合、配信中の型は配信しない
+		*/
+		void dispatch();
+
+		/**
+		 * @brief 指定した型のイベントを配信する
+		 * 同じ型の購読者の中から呼び出した場合は何もしない
+		*/
+		template<class E>
+		void dispatch()
+		{
+			get_channel<E>().dispatch();
+		}
+
+		/**
+		 * @brief キューに積まれているイベントの数を取得する
+		*/
+		template<class E>
+		size_t get_queued_event_num()
+		{
+			auto&           channel = get_channel<E>();
+			std::lock_guard lock(channel.mutex);
+			return channel.queue.size();
+		}
+
+	private:
+		class EventChannelBase
+		{
+		public:
+			virtual ~EventChannelBase() {}
+
+			virtual void dispatch() = 0;
+		};
+
+		template<class E>
+		class EventChannel : public EventChannelBase
+		{
+		public:
+			explicit EventChannel(std::pmr::memory_resource* _resource)
+			    : queue(_resource)
+			    , dispatching(_resource)
+			{
+			}
+
+			virtual void dispatch() override
+			{
+				// 配信中の dispatch() は何もしない(積まれたイベントは次回に回す)
+				// 入れ替えると配信中の配列がキューに戻ってしまう
+				if ( is_dispatching )
+				{
+					return;
+				}
+
+				{
+					// 配信中も他のスレッドから積める様にキューを入れ替える
+					std::lock_guard lock(mutex);
+					queue.swap(dispatching);
+				}
+
+				if ( !dispatching.empty() )
+				{
+					is_dispatching = true;
+					handlers.broadcast(std::span<const E>(dispatching));
+					dispatching.clear();
+					is_dispatching = false;
+				}
+			}
+
+		public:
+			std::mutex                                    mutex;
+			std::pmr::vector<E>                           queue;
+			std::pmr::vector<E>                           dispatching;
+			bool                                          is_dispatching = false;
+			MulticastDelegate<void(std::span<const E>)> handlers;
+		};
+
+		template<class E>
+		EventChannel<E>& get_channel()
+		{
+			// 型IDは MAX_EVENT_TYPE_NUM 未満であることを発行時に確認している
+			const size_t id = GetEventTypeId<E>();
+
+			EventChannelBase* channel =
+			    m_channels[id].load(std::memory_order_acquire);
+			if ( channel == nullptr )
+			{
+				channel = create_channel(
+				    id,
+				    [](std::pmr::memory_resource* _resource)
+				    {
+					    return std::unique_ptr<EventChannelBase>(
+					        new EventChannel<E>(_resource));
+				    });
+			}
+			return *static_cast<EventChannel<E>*>(channel);
+		}
+
+		using ChannelFactory =
+		    std::unique_ptr<EventChannelBase> (*)(std::pmr::memory_resource*);
+
+		EventChannelBase* create_channel(size_t _id, ChannelFactory _factory);
+
+		static size_t GeneratedEventTypeIdInternal();
+
+	private:
+		// 型IDで引けるチャンネル(ロック無しで参照する)
+		std::array<std::atomic<EventChannelBase*>, MAX_EVENT_TYPE_NUM> m_channels =
+		    {};
+		// 登録順のチャンネル
+		std::vector<std::unique_ptr<EventChannelBase>> m_channel_storage;
+		std::mutex                                     m_channel_mutex;
+	};
+
+} // namespace bavil
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "bavil_type.h"
+#include "core/bavil_linear_arena.h"
+#include "core/bavil_system_manager.h"
+
+namespace bavil
+{
+
+	/**
+	 * @brief フレームアロケータの統計情報
+	 */
+	struct FrameAllocatorStatistics
+	{
+		// 現在のフレームで使用しているバイト数
+		size_t used_bytes = 0;
+		// 確保済みのバッファ容量
+		size_t capacity_bytes = 0;
+		// 1フレームあたりの最大使用量
+		size_t high_water_mark = 0;
+		// 容量を超えてオーバーフローした回数
+		size_t overflow_count = 0;
+	};
+
+	/**
+	 * @brief フレーム単位の一時メモリを提供するシステム
+	 * ダブルバッファのアリーナを持ち、begin_frame()で切り替えてリセットする
+	 * 確保したメモリは次のフレームの終わりまで有効
+	 * 確保したオブジェクトのデストラクタは呼ばれない
+	 */
+	class FrameAllocatorSystem : public bavil::core::SystemBase<FrameAllocatorSystem>
+	{
+	public:
+		static constexpr size_t BUFFER_NUM = 2;
+		// デフォルトのメインアリーナの容量
+		static constexpr size_t DEFAULT_FRAME_CAPACITY = 1024 * 1024;
+		// デフォルトのスレッド毎のアリーナの容量
+		static constexpr size_t DEFAULT_THREAD_CAPACITY = 64 * 1024;
+
+		explicit FrameAllocatorSystem(bavil::core::SystemAllocator& _allocator);
+
+		virtual void initialize(
+		    bavil::core::SystemManager& _system_manager) override;
+
+		virtual void finalize() override;
+
+		/**
+		 * @brief フレームを開始する
+		 * バッファを切り替えて、2フレーム前に確保したメモリを全て開放する
+		 * ワーカースレッドがアリーナを使用していない時に呼ぶ必要がある
+		*/
+		void begin_frame();
+
+		/**
+		 * @brief メインアリーナの容量を設定する
+		 * @param _capacity バッファ1つ当たりの容量
+		*/
+		void set_frame_capacity(size_t _capacity);
+
+		/**
+		 * @brief スレッド毎のアリーナの容量を設定する
+		 * @param _capacity バッファ1つ当たりの容量
+		*/
+		void set_thread_capacity(size_t _capacity);
+
+		/**
+		 * @brief メインアリーナからメモリを確保する
+		 * メインスレッドからのみ呼び出せる
+		*/
+		[[nodiscard]] void* allocate(size_t _size,
+		                             size_t _alignment = alignof(std::max_align_t))
+		{
+			return get_frame_arena().allocate(_size, _alignment);
+		}
+
+		/**
+		 * @brief メインアリーナにオブジェクトを構築する
+		*/
+		template<class T, class... Args>
+			requires(std::is_trivially_destructible_v<T>)
+		[[nodiscard]] T* create(Args&&... _args)
+		{
+			void* memory = allocate(sizeof(T), alignof(T));
+			return ::new (memory) T(std::forward<Args>(_args)...);
+		}
+
+		/**
+		 * @brief メインアリーナに配列を確保する
+		*/
+		template<class T>
+			requires(std::is_trivially_destructible_v<T> &&
+		             std::is_default_constructible_v<T>)
+		[[nodiscard]] std::span<T> allocate_array(size_t _num)
+		{
+			void* memory = allocate(sizeof(T) * _num, alignof(T));
+			T*    result = static_cast<T*>(memory);
+			std::uninitialized_default_construct_n(result, _num);
+			return {result, _num};
+		}
+
+		/**
+		 * @brief 現在のフレームのメインアリーナを取得する
+		*/
+		LinearArena& get_frame_arena() noexcept
+		{
+			return m_frame_arenas[m_current_buffer];
+		}
+
+		/**
+		 * @brief 現在のフレームのメインアリーナのメモリリソースを取得する
+		*/
+		std::pmr::memory_resource* get_memory_resource() noexcept
+		{
+			return &m_frame_resources[m_current_buffer];
+		}
+
+		/**
+		 * @brief 呼び出したスレッド専用のアリーナを取得する
+		 * ワーカースレッドからロック無しで確保する為に使用する
+		*/
+		LinearArena& get_thread_arena();
+
+		/**
+		 * @brief 呼び出したスレッド専用のアリーナのメモリリソースを取得する
+		*/
+		std::pmr::memory_resource* get_thread_memory_resource();
+
+		/**
+		 * @brief メインアリーナの統計情報を取得する
+		*/
+		FrameAllocatorStatistics get_statistics() const;
+
+		/**
+		 * @brief 全スレッドのアリーナの統計情報を合計して取得する
+		*/
+		FrameAllocatorStatistics get_thread_statistics() const;
+
+		/**
+		 * @brief begin_frame()が呼ばれた回数を取得する
+		*/
+		u64 get_frame_count() const noexcept
+		{
+			return m_frame_count;
+		}
+
+	private:
+		struct ThreadArenas
+		{
+			std::thread::id                             thread_id;
+			std::array<LinearArena, BUFFER_NUM>         arenas;
+			std::array<LinearArenaResource, BUFFER_NUM> resources;
+		};
+
+		ThreadArenas& get_thread_arenas();
+
+	private:
+		std::array<LinearArena, BUFFER_NUM>         m_frame_arenas;
+		std::array<LinearArenaResource, BUFFER_NUM> m_frame_resources;
+
+		std::vector<std::unique_ptr<ThreadArenas>> m_thread_arenas;
+		mutable std::mutex                         m_thread_mutex;
+
+		// アリーナのバッファの確保に使用するアロケータ
+		bavil::core::SystemAllocator* m_arena_allocator = nullptr;
+
+		size_t m_thread_capacity = DEFAULT_THREAD_CAPACITY;
+		size_t m_current_buffer  = 0;
+		u64    m_frame_count     = 0;
+		// スレッドローカルのキャッシュを識別する為のID
+		u64 m_instance_id = 0;
+	};
+
+} // namespace bavil
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bavil
+{
+
+	template<class T, size_t Size = 48>
+	class InlineFunction;
+
+	/**
+	 * @brief 呼び出し可能なオブジェクトを内部のバッファに保持する関数オブジェクト
+	 * std::functionと異なりヒープを使用せず、バッファに収まらない場合はコンパイルエラーになる
+	 * コピーは出来ず、ムーブのみ可能
+	 * @tparam Size 内部のバッファのバイト数
+	 */
+	template<class R, class... Args, size_t Size>
+	class InlineFunction<R(Args...), Size>
+	{
+		using InvokeFunction = R (*)(void*, Args&&...);
+		// _src が nullptr の場合は _dst を破棄し、そうでなければ _src から _dst へムーブする
+		using ManageFunction = void (*)(void* _dst, void* _src) noexcept;
+
+	public:
+		static constexpr size_t BUFFER_SIZE      = Size;
+		static constexpr size_t BUFFER_ALIGNMENT = alignof(std::max_align_t);
+
+		InlineFunction() noexcept = default;
+
+		InlineFunction(std::nullptr_t) noexcept {}
+
+		template<class Func>
+			requires(!std::same_as<std::remove_cvref_t<Func>, InlineFunction> &&
+		             std::is_invocable_r_v<R, std::decay_t<Func>&, Args...>)
+		InlineFunction(Func&& _func)
+		{
+			using FunctorType = std::decay_t<Func>;
+
+			static_assert(
+			    sizeof(FunctorType) <= Size,
+			    "InlineFunction: callable is too large for the inline buffer");
+			static_assert(alignof(FunctorType) <= BUFFER_ALIGNMENT,
+			              "InlineFunction: callable is over-aligned");
+			static_assert(
+			    std::is_nothrow_move_constructible_v<FunctorType>,
+			    "InlineFunction: callable must be nothrow move constructible");
+
+			::new (static_cast<void*>(m_buffer))
+			    FunctorType(std::forward<Func>(_func));
+			m_invoke = &Invoke<FunctorType>;
+			// 単純なコピーで済む型は管理関数を持たずにmemcpyで済ませる
+			if constexpr ( !std::is_trivially_copyable_v<FunctorType> )
+			{
+				m_manage = &Manage<FunctorType>;
+			}
+		}
+
+		InlineFunction(InlineFunction&& _other) noexcept
+		{
+			move_from(_other);
+		}
+
+		InlineFunction(const InlineFunction&)            = delete;
+		InlineFunction& operator=(const InlineFunction&) = delete;
+
+		~InlineFunction()
+		{
+			reset();
+		}
+
+		InlineFunction& operator=(InlineFunction&& _other) noexcept
+		{
+			if ( this != &_other )
+			{
+				reset();
+				move_from(_other);
+			}
+			return *this;
+		}
+
+		InlineFunction& operator=(std::nullptr_t) noexcept
+		{
+			reset();
+			return *this;
+		}
+
+		template<class Func>
+			requires(!std::same_as<std::remove_cvref_t<Func>, InlineFunction> &&
+		             std::is_invocable_r_v<R, std::decay_t<Func>&, Args...>)
+		InlineFunction& operator=(Func&& _func)
+		{
+			*this = InlineFunction(std::forward<Func>(_func));
+			return *this;
+		}
+
+		R operator()(Args... _args) const
+		{
+			return m_invoke(const_cast<std::byte*>(m_buffer),
+			                std::forward<Args>(_args)...);
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return m_invoke != nullptr;
+		}
+
+		/**
+		 * @brief 保持している関数を破棄する
+		*/
+		void reset() noexcept
+		{
+			if ( m_manage != nullptr )
+			{
+				m_manage(m_buffer, nullptr);
+			}
+			m_invoke = nullptr;
+			m_manage = nullptr;
+		}
+
+	private:
+		template<class FunctorType>
+		static R Invoke(void* _buffer, Args&&... _args)
+		{
+			return static_cast<R>(
+			    (*static_cast<FunctorType*>(_buffer))(std::forward<Args>(_args)...));
+		}
+
+		template<class FunctorType>
+		static void Manage(void* _dst, void* _src) noexcept
+		{
+			if ( _src == nullptr )
+			{
+				static_cast<FunctorType*>(_dst)->~FunctorType();
+			}
+			else
+			{
+				auto* src = static_cast<FunctorType*>(_src);
+				::new (_dst) FunctorType(std::move(*src));
+				src->~FunctorType();
+			}
+		}
+
+		void move_from(InlineFunction& _other) noexcept
+		{
+			if ( _other.m_invoke == nullptr )
+			{
+				return;
+			}
+
+			if ( _other.m_manage != nullptr )
+			{
+				_other.m_manage(m_buffer, _other.m_buffer);
+			}
+			else
+			{
+				std::memcpy(m_buffer, _other.m_buffer, Size);
+			}
+			m_invoke        = _other.m_invoke;
+			m_manage        = _other.m_manage;
+			_other.m_invoke = nullptr;
+			_other.m_manage = nullptr;
+		}
+
+	private:
+		// デフォルトのサイズではバッファと関数ポインタで64バイトに収まる
+		alignas(BUFFER_ALIGNMENT) std::byte m_buffer[Size];
+		InvokeFunction m_invoke = nullptr;
+		ManageFunction m_manage = nullptr;
+	};
+
+} // namespace bavil
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace bavil
+{
+
+	/**
+	 * @brief 線形(バンプ)アロケータ
+	 * 確保はポインタを進めるだけで、個別の解放は行わずreset()でまとめて開放する
+	 * 容量を超えた確保はオーバーフローブロックから行い、次のreset()で
+	 * 本体のバッファを最大使用量まで拡張する為、定常状態ではヒープを使用しない
+	 */
+	class LinearArena
+	{
+	public:
+		LinearArena() noexcept = default;
+		explicit LinearArena(size_t                     _capacity,
+		                     std::pmr::memory_resource* _upstream =
+		                         std::pmr::new_delete_resource());
+		~LinearArena();
+
+		LinearArena(const LinearArena&)            = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		/**
+		 * @brief メモリを確保する
+		 * @param _size 確保するサイズ
+		 * @param _alignment アライメント(2の累乗)
+		 * @return 確保したメモリの先頭
+		*/
+		[[nodiscard]] void* allocate(
+		    size_t _size,
+		    size_t _alignment = alignof(std::max_align_t));
+
+		/**
+		 * @brief 確保したメモリを全て開放する
+		 * オーバーフローが発生していた場合は本体のバッファを拡張する
+		*/
+		void reset();
+
+		/**
+		 * @brief 本体のバッファの容量を確保する
+		 * @param _capacity 容量
+		*/
+		void reserve(size_t _capacity);
+
+		/**
+		 * @brief バッファの確保に使用するメモリリソースを設定する
+		 * バッファを確保する前に設定する必要がある
+		*/
+		void set_upstream(std::pmr::memory_resource* _upstream) noexcept
+		{
+			m_upstream = _upstream;
+		}
+
+		/**
+		 * @brief 現在使用しているバイト数を取得する
+		*/
+		size_t get_used_bytes() const noexcept
+		{
+			return m_offset + m_overflow_used_bytes;
+		}
+
+		/**
+		 * @brief 本体のバッファの容量を取得する
+		*/
+		size_t get_capacity() const noexcept
+		{
+			return m_capacity;
+		}
+
+		/**
+		 * @brief reset()間での最大使用量を取得する
+		*/
+		size_t get_high_water_mark() const noexcept
+		{
+			const size_t used = get_used_bytes();
+			return used > m_high_water_mark ? used : m_high_water_mark;
+		}
+
+		/**
+		 * @brief 容量が足りずにオーバーフローブロックを確保した回数を取得する
+		*/
+		size_t get_overflow_count() const noexcept
+		{
+			return m_overflow_count;
+		}
+
+	private:
+		struct Block
+		{
+			std::byte* data = nullptr;
+			size_t     size = 0;
+		};
+
+		void* allocate_overflow(size_t _size, size_t _alignment);
+		void  release_overflow_blocks();
+
+	private:
+		std::pmr::memory_resource* m_upstream = std::pmr::new_delete_resource();
+		std::byte*                 m_buffer   = nullptr;
+		size_t                     m_capacity = 0;
+		size_t                     m_offset   = 0;
+
+		// 容量を超えた時に使用するブロック
+		std::vector<Block> m_overflow_blocks;
+		size_t             m_overflow_block_used = 0;
+		size_t             m_overflow_used_bytes = 0;
+		size_t             m_high_water_mark     = 0;
+		size_t             m_overflow_count      = 0;
+	};
+
+	/**
+	 * @brief LinearArenaをstd::pmr::memory_resourceとして扱うアダプタ
+	 * deallocateは何もせず、アリーナのreset()でまとめて開放される
+	 */
+	class LinearArenaResource : public std::pmr::memory_resource
+	{
+	public:
+		LinearArenaResource() noexcept = default;
+		explicit LinearArenaResource(LinearArena* _arena) noexcept
+		    : m_arena(_arena)
+		{
+		}
+
+		LinearArena* get_arena() const noexcept
+		{
+			return m_arena;
+		}
+
+	private:
+		virtual void* do_allocate(size_t _bytes, size_t _alignment) override
+		{
+			return m_arena->allocate(_bytes, _alignment);
+		}
+
+		virtual void do_deallocate(void*  _p,
+		                           size_t _bytes,
+		                           size_t _alignment) override
+		{
+			// 個別の解放は行わない
+			static_cast<void>(_p);
+			static_cast<void>(_bytes);
+			static_cast<void>(_alignment);
+		}
+
+		virtual bool do_is_equal(
+		    const std::pmr::memory_resource& _other) const noexcept override
+		{
+			return this == &_other;
+		}
+
+	private:
+		LinearArena* m_arena = nullptr;
+	};
+
+} // namespace bavil
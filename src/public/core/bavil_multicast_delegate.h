@@ -1,38 +1,77 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
-#include <unordered_map>
+#include <vector>
 #include <type_traits>
 #include <concepts>
 #include <compare>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+
+#include "core/bavil_inline_function.h"
+#include "core/bavil_object_handle.h"
 
 namespace bavil
 {
 	/**
 	 * デリゲートハンドル
+	 * 登録したデリゲート毎のスロット番号と世代で構成され、ハンドルの発行に共有の状態を持たない
+	 * 削除済みのデリゲートを指すハンドルは世代が一致しないので無効になる
 	 */
 	struct DelegateHandle
 	{
-		size_t handle;
+		static constexpr uint32_t INVALID_INDEX =
+		    std::numeric_limits<uint32_t>::max();
 
-		static DelegateHandle Generated() noexcept
-		{
-			static size_t s_id = 0;
-			return {++s_id};
-		}
+		uint32_t index      = INVALID_INDEX;
+		uint32_t generation = 0;
 
-		constexpr DelegateHandle(size_t _handle) noexcept
-		    : handle(_handle)
-		{
-		}
-		constexpr DelegateHandle() noexcept
-		    : DelegateHandle(0)
+		constexpr bool is_valid() const noexcept
 		{
+			return index != INVALID_INDEX;
 		}
 
 		auto operator<=>(const DelegateHandle&) const = default;
 	};
 
+	/**
+	 * デリゲートの登録時に指定するフラグ
+	 */
+	enum class DelegateFlags : uint8_t
+	{
+		None = 0,
+		// 複数のスレッドから同時に呼び出しても良い(broadcast_parallel()で並列に呼び出す)
+		ThreadSafe = 1 << 0,
+	};
+
+	constexpr DelegateFlags operator|(DelegateFlags _lhs,
+	                                  DelegateFlags _rhs) noexcept
+	{
+		return static_cast<DelegateFlags>(static_cast<uint8_t>(_lhs) |
+		                                  static_cast<uint8_t>(_rhs));
+	}
+
+	constexpr bool has_flag(DelegateFlags _flags, DelegateFlags _flag) noexcept
+	{
+		return (static_cast<uint8_t>(_flags) & static_cast<uint8_t>(_flag)) != 0;
+	}
+
+	/**
+	 * @brief broadcast_parallel() から TaskSystem::parallel_for() を呼び出す
+	 * TaskSystem のヘッダーを含めなくて済む様に、実装はソースファイルに置く
+	 * カレントコンテキストが無い場合は呼び出したスレッドで全ての範囲を実行する
+	*/
+	void ParallelBroadcastInternal(size_t _count,
+	                               size_t _min_chunk_size,
+	                               void*  _context,
+	                               void (*_function)(void*  _context,
+	                                                 size_t _begin,
+	                                                 size_t _end));
+
 } // namespace bavil
 
 namespace std
@@ -42,7 +81,9 @@ namespace std
 	{
 		size_t operator()(const bavil::DelegateHandle& _handle) const
 		{
-			return std::hash<size_t>()(_handle.handle);
+			const uint64_t value =
+			    (uint64_t(_handle.generation) << 32) | uint64_t(_handle.index);
+			return std::hash<uint64_t>()(value);
 		}
 	};
 } // namespace std
@@ -50,62 +91,410 @@ namespace std
 namespace bavil
 {
 
+	/**
+	 * @brief flush() で引数の配列をまとめて受け取る関数オブジェクト
+	 * これを保持するデリゲート自身は queue() / flush() を持たない
+	 * @tparam Payload queue() で積む引数の組
+	 */
+	template<class Payload>
+	struct BatchFunction : std::function<void(std::span<const Payload>)>
+	{
+		using std::function<void(std::span<const Payload>)>::function;
+	};
+
 	template<class T>
+	inline constexpr bool IsBatchFunction = false;
+
+	template<class Payload>
+	inline constexpr bool IsBatchFunction<BatchFunction<Payload>> = true;
+
+	/**
+	 * @brief マルチキャストデリゲート
+	 * 戻り値を bool にした場合、trueを返したデリゲートで以降の呼び出しを止める
+	 * @tparam T 関数の型(戻り値は void か bool)
+	 * @tparam FunctionType デリゲートを保持する関数オブジェクトの型
+	 */
+	template<class T, class FunctionType = std::function<T>>
 	class MulticastDelegate;
 
-	template<class... Args>
-	class MulticastDelegate<void(Args...)>
+	template<class R, class... Args, class FunctionType>
+	class MulticastDelegate<R(Args...), FunctionType>
 	{
-		using FunctionType = std::function<void(Args...)>;
+		static_assert(std::is_void_v<R> || std::same_as<R, bool>,
+		              "MulticastDelegate: return type must be void or bool");
+
+		// デリゲートが以降の呼び出しを止められるか
+		static constexpr bool CAN_CONSUME = std::same_as<R, bool>;
 
 	public:
+		// broadcast() の戻り値(bool の場合は呼び出しが止められたか)
+		using BroadcastResult = R;
+		// デフォルトの呼び出し優先度
+		static constexpr int32_t DEFAULT_PRIORITY = 0;
+
+		// queue() で積む引数の組
+		using Payload = std::tuple<std::decay_t<Args>...>;
+		// flush() でまとめて受け取るデリゲートの型
+		using BatchDelegate = MulticastDelegate<void(std::span<const Payload>),
+		                                        BatchFunction<Payload>>;
+
 		/**
 	 * @brief デリゲートを登録する
+	 * 優先度の高い順に呼び出し、同じ優先度の場合は登録した順に呼び出す
+	 * (broadcast_parallel() では同じ優先度の中の順番は保証しない)
+	 * ブロードキャスト中に登録した場合は、一番外側のブロードキャストが終わってから呼び出し対象になる
 	 * @tparam Func デリゲート型
 	 * @param func デリゲート
+	 * @param _priority 呼び出しの優先度
+	 * @param _flags デリゲートの性質を表すフラグ
 	 * @return 
 	*/
 		template<class Func>
 			requires(std::constructible_from<FunctionType, Func>)
-		DelegateHandle add(Func func)
+		DelegateHandle add(Func          func,
+		                   int32_t       _priority = DEFAULT_PRIORITY,
+		                   DelegateFlags _flags    = DelegateFlags::None)
+		{
+			const uint32_t slot_index = allocate_slot();
+			Slot&          slot       = m_slots[slot_index];
+
+			if ( m_broadcast_depth > 0 )
+			{
+				slot.position =
+				    static_cast<uint32_t>(m_pending_functions.size()) | PENDING_FLAG;
+				m_pending_functions.emplace_back(std::move(func));
+				m_pending_slots.push_back(slot_index);
+				m_pending_priorities.push_back(_priority);
+				m_pending_flags.push_back(_flags);
+			}
+			else
+			{
+				insert_function(
+				    FunctionType(std::move(func)), slot_index, _priority, _flags);
+			}
+			m_delegate_num++;
+
+			return {slot_index, slot.generation};
+		}
+
+		template<class Func>
+			requires(std::constructible_from<FunctionType, Func>)
+		DelegateHandle add(Func func, DelegateFlags _flags)
+		{
+			return add(std::move(func), DEFAULT_PRIORITY, _flags);
+		}
+
+		/**
+	 * @brief オブジェクトのメンバ関数を登録する
+	 * オブジェクトのポインタのみを保持してメンバ関数を直接呼び出す
+	 * オブジェクトの参照数は増やさず、オブジェクトが破棄されたら自動で削除する
+	 * @tparam Method メンバ関数のポインタ
+	 * @param _object オブジェクトのハンドル
+	 * @param _priority 呼び出しの優先度
+	 * @return 
+	*/
+		template<auto Method, ObjectConcepts T>
+			requires(std::is_invocable_r_v<R, decltype(Method), T*, Args...>)
+		DelegateHandle add_member(const ObjectHandle<T>& _object,
+		                          int32_t _priority = DEFAULT_PRIORITY)
 		{
-			DelegateHandle handle = DelegateHandle::Generated();
+			T* object = _object.get_object();
+			if ( object == nullptr )
+			{
+				return {};
+			}
 
-			m_events.emplace(handle, FunctionType(func));
-			// m_events
+			DelegateHandle handle =
+			    add(MemberFunction<Method, T>{object}, _priority);
+			m_object_bindings.push_back({handle, _object.get_binding()});
+			// 次のブロードキャストで生存確認を行う
+			m_binding_serial = INVALID_SERIAL;
 
 			return handle;
 		}
 
+		/**
+	 * @brief queue() で積んだ引数の配列をまとめて受け取るデリゲートを登録する
+	 * flush() の時に一度だけ呼ばれ、broadcast() では呼ばれない
+	 * @param func 引数の配列を受け取るデリゲート
+	 * @return 
+	*/
+		template<class Func>
+			requires(!IsBatchFunction<FunctionType> &&
+		         std::invocable<Func, std::span<const Payload>>)
+		DelegateHandle add_batch(Func func)
+		{
+			if ( m_batch_delegate == nullptr )
+			{
+				m_batch_delegate = std::make_unique<BatchDelegate>();
+			}
+			DelegateHandle handle = m_batch_delegate->add(std::move(func));
+			handle.index |= BATCH_HANDLE_FLAG;
+			return handle;
+		}
+
 		/**
 	 * @brief デリゲートを削除する
+	 * 残りのデリゲートの呼び出し順は保持する
+	 * ブロードキャスト中は削除済みの印だけ付けて、以降の呼び出しから外す
 	 * @param _handle ハンドルの型
 	*/
 		void remove(DelegateHandle _handle)
 		{
-			m_events.erase(_handle);
+			if constexpr ( !IsBatchFunction<FunctionType> )
+			{
+				if ( is_batch_handle(_handle) )
+				{
+					if ( m_batch_delegate != nullptr )
+					{
+						m_batch_delegate->remove(to_batch_handle(_handle));
+					}
+					return;
+				}
+			}
+
+			for ( size_t i = 0; i < m_object_bindings.size(); ++i )
+			{
+				if ( m_object_bindings[i].handle == _handle )
+				{
+					m_object_bindings[i] = m_object_bindings.back();
+					m_object_bindings.pop_back();
+					break;
+				}
+			}
+			remove_internal(_handle);
 		}
 
 		bool is_valid(DelegateHandle _handle) const
 		{
-			auto result = m_events.find(_handle);
-			return result != m_events.end();
+			if constexpr ( !IsBatchFunction<FunctionType> )
+			{
+				if ( is_batch_handle(_handle) )
+				{
+					return m_batch_delegate != nullptr &&
+					       m_batch_delegate->is_valid(to_batch_handle(_handle));
+				}
+			}
+			return find_slot(_handle) != nullptr;
 		}
 
 		bool has_delegates() const
 		{
-			return !m_events.empty();
+			return get_delegate_num() > 0;
+		}
+
+		/**
+	 * @brief 登録されているデリゲートの数を取得する
+	*/
+		size_t get_delegate_num() const
+		{
+			if constexpr ( !IsBatchFunction<FunctionType> )
+			{
+				if ( m_batch_delegate != nullptr )
+				{
+					return m_delegate_num + m_batch_delegate->get_delegate_num();
+				}
+			}
+			return m_delegate_num;
+		}
+
+		/**
+	 * @brief 引数を積んでおき、flush() でまとめて呼び出す
+	 * 積んだ引数は連続したバッファに保持し、バッファは flush() の後も再利用する
+	 * @param ...args 
+	*/
+		void queue(Args... args)
+			requires(!IsBatchFunction<FunctionType> &&
+		         std::invocable<FunctionType&, const std::decay_t<Args>&...>)
+		{
+			m_queued_payloads.emplace_back(args...);
+		}
+
+		/**
+	 * @brief 積まれている引数の数を取得する
+	*/
+		size_t get_queued_num() const
+			requires(!IsBatchFunction<FunctionType>)
+		{
+			return m_queued_payloads.size();
+		}
+
+		/**
+	 * @brief queue() で積んだ引数でまとめて呼び出す
+	 * デリゲート毎に積まれた全ての引数で続けて呼び出し、add_batch() で登録した
+	 * デリゲートには引数の配列を一度で渡す
+	 * 呼び出し中に queue() した引数は次の flush() で呼び出す
+	 * 戻り値が bool の場合でも呼び出しは止めない
+	*/
+		void flush()
+			requires(!IsBatchFunction<FunctionType> &&
+		         std::invocable<FunctionType&, const std::decay_t<Args>&...>)
+		{
+			// 呼び出し中の flush() は何もしない(積まれた引数は次回に回す)
+			if ( m_is_flushing || m_queued_payloads.empty() )
+			{
+				return;
+			}
+
+			FlushScope flush_scope(*this);
+			{
+				BroadcastScope scope(*this);
+				prune_object_bindings();
+
+				const size_t function_num = m_functions.size();
+				for ( size_t i = 0; i < function_num; ++i )
+				{
+					if ( m_function_slots[i] == REMOVED_SLOT )
+					{
+						continue;
+					}
+					// 呼び出し中にオブジェクトが破棄、削除される場合があるので、
+					// 引数毎に確認して残りの引数では呼び出さない
+					for ( const Payload& payload : m_flushing_payloads )
+					{
+						std::apply(m_functions[i], payload);
+						prune_object_bindings();
+						if ( m_function_slots[i] == REMOVED_SLOT )
+						{
+							break;
+						}
+					}
+				}
+			}
+
+			if ( m_batch_delegate != nullptr )
+			{
+				m_batch_delegate->broadcast(
+				    std::span<const Payload>(m_flushing_payloads));
+			}
+		}
+
+		/**
+	 * @brief 積んだ引数を呼び出さずに破棄する
+	*/
+		void clear_queue()
+			requires(!IsBatchFunction<FunctionType>)
+		{
+			m_queued_payloads.clear();
 		}
 
 		/**
 	 * @brief イベントの呼び出し
+	 * 全てのデリゲートに同じ引数を渡すので、引数はムーブしない
+	 * デリゲートの中から登録、削除、ブロードキャストを行うことが出来る
 	 * @param ...args 
+	 * @return 戻り値が bool の場合、呼び出しが止められたらtrue
 	*/
-		void broadcast(Args... args)
+		BroadcastResult broadcast(Args... args)
 		{
-			for ( auto& [handle, target] : m_events )
+			BroadcastScope scope(*this);
+
+			// 登録はブロードキャスト後に反映されるので、ここで数が変わることはない
+			const size_t function_num = m_functions.size();
+
+			if ( m_object_bindings.empty() )
+			{
+				for ( size_t i = 0; i < function_num; ++i )
+				{
+					if ( m_function_slots[i] != REMOVED_SLOT &&
+					     invoke_function(i, args...) )
+					{
+						return static_cast<BroadcastResult>(true);
+					}
+				}
+				return static_cast<BroadcastResult>(false);
+			}
+
+			// デリゲートの中でオブジェクトが破棄される場合があるので、呼び出し毎に確認する
+			prune_object_bindings();
+			for ( size_t i = 0; i < function_num; ++i )
+			{
+				if ( m_function_slots[i] != REMOVED_SLOT )
+				{
+					const bool is_consumed = invoke_function(i, args...);
+					prune_object_bindings();
+					if ( is_consumed )
+					{
+						return static_cast<BroadcastResult>(true);
+					}
+				}
+			}
+			return static_cast<BroadcastResult>(false);
+		}
+
+		/**
+	 * @brief スレッドセーフなデリゲートを TaskSystem のワーカースレッドで並列に呼び出す
+	 * 優先度の同じデリゲート毎に、優先度の高い順に呼び出す
+	 * 同じ優先度の中では DelegateFlags::ThreadSafe を付けたデリゲートを並列に
+	 * 呼び出した後で、付けずに登録したデリゲートを呼び出したスレッドから順に呼び出す
+	 * DelegateFlags::ThreadSafe を付けた登録数が少ない場合は broadcast() と同じく
+	 * 全て呼び出したスレッドで呼び出す
+	 * 並列に呼び出すデリゲートの中からこのデリゲートの登録、削除は出来ない
+	 * 戻り値が void の場合のみ使用できる
+	 * @param ...args 
+	*/
+		void broadcast_parallel(Args... args)
+			requires(std::is_void_v<R>)
+		{
+			// 並列に呼び出せるデリゲートが少ない場合は分ける手間の方が大きい
+			const size_t thread_safe_num = std::count_if(
+			    m_function_flags.begin(),
+			    m_function_flags.end(),
+			    [](DelegateFlags _flags)
+			    { return has_flag(_flags, DelegateFlags::ThreadSafe); });
+			if ( thread_safe_num < PARALLEL_BROADCAST_MIN_NUM )
+			{
+				broadcast(args...);
+				return;
+			}
+
+			BroadcastScope scope(*this);
+			prune_object_bindings();
+
+			const size_t function_num = m_functions.size();
+
+			// 優先度の順に並んでいるので、同じ優先度の範囲毎に呼び出しを終えてから進む
+			for ( size_t begin = 0; begin < function_num; )
 			{
-				target(std::move(args)...);
+				const size_t end =
+				    std::upper_bound(m_function_priorities.begin() + begin,
+				                     m_function_priorities.begin() + function_num,
+				                     m_function_priorities[begin],
+				                     std::greater<>()) -
+				    m_function_priorities.begin();
+
+				const auto call_range = [&](size_t _begin, size_t _end)
+				{
+					for ( size_t i = begin + _begin; i < begin + _end; ++i )
+					{
+						if ( m_function_slots[i] != REMOVED_SLOT &&
+						     has_flag(m_function_flags[i],
+						              DelegateFlags::ThreadSafe) )
+						{
+							m_functions[i](args...);
+						}
+					}
+				};
+				ParallelBroadcastInternal(
+				    end - begin,
+				    PARALLEL_BROADCAST_CHUNK_SIZE,
+				    const_cast<void*>(static_cast<const void*>(&call_range)),
+				    [](void* _context, size_t _begin, size_t _end)
+				    {
+					    (*static_cast<decltype(call_range)*>(_context))(_begin,
+					                                                    _end);
+				    });
+
+				for ( size_t i = begin; i < end; ++i )
+				{
+					if ( m_function_slots[i] != REMOVED_SLOT &&
+					     !has_flag(m_function_flags[i], DelegateFlags::ThreadSafe) )
+					{
+						m_functions[i](args...);
+						prune_object_bindings();
+					}
+				}
+				begin = end;
 			}
 		}
 
@@ -114,11 +503,393 @@ namespace bavil
 	*/
 		void clear()
 		{
-			m_events.clear();
+			m_object_bindings.clear();
+			if constexpr ( !IsBatchFunction<FunctionType> )
+			{
+				if ( m_batch_delegate != nullptr )
+				{
+					m_batch_delegate->clear();
+				}
+			}
+
+			for ( uint32_t i = 0; i < m_slots.size(); ++i )
+			{
+				if ( m_slots[i].position != FREE_POSITION )
+				{
+					free_slot(i);
+				}
+			}
+			m_delegate_num = 0;
+
+			if ( m_broadcast_depth > 0 )
+			{
+				for ( uint32_t& slot_index : m_function_slots )
+				{
+					slot_index = REMOVED_SLOT;
+				}
+				for ( uint32_t& slot_index : m_pending_slots )
+				{
+					slot_index = REMOVED_SLOT;
+				}
+				m_removed_num = m_functions.size();
+				return;
+			}
+
+			m_functions.clear();
+			m_function_slots.clear();
+			m_function_priorities.clear();
+			m_function_flags.clear();
 		}
 
 	private:
-		std::unordered_map<DelegateHandle, FunctionType> m_events;
+		// 保留中の登録を指す位置の印
+		static constexpr uint32_t PENDING_FLAG = 1u << 31;
+		// add_batch() で登録したデリゲートのハンドルの印
+		static constexpr uint32_t BATCH_HANDLE_FLAG = 1u << 31;
+		// 未使用のスロットの位置
+		static constexpr uint32_t FREE_POSITION =
+		    std::numeric_limits<uint32_t>::max();
+		// 削除済みの要素のスロット番号
+		static constexpr uint32_t REMOVED_SLOT =
+		    std::numeric_limits<uint32_t>::max();
+		// broadcast_parallel() で並列に呼び出す DelegateFlags::ThreadSafe の最小の登録数
+		static constexpr size_t PARALLEL_BROADCAST_MIN_NUM = 256;
+		// broadcast_parallel() で1回に呼び出す最小の数
+		static constexpr size_t PARALLEL_BROADCAST_CHUNK_SIZE = 64;
+		// 生存確認を強制する為の値
+		static constexpr uint64_t INVALID_SERIAL =
+		    std::numeric_limits<uint64_t>::max();
+
+		// ハンドルの指す先
+		struct Slot
+		{
+			uint32_t generation = 0;
+			// 関数の配列の位置(保留中の場合は PENDING_FLAG 付き)
+			uint32_t position = FREE_POSITION;
+		};
+
+		// メンバ関数を直接呼び出す関数オブジェクト
+		template<auto Method, class T>
+		struct MemberFunction
+		{
+			T* object;
+
+			R operator()(Args... args) const
+			{
+				return std::invoke(Method, object, args...);
+			}
+		};
+
+		// オブジェクトに紐付いたデリゲート
+		struct ObjectBindingEntry
+		{
+			DelegateHandle handle;
+			ObjectBinding  binding;
+		};
+
+		static constexpr bool is_batch_handle(DelegateHandle _handle) noexcept
+		{
+			return _handle.is_valid() && (_handle.index & BATCH_HANDLE_FLAG) != 0;
+		}
+
+		static constexpr DelegateHandle to_batch_handle(
+		    DelegateHandle _handle) noexcept
+		{
+			return {_handle.index & ~BATCH_HANDLE_FLAG, _handle.generation};
+		}
+
+		// 優先度の順番を保つ位置に挿入する
+		void insert_function(FunctionType&& _function,
+		                     uint32_t       _slot_index,
+		                     int32_t        _priority,
+		                     DelegateFlags  _flags)
+		{
+			// 同じ優先度の中では末尾に入れるので、大抵は末尾への追加で済む
+			if ( m_function_priorities.empty() ||
+			     m_function_priorities.back() >= _priority )
+			{
+				m_slots[_slot_index].position =
+				    static_cast<uint32_t>(m_functions.size());
+				m_functions.push_back(std::move(_function));
+				m_function_slots.push_back(_slot_index);
+				m_function_priorities.push_back(_priority);
+				m_function_flags.push_back(_flags);
+				return;
+			}
+
+			const size_t position =
+			    std::upper_bound(m_function_priorities.begin(),
+			                     m_function_priorities.end(),
+			                     _priority,
+			                     std::greater<>()) -
+			    m_function_priorities.begin();
+
+			m_functions.insert(m_functions.begin() + position, std::move(_function));
+			m_function_slots.insert(m_function_slots.begin() + position,
+			                        _slot_index);
+			m_function_priorities.insert(m_function_priorities.begin() + position,
+			                             _priority);
+			m_function_flags.insert(m_function_flags.begin() + position, _flags);
+			for ( size_t i = position; i < m_function_slots.size(); ++i )
+			{
+				m_slots[m_function_slots[i]].position = static_cast<uint32_t>(i);
+			}
+		}
+
+		// デリゲートを呼び出し、以降の呼び出しを止める場合はtrueを返す
+		bool invoke_function(size_t _index, Args&... args)
+		{
+			if constexpr ( CAN_CONSUME )
+			{
+				return m_functions[_index](args...);
+			}
+			else
+			{
+				m_functions[_index](args...);
+				return false;
+			}
+		}
+
+		uint32_t allocate_slot()
+		{
+			if ( !m_free_slots.empty() )
+			{
+				const uint32_t slot_index = m_free_slots.back();
+				m_free_slots.pop_back();
+				return slot_index;
+			}
+			m_slots.emplace_back();
+			return static_cast<uint32_t>(m_slots.size() - 1);
+		}
+
+		void free_slot(uint32_t _slot_index)
+		{
+			Slot& slot    = m_slots[_slot_index];
+			slot.position = FREE_POSITION;
+			slot.generation++;
+			m_free_slots.push_back(_slot_index);
+		}
+
+		const Slot* find_slot(DelegateHandle _handle) const
+		{
+			if ( _handle.index >= m_slots.size() )
+			{
+				return nullptr;
+			}
+			const Slot& slot = m_slots[_handle.index];
+			if ( slot.generation != _handle.generation ||
+			     slot.position == FREE_POSITION )
+			{
+				return nullptr;
+			}
+			return &slot;
+		}
+
+		void remove_internal(DelegateHandle _handle)
+		{
+			const Slot* slot = find_slot(_handle);
+			if ( slot == nullptr )
+			{
+				return;
+			}
+
+			const uint32_t position = slot->position;
+			free_slot(_handle.index);
+			m_delegate_num--;
+
+			if ( (position & PENDING_FLAG) != 0 )
+			{
+				m_pending_slots[position & ~PENDING_FLAG] = REMOVED_SLOT;
+				return;
+			}
+
+			if ( m_broadcast_depth > 0 )
+			{
+				// 呼び出し中の関数を破棄しない様に、実体はブロードキャストの後で削除する
+				m_function_slots[position] = REMOVED_SLOT;
+				m_removed_num++;
+				return;
+			}
+
+			// 優先度の順番を保つ為に後ろの要素を詰める
+			m_functions.erase(m_functions.begin() + position);
+			m_function_slots.erase(m_function_slots.begin() + position);
+			m_function_priorities.erase(m_function_priorities.begin() + position);
+			m_function_flags.erase(m_function_flags.begin() + position);
+			for ( size_t i = position; i < m_function_slots.size(); ++i )
+			{
+				m_slots[m_function_slots[i]].position = static_cast<uint32_t>(i);
+			}
+		}
+
+		// 破棄されたオブジェクトに紐付いたデリゲートをまとめて削除する
+		void prune_object_bindings()
+		{
+			// 前回の確認からオブジェクトが破棄されていなければ何もしない
+			const uint64_t serial = ObjectBinding::GetDestroySerial();
+			if ( m_object_bindings.empty() || m_binding_serial == serial )
+			{
+				return;
+			}
+			m_binding_serial = serial;
+
+			for ( size_t i = 0; i < m_object_bindings.size(); )
+			{
+				if ( m_object_bindings[i].binding.is_alive() )
+				{
+					++i;
+					continue;
+				}
+
+				const DelegateHandle handle = m_object_bindings[i].handle;
+				m_object_bindings[i]        = m_object_bindings.back();
+				m_object_bindings.pop_back();
+				remove_internal(handle);
+			}
+		}
+
+		// 一番外側のブロードキャストが終わった時に保留中の変更を反映する
+		struct BroadcastScope
+		{
+			explicit BroadcastScope(MulticastDelegate& _delegate) noexcept
+			    : delegate(_delegate)
+			{
+				delegate.m_broadcast_depth++;
+			}
+
+			~BroadcastScope()
+			{
+				if ( --delegate.m_broadcast_depth == 0 && delegate.has_pending() )
+				{
+					delegate.apply_pending();
+				}
+			}
+
+			MulticastDelegate& delegate;
+		};
+
+		// flush() で積まれた引数を取り出し、抜ける時に(例外でも)片付ける
+		struct FlushScope
+		{
+			explicit FlushScope(MulticastDelegate& _delegate) noexcept
+			    : delegate(_delegate)
+			{
+				delegate.m_is_flushing = true;
+				delegate.m_flushing_payloads.swap(delegate.m_queued_payloads);
+			}
+
+			~FlushScope()
+			{
+				delegate.m_flushing_payloads.clear();
+				delegate.m_is_flushing = false;
+			}
+
+			MulticastDelegate& delegate;
+		};
+
+		bool has_pending() const noexcept
+		{
+			return m_removed_num > 0 || !m_pending_slots.empty();
+		}
+
+		void apply_pending()
+		{
+			if ( m_removed_num > 0 )
+			{
+				// 削除済みの要素を詰める(残りの要素の順番は保持する)
+				uint32_t count = 0;
+				for ( size_t i = 0; i < m_functions.size(); ++i )
+				{
+					const uint32_t slot_index = m_function_slots[i];
+					if ( slot_index == REMOVED_SLOT )
+					{
+						continue;
+					}
+					if ( count != i )
+					{
+						m_functions[count]           = std::move(m_functions[i]);
+						m_function_slots[count]      = slot_index;
+						m_function_priorities[count] = m_function_priorities[i];
+						m_function_flags[count]      = m_function_flags[i];
+						m_slots[slot_index].position = count;
+					}
+					count++;
+				}
+				m_functions.erase(m_functions.begin() + count, m_functions.end());
+				m_function_slots.erase(m_function_slots.begin() + count,
+				                       m_function_slots.end());
+				m_function_priorities.erase(m_function_priorities.begin() + count,
+				                            m_function_priorities.end());
+				m_function_flags.erase(m_function_flags.begin() + count,
+				                       m_function_flags.end());
+				m_removed_num = 0;
+			}
+
+			for ( size_t i = 0; i < m_pending_functions.size(); ++i )
+			{
+				const uint32_t slot_index = m_pending_slots[i];
+				if ( slot_index == REMOVED_SLOT )
+				{
+					continue;
+				}
+				insert_function(std::move(m_pending_functions[i]),
+				                slot_index,
+				                m_pending_priorities[i],
+				                m_pending_flags[i]);
+			}
+			m_pending_functions.clear();
+			m_pending_slots.clear();
+			m_pending_priorities.clear();
+			m_pending_flags.clear();
+		}
+
+	private:
+		// 呼び出しは連続した配列を先頭から順に辿る
+		// 各要素のスロット番号を持ち、削除済みの要素は REMOVED_SLOT にしておく
+		// 優先度の高い順に並べておく
+		std::vector<FunctionType>  m_functions;
+		std::vector<uint32_t>      m_function_slots;
+		std::vector<int32_t>       m_function_priorities;
+		std::vector<DelegateFlags> m_function_flags;
+
+		// ハンドルのスロット番号から配列の位置を引く
+		std::vector<Slot>     m_slots;
+		std::vector<uint32_t> m_free_slots;
+		size_t                m_delegate_num = 0;
+
+		// ブロードキャスト中に登録されたデリゲート
+		std::vector<FunctionType>  m_pending_functions;
+		std::vector<uint32_t>      m_pending_slots;
+		std::vector<int32_t>       m_pending_priorities;
+		std::vector<DelegateFlags> m_pending_flags;
+
+		// ブロードキャストの入れ子の深さ
+		size_t m_broadcast_depth = 0;
+		// ブロードキャスト中に削除された数
+		size_t m_removed_num = 0;
+
+		// オブジェクトに紐付いたデリゲート
+		std::vector<ObjectBindingEntry> m_object_bindings;
+		// 最後に生存確認を行った時点のオブジェクトの破棄数
+		uint64_t m_binding_serial = INVALID_SERIAL;
+
+		// queue() で積んだ引数と、flush() で呼び出し中の引数
+		std::vector<Payload> m_queued_payloads;
+		std::vector<Payload> m_flushing_payloads;
+		bool                 m_is_flushing = false;
+		// 引数の配列をまとめて受け取るデリゲート(使用する場合のみ作成する)
+		// 受け取る側のデリゲートは入れ子にしないので持たない
+		std::conditional_t<IsBatchFunction<FunctionType>,
+		                   std::nullptr_t,
+		                   std::unique_ptr<BatchDelegate>>
+		    m_batch_delegate = nullptr;
 	};
 
+	/**
+	 * @brief デリゲートを内部のバッファに保持するマルチキャストデリゲート
+	 * 登録時にヒープを使用せず、バッファに収まらない関数はコンパイルエラーになる
+	 */
+	template<class T, size_t Size = 48>
+	using InlineMulticastDelegate = MulticastDelegate<T, InlineFunction<T, Size>>;
+
 } // namespace bavil
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <utility>
 
@@ -9,6 +10,36 @@ namespace bavil
 {
 	class ObjectBase;
 
+	/**
+	 * @brief 参照数を増やさずにオブジェクトを指す
+	 * オブジェクトの生存確認のみを行い、オブジェクトの寿命には影響しない
+	 */
+	struct ObjectBinding
+	{
+		friend class ObjectSystem;
+
+	public:
+		int64_t  index      = -1;
+		uint32_t generation = 0;
+
+		/**
+		 * @brief 指しているオブジェクトが生存しているか確認する
+		*/
+		bool is_alive() const;
+
+		/**
+		 * @brief オブジェクトが破棄される度に加算される値を取得する
+		 * 前回から変わっていなければ、その間にオブジェクトは破棄されていない
+		*/
+		static uint64_t GetDestroySerial() noexcept
+		{
+			return s_destroy_serial.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static inline std::atomic<uint64_t> s_destroy_serial = 0;
+	};
+
 	struct ObjectHandleBase
 	{
 		friend class ObjectSystem;
@@ -42,6 +73,11 @@ namespace bavil
 		*/
 		size_t get_reference_count() const;
 
+		/**
+		 * @brief 参照数を増やさずにオブジェクトを指す情報を取得する
+		*/
+		ObjectBinding get_binding() const;
+
 	protected:
 		ObjectHandleBase(int64_t _index) noexcept;
 		ObjectBase* get_object_internal() const;
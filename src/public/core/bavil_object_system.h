@@ -6,6 +6,7 @@
 #include <concepts>
 
 #include "core/bavil_system_manager.h"
+#include "core/bavil_system_allocator.h"
 #include "core/bavil_object_base.h"
 #include "core/bavil_object_handle.h"
 
@@ -18,6 +19,12 @@ namespace bavil
 		ObjectBase* ObjectPtr = nullptr;
 		// オブジェクトの参照数
 		size_t ReferenceNum = 0;
+		// オブジェクトの確保サイズ
+		size_t ObjectSize = 0;
+		// オブジェクトのアライメント
+		size_t ObjectAlignment = 0;
+		// 破棄される度に加算される世代
+		uint32_t Generation = 0;
 	};
 
 	class ObjectSystem : public bavil::core::SystemBase<ObjectSystem>
@@ -41,9 +48,15 @@ namespace bavil
 		[[nodiscard]] ObjectHandle<T> create_object()
 		{
 			int32_t free_index = generated_free_index();
-			T*      new_obj    = new T();
 
-			return create_object_internal(free_index, new_obj);
+			// システムのアロケータから確保する
+			void* memory  = get_allocator().allocate(sizeof(T), alignof(T));
+			T*    new_obj = ::new (memory) T();
+
+			return create_object_internal(free_index,
+			                              new_obj,
+			                              sizeof(T),
+			                              alignof(T));
 		}
 
 		[[nodiscard]] ObjectBase* get_object_internal(
@@ -58,9 +71,18 @@ namespace bavil
 		// オブジェクトの参照を減算する
 		void object_reference_decrement_internal(const ObjectHandleBase& _handle);
 
+		// 参照数を増やさずに指しているオブジェクトが生存しているか確認する
+		[[nodiscard]] bool is_alive_internal(const ObjectBinding& _binding) const;
+
+		// オブジェクトを破棄せずに、取得済みの ObjectBinding を無効にする
+		void invalidate_bindings_internal(const ObjectHandleBase& _handle);
+
 	private:
 		ObjectHandleBase create_object_internal(int32_t     _free_index,
-		                                        ObjectBase* new_object);
+		                                        ObjectBase* new_object,
+		                                        size_t      _size,
+		                                        size_t      _alignment);
+		void             destroy_object_internal(ObjectArrayItem& _item);
 		int32_t          generated_free_index();
 
 	private:
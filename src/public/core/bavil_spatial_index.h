@@ -0,0 +1,114 @@
+#pragma once
+
+#include <concepts>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include "bavil_type.h"
+#include "math/bavil_aabb.h"
+#include "math/bavil_vector3.h"
+
+namespace bavil
+{
+
+	class Actor;
+
+	/**
+	 * @brief 空間の索引の種類
+	 */
+	enum class SpatialIndexType : u8
+	{
+		// 索引を作らず、検索時に全ての要素を調べる
+		None,
+		// 一定の大きさの格子に分け、要素が存在する格子のみをハッシュで保持する
+		HashedGrid,
+		// 要素が多い範囲ほど細かく8分割する
+		Octree,
+	};
+
+	/**
+	 * @brief 空間の索引の設定
+	 */
+	struct SpatialIndexSettings
+	{
+		SpatialIndexType type = SpatialIndexType::None;
+		// 格子の1辺の長さ(八分木では分割を止める最小の1辺の長さ)
+		f32 cell_size = 16.0f;
+		// 八分木で分割する範囲(範囲外の要素は分割せずにまとめて保持する)
+		bavil::math::AABB bounds = {bavil::math::Vector3(-4096.0f),
+		                            bavil::math::Vector3(4096.0f)};
+		// 八分木の1つの葉に格納する要素数の上限(超えると分割する)
+		u32 leaf_capacity = 16;
+	};
+
+	/**
+	 * @brief アクターの位置から空間を検索する為の索引
+	 * 要素は追加時に返す番号で識別し、移動した要素のみを個別に更新できる
+	 */
+	class SpatialIndex
+	{
+	public:
+		static constexpr u32 INVALID_ID = static_cast<u32>(-1);
+
+		virtual ~SpatialIndex() = default;
+
+		/**
+		 * @brief 設定に応じた索引を生成する
+		 * cell_size が正の有限の値でない場合や、八分木の範囲が有限でない場合は
+		 * std::invalid_argument を投げる
+		 * @return 種類が SpatialIndexType::None の場合はnullptr
+		*/
+		static std::unique_ptr<SpatialIndex> Create(
+		    const SpatialIndexSettings& _settings,
+		    std::pmr::memory_resource*  _resource);
+
+		/**
+		 * @brief 要素を追加する
+		 * @return 要素の番号
+		*/
+		virtual u32 insert(bavil::Actor*               _actor,
+		                   const bavil::math::Vector3& _position) = 0;
+
+		/**
+		 * @brief 要素の位置を更新する
+		 * 同じ格子や葉に留まる場合は位置を書き換えるだけで済む
+		*/
+		virtual void update(u32 _id, const bavil::math::Vector3& _position) = 0;
+
+		virtual void remove(u32 _id) = 0;
+
+		virtual void clear() = 0;
+
+		virtual size_t size() const noexcept = 0;
+
+		/**
+		 * @brief 境界ボックスに含まれる要素を呼び出す
+		 * @param _func void(Actor&, const Vector3&)で呼び出す関数
+		*/
+		template<class Func>
+			requires(
+			    std::invocable<Func&, bavil::Actor&, const bavil::math::Vector3&>)
+		void query_aabb(const bavil::math::AABB& _aabb, Func&& _func) const
+		{
+			query_aabb_internal(_aabb,
+			                    &_func,
+			                    [](void*                       _context,
+			                       bavil::Actor&               _actor,
+			                       const bavil::math::Vector3& _position)
+			                    {
+				                    (*static_cast<std::remove_reference_t<Func>*>(
+				                        _context))(_actor, _position);
+			                    });
+		}
+
+	protected:
+		using QueryFunction = void (*)(void*                       _context,
+		                               bavil::Actor&               _actor,
+		                               const bavil::math::Vector3& _position);
+
+		virtual void query_aabb_internal(const bavil::math::AABB& _aabb,
+		                                 void*                    _context,
+		                                 QueryFunction _function) const = 0;
+	};
+
+} // namespace bavil
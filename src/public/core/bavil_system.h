@@ -6,15 +6,30 @@
 namespace bavil::core
 {
 	class SystemManager;
+	class SystemAllocator;
 
 	class SystemInterface
 	{
+		friend class SystemManager;
+
 	public:
 		virtual ~SystemInterface() {}
 
 		virtual void   initialize(SystemManager& _system_manager) = 0;
 		virtual void   finalize()                                 = 0;
 		virtual size_t get_system_id() const                      = 0;
+
+		/**
+		 * @brief システムに割り当てられたアロケータを取得する
+		 * initialize()の呼び出し以降で有効
+		 */
+		SystemAllocator& get_allocator() const noexcept
+		{
+			return *m_allocator;
+		}
+
+	private:
+		SystemAllocator* m_allocator = nullptr;
 	};
 
 	template<class T> concept SystemConcepts = requires(T system)
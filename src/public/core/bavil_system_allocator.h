@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace bavil::core
+{
+
+	/**
+	 * @brief システム毎のメモリ使用量のレポート
+	 */
+	struct SystemMemoryReport
+	{
+		// システムID
+		size_t system_id = 0;
+		// システムの型名
+		const char* name = nullptr;
+		// 現在確保しているバイト数
+		size_t live_bytes = 0;
+		// 最大確保バイト数
+		size_t peak_bytes = 0;
+		// 現在確保している数
+		size_t allocation_num = 0;
+		// 予算(0の場合は無制限)
+		size_t budget_bytes = 0;
+	};
+
+	/**
+	 * @brief システム毎に割り当てられるアロケータ
+	 * 確保したメモリをシステム単位で集計し、予算を超えた確保は即座に失敗させる
+	 * std::pmr::memory_resourceとしてコンテナに渡すことも出来る
+	 */
+	class SystemAllocator : public std::pmr::memory_resource
+	{
+	public:
+		explicit SystemAllocator(size_t                     _system_id,
+		                         std::pmr::memory_resource* _upstream =
+		                             std::pmr::new_delete_resource()) noexcept
+		    : m_system_id(_system_id)
+		    , m_upstream(_upstream)
+		{
+		}
+
+		/**
+		 * @brief オブジェクトを構築する
+		*/
+		template<class T, class... Args>
+		[[nodiscard]] T* create(Args&&... _args)
+		{
+			void* memory = allocate(sizeof(T), alignof(T));
+			return ::new (memory) T(std::forward<Args>(_args)...);
+		}
+
+		/**
+		 * @brief create()で構築したオブジェクトを破棄する
+		*/
+		template<class T>
+		void destroy(T* _object)
+		{
+			if ( _object )
+			{
+				_object->~T();
+				deallocate(_object, sizeof(T), alignof(T));
+			}
+		}
+
+		size_t get_system_id() const noexcept
+		{
+			return m_system_id;
+		}
+
+		const char* get_name() const noexcept
+		{
+			return m_name;
+		}
+
+		void set_name(const char* _name) noexcept
+		{
+			m_name = _name;
+		}
+
+		/**
+		 * @brief 予算を設定する
+		 * @param _budget_bytes 確保できる最大バイト数(0の場合は無制限)
+		*/
+		void set_budget(size_t _budget_bytes) noexcept
+		{
+			m_budget_bytes.store(_budget_bytes, std::memory_order_relaxed);
+		}
+
+		size_t get_budget() const noexcept
+		{
+			return m_budget_bytes.load(std::memory_order_relaxed);
+		}
+
+		size_t get_live_bytes() const noexcept
+		{
+			return m_live_bytes.load(std::memory_order_relaxed);
+		}
+
+		size_t get_peak_bytes() const noexcept
+		{
+			return m_peak_bytes.load(std::memory_order_relaxed);
+		}
+
+		size_t get_allocation_num() const noexcept
+		{
+			return m_allocation_num.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief 現在の状態をレポートとして取得する
+		*/
+		SystemMemoryReport get_report() const noexcept
+		{
+			SystemMemoryReport result = {};
+			result.system_id          = m_system_id;
+			result.name               = m_name;
+			result.live_bytes         = get_live_bytes();
+			result.peak_bytes         = get_peak_bytes();
+			result.allocation_num     = get_allocation_num();
+			result.budget_bytes       = get_budget();
+			return result;
+		}
+
+	private:
+		virtual void* do_allocate(size_t _bytes, size_t _alignment) override;
+
+		virtual void do_deallocate(void*  _p,
+		                           size_t _bytes,
+		                           size_t _alignment) override;
+
+		virtual bool do_is_equal(
+		    const std::pmr::memory_resource& _other) const noexcept override
+		{
+			return this == &_other;
+		}
+
+	private:
+		size_t                     m_system_id = 0;
+		const char*                m_name      = nullptr;
+		std::pmr::memory_resource* m_upstream  = nullptr;
+
+		std::atomic<size_t> m_live_bytes     = 0;
+		std::atomic<size_t> m_peak_bytes     = 0;
+		std::atomic<size_t> m_allocation_num = 0;
+		std::atomic<size_t> m_budget_bytes   = 0;
+	};
+
+} // namespace bavil::core
@@ -2,8 +2,11 @@
 
 #include <cstddef>
 #include <concepts>
-#include <unordered_map>
+#include <memory>
+#include <typeinfo>
+#include <vector>
 #include "core/bavil_system.h"
+#include "core/bavil_system_allocator.h"
 
 namespace bavil::core
 {
@@ -11,10 +14,58 @@ namespace bavil::core
 	class SystemManager
 	{
 	public:
+		/**
+		 * @brief コンテキストを一時的にカレントにするスコープ
+		 * スコープを抜けると元のコンテキストに戻す
+		 */
+		class ScopedContext
+		{
+		public:
+			explicit ScopedContext(SystemManager& _context) noexcept
+			    : m_previous(t_current_context)
+			{
+				t_current_context = &_context;
+			}
+
+			~ScopedContext() noexcept
+			{
+				t_current_context = m_previous;
+			}
+
+			ScopedContext(const ScopedContext&)            = delete;
+			ScopedContext& operator=(const ScopedContext&) = delete;
+
+		private:
+			SystemManager* m_previous;
+		};
+
+	public:
+		/**
+		 * @brief コンストラクタ
+		 * 生成したスレッドのカレントコンテキストになる
+		*/
 		SystemManager() noexcept;
 		~SystemManager() noexcept;
 
-		static SystemManager& Get();
+		SystemManager(const SystemManager&)            = delete;
+		SystemManager& operator=(const SystemManager&) = delete;
+
+		/**
+		 * @brief 呼び出したスレッドのカレントコンテキストを取得する
+		*/
+		static SystemManager& Get() noexcept
+		{
+			return *t_current_context;
+		}
+
+		/**
+		 * @brief 呼び出したスレッドのカレントコンテキストを取得する
+		 * @return 設定されていない場合はnullptr
+		*/
+		static SystemManager* GetCurrent() noexcept
+		{
+			return t_current_context;
+		}
 
 		template<SystemConcepts T>
 		static T* GetSystem()
@@ -22,29 +73,81 @@ namespace bavil::core
 			return Get().get_system<T>();
 		}
 
+		/**
+		 * @brief 呼び出したスレッドのカレントコンテキストにする
+		*/
+		void make_current() noexcept
+		{
+			t_current_context = this;
+		}
+
 		template<SystemConcepts T>
 		T* get_system()
 		{
 			const size_t id = T::GetSystemId();
 
-			auto result = system_maps.find(id);
-			if ( result != system_maps.end() )
+			if ( id < m_systems.size() )
 			{
-				SystemInterface* result_system = result->second;
-				return static_cast<T*>(result_system);
+				if ( SystemInterface* result_system = m_systems[id] )
+				{
+					return static_cast<T*>(result_system);
+				}
 			}
 
-			T* new_system = new T();
-
-			system_maps.emplace(id, new_system);
+			return create_system<T>(id);
+		}
 
-			new_system->initialize(*this);
+		/**
+		 * @brief 生成済みのシステムを取得する
+		 * @return 生成されていない場合はnullptr
+		*/
+		template<SystemConcepts T>
+		T* find_system() const noexcept
+		{
+			const size_t id = T::GetSystemId();
 
-			return new_system;
+			if ( id < m_systems.size() )
+			{
+				return static_cast<T*>(m_systems[id]);
+			}
+			return nullptr;
 		}
 
+		/**
+		 * @brief 全てのシステムを終了する
+		 * 初期化が完了した順の逆順で終了させる
+		*/
 		void finalize();
 
+		/**
+		 * @brief システムに割り当てるアロケータを取得する
+		 * @param _system_id システムID
+		*/
+		SystemAllocator& get_system_allocator(size_t _system_id);
+
+		template<SystemConcepts T>
+		SystemAllocator& get_allocator()
+		{
+			return get_system_allocator(T::GetSystemId());
+		}
+
+		/**
+		 * @brief システムのメモリ予算を設定する
+		 * システムの生成前に設定することも出来る
+		 * @param _budget_bytes 確保できる最大バイト数(0の場合は無制限)
+		*/
+		template<SystemConcepts T>
+		void set_memory_budget(size_t _budget_bytes)
+		{
+			get_allocator<T>().set_budget(_budget_bytes);
+		}
+
+		/**
+		 * @brief システム毎のメモリ使用量のレポートを取得する
+		 * @return システムID順に並んだレポート
+		*/
+		std::vector<SystemMemoryReport> get_memory_report() const;
+
 		template<SystemConcepts T>
 		static size_t GetneratedSystemId()
 		{
@@ -53,13 +156,47 @@ namespace bavil::core
 		}
 
 	private:
+		template<SystemConcepts T>
+		T* create_system(size_t _id)
+		{
+			// システム毎のアロケータを割り当てる
+			SystemAllocator& allocator = get_system_allocator(_id);
+			allocator.set_name(typeid(T).name());
+
+			T* new_system = nullptr;
+			if constexpr ( std::constructible_from<T, SystemAllocator&> )
+			{
+				new_system = new T(allocator);
+			}
+			else
+			{
+				new_system = new T();
+			}
+			static_cast<SystemInterface*>(new_system)->m_allocator = &allocator;
+
+			register_system(_id, new_system);
+
+			new_system->initialize(*this);
+
+			m_initialized_systems.push_back(new_system);
+
+			return new_system;
+		}
+
+		void register_system(size_t _id, SystemInterface* _system);
+
 		static size_t GetneratedSystemIdInternal();
 
 	private:
-		std::unordered_map<size_t, SystemInterface*> system_maps;
-
-		// singleton
-		static inline SystemManager* m_instance;
+		// システムIDで引けるシステムの配列
+		std::vector<SystemInterface*> m_systems;
+		// 初期化が完了した順のシステム
+		std::vector<SystemInterface*> m_initialized_systems;
+		// システム毎のアロケータ(システムの破棄後も集計を残す)
+		std::vector<std::unique_ptr<SystemAllocator>> m_allocators;
+
+		// スレッド毎のカレントコンテキスト
+		static inline thread_local SystemManager* t_current_context = nullptr;
 	};
 
 	/**
@@ -72,11 +209,22 @@ namespace bavil::core
 	public:
 		virtual ~SystemBase() {}
 
+		/**
+		 * @brief カレントコンテキストからシステムを取得する
+		*/
 		static Derive& Get()
 		{
 			return *SystemManager::GetSystem<Derive>();
 		}
 
+		/**
+		 * @brief 指定したコンテキストからシステムを取得する
+		*/
+		static Derive& Get(SystemManager& _context)
+		{
+			return *_context.get_system<Derive>();
+		}
+
 		virtual size_t get_system_id() const override final
 		{
 			return Derive::GetSystemId();
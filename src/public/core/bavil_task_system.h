@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "bavil_type.h"
+#include "core/bavil_system_manager.h"
+
+namespace bavil
+{
+
+	/**
+	 * @brief ワーカースレッドで範囲を分割して並列に実行するシステム
+	 * parallel_for()を呼び出したスレッドも実行に参加し、全ての範囲が終わるまで待つ
+	 * ワーカースレッドは生成したコンテキストをカレントコンテキストにして動作する
+	 */
+	class TaskSystem : public bavil::core::SystemBase<TaskSystem>
+	{
+	public:
+		TaskSystem() = default;
+
+		virtual void initialize(
+		    bavil::core::SystemManager& _system_manager) override;
+
+		virtual void finalize() override;
+
+		/**
+		 * @brief ワーカースレッドの数を設定する
+		 * 実行中のワーカースレッドは終了させてから作り直す
+		 * @param _worker_num ワーカースレッドの数(0の場合は呼び出したスレッドのみで実行する)
+		*/
+		void set_worker_num(size_t _worker_num);
+
+		size_t get_worker_num() const noexcept
+		{
+			return m_workers.size();
+		}
+
+		/**
+		 * @brief [0, _count)の範囲を分割して並列に実行する
+		 * 範囲が分割できない程小さい場合は呼び出したスレッドで全て実行する
+		 * 関数が例外を投げた場合は残りのチャンクを実行せず、実行中のチャンクが
+		 * 終わるのを待ってから最初の例外を呼び出したスレッドで投げ直す
+		 * @param _count 範囲の要素数
+		 * @param _min_chunk_size 1回の呼び出しで実行する最小の要素数
+		 * @param _func void(size_t begin, size_t end)で呼び出す関数
+		*/
+		template<class Func>
+			requires(std::invocable<Func&, size_t, size_t>)
+		void parallel_for(size_t _count, size_t _min_chunk_size, Func&& _func)
+		{
+			parallel_for_internal(_count,
+			                      _min_chunk_size,
+			                      &_func,
+			                      [](void* _context, size_t _begin, size_t _end)
+			                      {
+				                      (*static_cast<std::remove_reference_t<Func>*>(
+				                          _context))(_begin, _end);
+			                      });
+		}
+
+	private:
+		using RangeFunction = void (*)(void* _context, size_t _begin, size_t _end);
+
+		// parallel_for()1回分の実行状態(呼び出したスレッドのスタックに置く)
+		struct Job
+		{
+			void*         context    = nullptr;
+			RangeFunction function   = nullptr;
+			size_t        count      = 0;
+			size_t        chunk_size = 0;
+			size_t        chunk_num  = 0;
+			// 次に実行するチャンクの番号
+			std::atomic<size_t> next_chunk = 0;
+			// このジョブを実行中のワーカースレッドの数(m_mutexで保護する)
+			size_t worker_num = 0;
+			// 最初に投げられた例外(m_mutexで保護する)
+			std::exception_ptr exception;
+		};
+
+		void parallel_for_internal(size_t        _count,
+		                           size_t        _min_chunk_size,
+		                           void*         _context,
+		                           RangeFunction _function);
+
+		// チャンクが無くなるまで実行する
+		// 例外はジョブに記録し、残りのチャンクを取り出せない様にする
+		void execute(Job& _job);
+
+		void start_workers(size_t _worker_num);
+		void stop_workers();
+		void worker_main();
+
+	private:
+		bavil::core::SystemManager* m_system_manager = nullptr;
+		std::vector<std::thread>    m_workers;
+
+		std::mutex              m_mutex;
+		std::condition_variable m_wake_condition;
+		std::condition_variable m_done_condition;
+		// 実行待ちのジョブ(入れ子のジョブを先に実行する為に末尾から取り出す)
+		std::vector<Job*> m_jobs;
+		bool              m_is_stopping = false;
+	};
+
+} // namespace bavil
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <compare>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+#include "bavil_type.h"
+#include "core/bavil_system_manager.h"
+
+namespace bavil
+{
+
+	/**
+	 * @brief タイマーハンドル
+	 * スロット番号と世代で構成され、キャンセル済みのタイマーを指すハンドルは無効になる
+	 */
+	struct TimerHandle
+	{
+		static constexpr u32 INVALID_INDEX = std::numeric_limits<u32>::max();
+
+		u32 index      = INVALID_INDEX;
+		u32 generation = 0;
+
+		constexpr bool is_valid() const noexcept
+		{
+			return index != INVALID_INDEX;
+		}
+
+		auto operator<=>(const TimerHandle&) const = default;
+	};
+
+	/**
+	 * @brief 階層タイミングホイールによるタイマーシステム
+	 * 登録とキャンセルはO(1)で行い、tick()で期限切れのタイマーをスロット単位でまとめて実行する
+	 */
+	class TimerSystem : public bavil::core::SystemBase<TimerSystem>
+	{
+	public:
+		using Callback = std::function<void()>;
+
+		// 1段目のホイールのビット数
+		static constexpr u32 ROOT_WHEEL_BITS = 8;
+		// 2段目以降のホイールのビット数
+		static constexpr u32 WHEEL_BITS = 6;
+		// ホイールの段数
+		static constexpr u32 WHEEL_LEVEL_NUM = 4;
+		static constexpr u32 ROOT_WHEEL_SIZE = 1u << ROOT_WHEEL_BITS;
+		static constexpr u32 WHEEL_SIZE      = 1u << WHEEL_BITS;
+		// 全ホイールのスロット数
+		static constexpr u32 SLOT_NUM =
+		    ROOT_WHEEL_SIZE + WHEEL_SIZE * (WHEEL_LEVEL_NUM - 1);
+		// ホイールで表現できる最大のティック数
+		static constexpr u64 MAX_WHEEL_TICKS =
+		    (u64(1) << (ROOT_WHEEL_BITS + WHEEL_BITS * (WHEEL_LEVEL_NUM - 1))) - 1;
+		// デフォルトの1ティックの秒数
+		static constexpr f32 DEFAULT_TICK_INTERVAL = 1.0f / 1000.0f;
+
+		explicit TimerSystem(bavil::core::SystemAllocator& _allocator);
+
+		virtual void initialize(
+		    bavil::core::SystemManager& _system_manager) override;
+
+		virtual void finalize() override;
+
+		/**
+		 * @brief 1ティックの秒数を設定する
+		*/
+		void set_tick_interval(f32 _seconds) noexcept
+		{
+			m_tick_interval = _seconds;
+		}
+
+		f32 get_tick_interval() const noexcept
+		{
+			return m_tick_interval;
+		}
+
+		/**
+		 * @brief タイマーを登録する
+		 * @param _delay 実行までの秒数
+		 * @param _callback 実行する関数
+		 * @param _interval 0より大きい場合はこの秒数毎に繰り返し実行する
+		 * @return タイマーハンドル
+		*/
+		TimerHandle schedule(f32 _delay, Callback _callback, f32 _interval = 0.0f);
+
+		/**
+		 * @brief ティック数を指定してタイマーを登録する
+		 * @param _delay_ticks 実行までのティック数(最低1)
+		 * @param _callback 実行する関数
+		 * @param _interval_ticks 0より大きい場合はこのティック数毎に繰り返し実行する
+		 * @return タイマーハンドル
+		*/
+		TimerHandle schedule_ticks(u64      _delay_ticks,
+		                           Callback _callback,
+		                           u64      _interval_ticks = 0);
+
+		/**
+		 * @brief タイマーをキャンセルする
+		 * 実行中のタイマーのコールバック内から呼ぶことも出来る
+		 * @return キャンセルした場合はtrue
+		*/
+		bool cancel(TimerHandle _handle);
+
+		/**
+		 * @brief タイマーが有効か確認する
+		*/
+		bool is_active(TimerHandle _handle) const noexcept;
+
+		/**
+		 * @brief 時間を進めて期限切れのタイマーを実行する
+		 * @param _delta_seconds 経過秒数
+		*/
+		void tick(f32 _delta_seconds);
+
+		/**
+		 * @brief ティック数を指定して時間を進める
+		*/
+		void advance_ticks(u64 _ticks);
+
+		/**
+		 * @brief 有効なタイマーの数を取得する
+		*/
+		size_t get_active_timer_num() const noexcept
+		{
+			return m_active_timer_num;
+		}
+
+		/**
+		 * @brief 次に処理するティックを取得する
+		*/
+		u64 get_current_tick() const noexcept
+		{
+			return m_current_tick;
+		}
+
+	private:
+		enum class TimerState : u8
+		{
+			Free,
+			Scheduled,
+			Firing,
+			Cancelled,
+		};
+
+		struct TimerNode
+		{
+			// 実行するティック
+			u64 expire_tick = 0;
+			// 繰り返しのティック数
+			u64 interval_ticks = 0;
+			// リストの前後のノード
+			u32 prev = TimerHandle::INVALID_INDEX;
+			u32 next = TimerHandle::INVALID_INDEX;
+			// 所属しているリスト
+			u32        list       = TimerHandle::INVALID_INDEX;
+			u32        generation = 0;
+			TimerState state      = TimerState::Free;
+		};
+
+		// 期限切れのタイマーをまとめるリスト
+		static constexpr u32 EXPIRED_LIST = SLOT_NUM;
+
+		u32  allocate_node();
+		void free_node(u32 _index);
+		void add_node(u32 _index);
+		void link_node(u32 _index, u32 _list);
+		void unlink_node(u32 _index);
+		void cascade(u32 _level);
+		void advance_tick();
+
+	private:
+		// ノードとコールバックは別配列で持ち、ホイールの操作ではノードのみ触る
+		std::pmr::vector<TimerNode> m_nodes;
+		std::pmr::vector<Callback>  m_callbacks;
+
+		// 各スロットのリストの先頭(最後は期限切れのリスト)
+		std::array<u32, SLOT_NUM + 1> m_list_heads;
+
+		u32    m_free_head        = TimerHandle::INVALID_INDEX;
+		size_t m_active_timer_num = 0;
+		u64    m_current_tick     = 0;
+		f32    m_tick_interval    = DEFAULT_TICK_INTERVAL;
+		// 誤差が蓄積しない様に倍精度で持つ
+		f64 m_time_accumulator = 0.0;
+	};
+
+} // namespace bavil
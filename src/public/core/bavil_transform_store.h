@@ -0,0 +1,349 @@
+#pragma once
+
+#include <concepts>
+#include <memory_resource>
+#include <vector>
+#include "bavil_type.h"
+#include "math/bavil_vector3.h"
+#include "math/bavil_rotator.h"
+#include "math/bavil_matrix44.h"
+
+namespace bavil
+{
+
+	class Transform;
+
+	/**
+	 * @brief トランスフォームの値を成分毎の連続した配列で保持する
+	 * 位置、回転、スケールはX,Y,Zの成分毎に別の配列に並べ、
+	 * update_matrices() で変更された行列を複数個ずつまとめて作り直す
+	 * 削除は末尾の要素と入れ替えるので、要素の位置は変わる事がある
+	 * save_previous() で保存した前回の値を別の配列に持ち、現在の値との補間に使う
+	 */
+	class TransformStore
+	{
+	public:
+		// update_matrices() で1回に作り直す行列の数
+		static constexpr size_t SIMD_WIDTH = 4;
+
+		explicit TransformStore(std::pmr::memory_resource* _resource);
+
+		TransformStore(const TransformStore&)            = delete;
+		TransformStore& operator=(const TransformStore&) = delete;
+
+		/**
+		 * @brief トランスフォームの要素を追加する
+		 * トランスフォームが保持している値を配列に移す
+		 * 既に要素を持っているトランスフォームの場合は何もしない
+		*/
+		void add(Transform& _transform);
+
+		/**
+		 * @brief トランスフォームの要素を削除する
+		 * 配列の値はトランスフォームに戻す
+		 * この配列の要素でない場合は何もしない
+		*/
+		void remove(Transform& _transform);
+
+		/**
+		 * @brief 全ての要素を削除する
+		 * 配列の値はそれぞれのトランスフォームに戻す
+		*/
+		void clear() noexcept;
+
+		/**
+		 * @brief 位置、回転、スケールから行列を求める
+		*/
+		static bavil::math::Matrix44 MakeMatrix(
+		    const bavil::math::Vector3& _position,
+		    const bavil::math::Rotator& _rotation,
+		    const bavil::math::Vector3& _scale) noexcept;
+
+		size_t size() const noexcept
+		{
+			return m_owners.size();
+		}
+
+		/**
+		 * @brief 値が変更された全ての行列を作り直す
+		 * SIMD_WIDTH個ずつ成分の配列から読み込み、まとめて計算する
+		*/
+		void update_matrices() noexcept;
+
+		/**
+		 * @brief 全ての要素の値の変更の印を消す
+		 * 行列の作り直しでは消えないので、変更を反映した側が呼び出す
+		*/
+		void clear_changed() noexcept;
+
+		/**
+		 * @brief 全ての要素の現在の値を前回の値として保存する
+		 * 一定の間隔で値を更新する場合に、更新の前に呼び出して補間の始点にする
+		*/
+		void save_previous();
+
+		/**
+		 * @brief 前回の値と現在の値を補間した行列を求める
+		 * 位置とスケールは Vector3::Lerp、回転は Quaternion::Slerp で補間する
+		 * 前回の値を保存した後に追加した要素や、値が変わっていない要素は
+		 * 現在の値の行列を返す
+		 * @param _alpha 補間係数(0で前回の値、1で現在の値)
+		*/
+		bavil::math::Matrix44 get_interpolated_matrix(size_t _index,
+		                                              f32    _alpha) const noexcept;
+
+		/**
+		 * @brief clear_changed() の後に値が変更された要素の位置を順に呼び出す
+		 * @param _func void(size_t)で呼び出す関数
+		*/
+		template<class Func>
+			requires(std::invocable<Func&, size_t>)
+		void for_each_changed(Func&& _func) const
+		{
+			const size_t num = m_changed_flags.size();
+			for ( size_t i = 0; i < num; ++i )
+			{
+				if ( m_changed_flags[i] != 0 )
+				{
+					_func(i);
+				}
+			}
+		}
+
+	private:
+		friend class Transform;
+
+		// X,Y,Zの成分毎の配列
+		struct ComponentArray
+		{
+			explicit ComponentArray(std::pmr::memory_resource* _resource)
+			    : x(_resource)
+			    , y(_resource)
+			    , z(_resource)
+			{
+			}
+
+			void push_back(f32 _x, f32 _y, f32 _z)
+			{
+				x.push_back(_x);
+				y.push_back(_y);
+				z.push_back(_z);
+			}
+
+			// 末尾の要素を指定した位置に移して削除する
+			void swap_remove(size_t _index) noexcept
+			{
+				x[_index] = x.back();
+				y[_index] = y.back();
+				z[_index] = z.back();
+				x.pop_back();
+				y.pop_back();
+				z.pop_back();
+			}
+
+			void clear() noexcept
+			{
+				x.clear();
+				y.clear();
+				z.clear();
+			}
+
+			std::pmr::vector<f32> x;
+			std::pmr::vector<f32> y;
+			std::pmr::vector<f32> z;
+		};
+
+		// 1つの行列を作り直す
+		void update_matrix(size_t _index) noexcept;
+		// 要素の値をトランスフォームに戻す
+		void detach(size_t _index) noexcept;
+		// 指定した位置からSIMD_WIDTH個の行列をまとめて作り直す
+		void update_matrices_simd(size_t _begin) noexcept;
+
+	private:
+		ComponentArray m_positions;
+		// X,Y,Zにピッチ、ヨー、ロールを格納する
+		ComponentArray m_rotations;
+		ComponentArray m_scales;
+		// save_previous() で保存した値
+		ComponentArray m_previous_positions;
+		ComponentArray m_previous_rotations;
+		ComponentArray m_previous_scales;
+		// 前回の値を保存しているか
+		std::pmr::vector<u8> m_previous_flags;
+		// 作り直した行列
+		std::pmr::vector<bavil::math::Matrix44> m_matrices;
+		// 行列の作り直しが必要か
+		std::pmr::vector<u8> m_dirty_flags;
+		// clear_changed() の後に値が変更されたか
+		// get_matrix() で行列を作り直しても消えないので、ワールド行列の更新に使う
+		std::pmr::vector<u8> m_changed_flags;
+		// 要素を参照しているトランスフォーム(削除で位置が変わった時に更新する)
+		std::pmr::vector<Transform*> m_owners;
+	};
+
+	/**
+	 * @brief 位置、回転、スケールからなるトランスフォーム
+	 * 登録中の値は TransformStore の配列に格納されていて、このクラスは配列の要素を参照する
+	 * 配列の要素を持たない間は自身に値を保持し、追加時に配列へ移して削除時に戻す
+	 * 値を変更しても行列はすぐに作り直さず、変更済みの印だけ付けておく
+	 * 行列は変更後の最初の get_matrix() か TransformStore::update_matrices() で
+	 * 1回だけ作り直す
+	 */
+	class Transform
+	{
+	public:
+		Transform() noexcept = default;
+
+		Transform(const Transform&)            = delete;
+		Transform& operator=(const Transform&) = delete;
+
+		/**
+		 * @brief 配列の要素を持っているか確認する
+		*/
+		bool is_valid() const noexcept
+		{
+			return m_store != nullptr;
+		}
+
+		/**
+		 * @brief 行列を取得する
+		 * 値が変更されている場合はここで作り直す
+		*/
+		const bavil::math::Matrix44& get_matrix() const noexcept
+		{
+			update_matrix();
+			return is_valid() ? m_store->m_matrices[m_index] : m_matrix;
+		}
+
+		bavil::math::Vector3 get_position() const noexcept
+		{
+			if ( !is_valid() )
+			{
+				return m_position;
+			}
+			const auto& positions = m_store->m_positions;
+			return {
+			    positions.x[m_index], positions.y[m_index], positions.z[m_index]};
+		}
+		bavil::math::Rotator get_rotation() const noexcept
+		{
+			if ( !is_valid() )
+			{
+				return m_rotation;
+			}
+			const auto& rotations = m_store->m_rotations;
+			return {
+			    rotations.x[m_index], rotations.y[m_index], rotations.z[m_index]};
+		}
+		bavil::math::Vector3 get_scale() const noexcept
+		{
+			if ( !is_valid() )
+			{
+				return m_scale;
+			}
+			const auto& scales = m_store->m_scales;
+			return {scales.x[m_index], scales.y[m_index], scales.z[m_index]};
+		}
+
+		void set_position(bavil::math::Vector3 _position) noexcept
+		{
+			if ( !is_valid() )
+			{
+				m_position = _position;
+				m_is_dirty = true;
+				return;
+			}
+			set_components(
+			    m_store->m_positions, _position.x, _position.y, _position.z);
+		}
+		void set_rotation(bavil::math::Rotator _rotation) noexcept
+		{
+			if ( !is_valid() )
+			{
+				m_rotation = _rotation;
+				m_is_dirty = true;
+				return;
+			}
+			set_components(m_store->m_rotations,
+			               _rotation.pitch,
+			               _rotation.yaw,
+			               _rotation.roll);
+		}
+		void set_scale(bavil::math::Vector3 _scale) noexcept
+		{
+			if ( !is_valid() )
+			{
+				m_scale    = _scale;
+				m_is_dirty = true;
+				return;
+			}
+			set_components(m_store->m_scales, _scale.x, _scale.y, _scale.z);
+		}
+
+		/**
+		 * @brief 行列の作り直しが必要か確認する
+		*/
+		bool is_dirty() const noexcept
+		{
+			return is_valid() ? m_store->m_dirty_flags[m_index] != 0 : m_is_dirty;
+		}
+
+		/**
+		 * @brief TransformStore::clear_changed() の後に値が変更されたか確認する
+		 * 配列の要素を持たない間は常にfalseを返す
+		*/
+		bool is_changed() const noexcept
+		{
+			return is_valid() && m_store->m_changed_flags[m_index] != 0;
+		}
+
+		/**
+		 * @brief 値が変更されている場合のみ行列を作り直す
+		*/
+		void update_matrix() const noexcept
+		{
+			if ( !is_dirty() )
+			{
+				return;
+			}
+			if ( is_valid() )
+			{
+				m_store->update_matrix(m_index);
+			}
+			else
+			{
+				m_matrix =
+				    TransformStore::MakeMatrix(m_position, m_rotation, m_scale);
+				m_is_dirty = false;
+			}
+		}
+
+	private:
+		friend class TransformStore;
+
+		void set_components(TransformStore::ComponentArray& _array,
+		                    f32                             _x,
+		                    f32                             _y,
+		                    f32                             _z) noexcept
+		{
+			_array.x[m_index]                 = _x;
+			_array.y[m_index]                 = _y;
+			_array.z[m_index]                 = _z;
+			m_store->m_dirty_flags[m_index]   = 1;
+			m_store->m_changed_flags[m_index] = 1;
+		}
+
+	private:
+		TransformStore* m_store = nullptr;
+		size_t          m_index = 0;
+
+		// 配列の要素を持たない間の値
+		bavil::math::Vector3          m_position = bavil::math::Vector3::ZERO;
+		bavil::math::Rotator          m_rotation;
+		bavil::math::Vector3          m_scale    = bavil::math::Vector3::ONE;
+		mutable bavil::math::Matrix44 m_matrix;
+		mutable bool                  m_is_dirty = false;
+	};
+
+} // namespace bavil
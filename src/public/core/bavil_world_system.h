@@ -2,26 +2,443 @@
 
 #include <core/bavil_multicast_delegate.h>
 
-#include <list>
+#include <concepts>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "bavil_type.h"
+#include "core/bavil_aabb_tree.h"
 #include "core/bavil_actor.h"
+#include "core/bavil_spatial_index.h"
 #include "core/bavil_system_manager.h"
+#include "core/bavil_transform_store.h"
+#include "math/bavil_ray.h"
 
 namespace bavil
 {
 
+	/**
+	 * @brief 固定の間隔で更新する時の設定
+	 */
+	struct FixedStepSettings
+	{
+		// 1回の更新で進める時間(秒、正の値)
+		f32 step_seconds = 1.0f / 60.0f;
+		// 1回の advance_fixed_step() で更新する最大の回数(1以上)
+		// 更新が間に合わずに溜まった時間は、この回数を超えた分を切り捨てる
+		u32 max_step_num = 5;
+	};
+
+	/**
+	 * @brief ワールドに存在するアクターを管理するシステム
+	 * アクターは連続した配列で保持し、各アクターが配列での位置を持つので
+	 * 登録と削除はO(1)で行える(削除は末尾の要素と入れ替えるので順番は保持しない)
+	 * 親子関係を持つアクターは、親が子より前に来る深さ優先の順の配列で別に保持し、
+	 * ワールド行列を配列の先頭から1回辿るだけで計算する
+	 * アクターのトランスフォームの値は TransformStore に成分毎に並べて保持する
+	 * tick() を呼び出すアクターは、並列に呼び出せるかで分けた別の配列で保持する
+	 * 空間の索引を設定すると、アクターの位置を update_transforms() で索引に反映し、
+	 * 範囲や近さでアクターを検索する時に使用する
+	 * 境界ボックスを持つアクターは AABBTree に格納し、半直線や重なりの判定に使用する
+	 * advance_fixed_step() はフレームの経過時間を溜めて固定の間隔で更新し、
+	 * 表示には前回と今回の更新の間を補間した行列を使う
+	 */
 	class WorldSystem : public bavil::core::SystemBase<WorldSystem>
 	{
+		friend class Actor;
+
 	public:
+		explicit WorldSystem(bavil::core::SystemAllocator& _allocator);
+
 		virtual void initialize(
 		    bavil::core::SystemManager& _system_manager) override;
 
 		virtual void finalize() override;
 
+		/**
+		 * @brief アクターを登録する
+		 * 登録済みのアクターの場合は何もしない
+		*/
 		void add_actor(bavil::Actor* _actor);
+
+		/**
+		 * @brief アクターの登録を解除する
+		 * 登録されていないアクターの場合は何もしない
+		*/
 		void remove_actor(bavil::Actor* _actor);
 
+		size_t get_actor_num() const noexcept
+		{
+			return m_actors.size();
+		}
+
+		/**
+		 * @brief 登録されている全てのアクターを取得する
+		*/
+		std::span<bavil::Actor* const> get_actors() const noexcept
+		{
+			return m_actors;
+		}
+
+		/**
+		 * @brief 登録されている全てのアクターを配列の順に呼び出す
+		 * 呼び出し中にアクターの登録、削除は出来ない
+		 * @param _func void(Actor&)で呼び出す関数
+		*/
+		template<class Func>
+			requires(std::invocable<Func&, bavil::Actor&>)
+		void for_each_actor(Func&& _func) const
+		{
+			for ( bavil::Actor* actor : m_actors )
+			{
+				_func(*actor);
+			}
+		}
+
+		/**
+		 * @brief アクターを親のアクターに取り付ける
+		 * 子のアクターに子が居る場合は、まとめて取り付ける
+		 * @return 親子関係が循環する場合は取り付けずにfalse
+		*/
+		bool attach_actor(bavil::Actor* _child, bavil::Actor* _parent);
+
+		/**
+		 * @brief アクターを親のアクターから取り外す
+		 * 子のアクターの子はそのまま残る
+		*/
+		void detach_actor(bavil::Actor* _child);
+
+		/**
+		 * @brief アクターのワールド行列を取得する
+		 * 親が居ないアクターはトランスフォームの行列をそのまま返す
+		 * 親子関係を持つアクターは update_transforms() で計算した行列を返す
+		*/
+		const bavil::math::Matrix44& get_world_matrix(
+		    const bavil::Actor& _actor) const noexcept;
+
+		/**
+		 * @brief 値が変更されたアクターのトランスフォームの行列をまとめて作り直す
+		 * 行列は TransformStore::update_matrices() で複数個ずつ作り直す
+		 * 親子関係は階層の配列を先頭から辿り、自身か親が変更されたアクターの
+		 * ワールド行列のみを計算し直す
+		 * 変更は前回の呼び出しからの印で判定するので、途中で get_matrix() を
+		 * 呼び出して行列を作り直していても反映する
+		 * フレーム毎に1回呼び出すと、以降の get_matrix() は作り直しを行わない
+		*/
+		void update_transforms();
+
+		/**
+		 * @brief アクターのワールド座標を取得する
+		 * 親子関係を持つアクターは update_transforms() で計算した位置を返す
+		*/
+		bavil::math::Vector3 get_world_position(
+		    const bavil::Actor& _actor) const noexcept;
+
+		/**
+		 * @brief 空間の索引を設定する
+		 * 登録済みのアクターは現在のワールド座標で索引に追加し直す
+		 * 種類が SpatialIndexType::None の場合は索引を破棄する
+		 * 設定が不正な場合は std::invalid_argument を投げ、索引は変更しない
+		*/
+		void set_spatial_index(const bavil::SpatialIndexSettings& _settings);
+
+		const bavil::SpatialIndexSettings& get_spatial_index_settings()
+		    const noexcept
+		{
+			return m_spatial_index_settings;
+		}
+
+		/**
+		 * @brief 境界ボックスに含まれるアクターを呼び出す
+		 * 索引は update_transforms() 時点の位置で検索する
+		 * 索引が無い場合は全てのアクターを調べる
+		 * @param _func void(Actor&)で呼び出す関数
+		*/
+		template<class Func>
+			requires(std::invocable<Func&, bavil::Actor&>)
+		void query_actors_in_aabb(const bavil::math::AABB& _aabb, Func&& _func) const
+		{
+			query_aabb(_aabb,
+			           [&](bavil::Actor& _actor, const bavil::math::Vector3&)
+			           {
+				           _func(_actor);
+			           });
+		}
+
+		/**
+		 * @brief 球に含まれるアクターを呼び出す
+		 * @param _func void(Actor&)で呼び出す関数
+		*/
+		template<class Func>
+			requires(std::invocable<Func&, bavil::Actor&>)
+		void query_actors_in_radius(const bavil::math::Vector3& _center,
+		                            f32                         _radius,
+		                            Func&&                      _func) const
+		{
+			const f32 radius_sqr = _radius * _radius;
+			query_aabb(
+			    bavil::math::AABB::FromSphere(_center, _radius),
+			    [&](bavil::Actor& _actor, const bavil::math::Vector3& _position)
+			    {
+				    using Vector3 = bavil::math::Vector3;
+				    if ( Vector3::DistanceSqr(_center, _position) <= radius_sqr )
+				    {
+					    _func(_actor);
+				    }
+			    });
+		}
+
+		/**
+		 * @brief 座標に近い順にアクターを取得する
+		 * 索引がある場合は検索する半径を格子の大きさから倍にしながら広げる
+		 * @param _result 取得したアクターを格納する配列(要素数まで取得する)
+		 * @return 取得したアクターの数
+		*/
+		size_t find_nearest_actors(const bavil::math::Vector3& _position,
+		                           std::span<bavil::Actor*>    _result) const;
+
+		/**
+		 * @brief アクターのワールド座標での境界ボックスを取得する
+		 * 境界ボックスを持たないアクターはワールド座標のみを含む境界ボックスを返す
+		*/
+		bavil::math::AABB get_world_bounds(
+		    const bavil::Actor& _actor) const noexcept;
+
+		/**
+		 * @brief 境界ボックスが重なるアクターを呼び出す
+		 * 境界ボックスを持つアクターのみを update_transforms() 時点の位置で判定する
+		 * @param _func void(Actor&)で呼び出す関数
+		*/
+		template<class Func>
+			requires(std::invocable<Func&, bavil::Actor&>)
+		void query_actors_overlapping(const bavil::math::AABB& _aabb,
+		                              Func&&                   _func) const
+		{
+			m_bounds_tree.query_aabb(_aabb, _func);
+		}
+
+		/**
+		 * @brief 半直線毎に最も近くで当たったアクターを求める
+		 * 境界ボックスを持つアクターのみを update_transforms() 時点の位置で判定する
+		 * 半直線が多い場合は TaskSystem のワーカースレッドで分けて判定する
+		 * @param _rays 判定する半直線
+		 * @param _hits 判定結果を格納する配列(_raysと同じ要素数が必要)
+		*/
+		void raycast(std::span<const bavil::math::Ray> _rays,
+		             std::span<bavil::RaycastHit>      _hits) const;
+
+		/**
+		 * @brief 半直線が最も近くで当たったアクターを求める
+		*/
+		bavil::RaycastHit raycast(const bavil::math::Ray& _ray) const;
+
+		/**
+		 * @brief tickが有効なアクターの tick() を呼び出す
+		 * スレッドセーフなアクターを TaskSystem のワーカースレッドで並列に呼び出してから、
+		 * 残りのアクターを呼び出したスレッドで順に呼び出す
+		 * 呼び出し中に登録されたアクターは次の呼び出しから呼ばれ、
+		 * 登録を解除されたアクターはそれ以降呼ばれない
+		 * @param _delta_seconds 前のフレームからの経過時間(秒)
+		*/
+		void tick(f32 _delta_seconds);
+
+		/**
+		 * @brief tick() を呼び出すアクターの数を取得する
+		*/
+		size_t get_tick_actor_num() const noexcept
+		{
+			return m_tick_actors.size() + m_parallel_tick_actors.size() -
+			       m_removed_tick_actor_num;
+		}
+
+		/**
+		 * @brief advance_fixed_step() の設定を変更する
+		 * step_seconds が正の有限の値でない場合や、max_step_num が0の場合は
+		 * std::invalid_argument を投げる
+		*/
+		void set_fixed_step_settings(const FixedStepSettings& _settings);
+
+		const FixedStepSettings& get_fixed_step_settings() const noexcept
+		{
+			return m_fixed_step_settings;
+		}
+
+		/**
+		 * @brief フレームの経過時間を溜め、固定の間隔で更新できる回数だけ更新する
+		 * 1回の更新ではトランスフォームの値を前回の値として保存してから、
+		 * tick() と update_transforms() を固定の間隔で呼び出す
+		 * 残った時間は次の呼び出しに持ち越し、補間係数として使う
+		 * @param _delta_seconds 前のフレームからの経過時間(秒)
+		 * @return 更新した回数
+		*/
+		u32 advance_fixed_step(f32 _delta_seconds)
+		{
+			return advance_fixed_step_internal(_delta_seconds, nullptr, nullptr);
+		}
+
+		/**
+		 * @brief advance_fixed_step() の各更新で tick() の後に関数を呼び出す
+		 * @param _func void(f32)で呼び出す関数(固定の間隔を渡す)
+		*/
+		template<class Func>
+			requires(std::invocable<Func&, f32>)
+		u32 advance_fixed_step(f32 _delta_seconds, Func&& _func)
+		{
+			return advance_fixed_step_internal(
+			    _delta_seconds,
+			    &_func,
+			    [](void* _context, f32 _step_seconds)
+			    {
+				    (*static_cast<std::remove_reference_t<Func>*>(_context))(
+				        _step_seconds);
+			    });
+		}
+
+		/**
+		 * @brief 前回の更新から今回の更新までの間の表示する位置の割合を取得する
+		 * @return 0で前回の更新、1で今回の更新の状態
+		*/
+		f32 get_interpolation_alpha() const noexcept
+		{
+			return m_interpolation_alpha;
+		}
+
+		/**
+		 * @brief 全てのアクターの補間した行列をまとめて計算する
+		 * 前回の更新と今回の更新の値を get_interpolation_alpha() で補間し、
+		 * 親子関係を持つアクターは補間した親の行列を掛ける
+		 * 表示の前に1回呼び出し、 get_interpolated_matrix() で取得する
+		*/
+		void update_interpolated_matrices();
+
+		/**
+		 * @brief update_interpolated_matrices() で計算した行列を取得する
+		 * 計算した後にアクターを登録、削除した場合は計算し直す必要がある
+		 * (計算した後に登録したアクターはワールド行列を返す)
+		*/
+		const bavil::math::Matrix44& get_interpolated_matrix(
+		    const bavil::Actor& _actor) const noexcept;
+
 	private:
-		std::list<bavil::Actor*> actor_lists;
+		// 並列に呼び出す時の1回の呼び出しで実行する最小のアクター数
+		static constexpr size_t PARALLEL_TICK_CHUNK_SIZE = 64;
+		// 並列に判定する時の1回の呼び出しで判定する最小の半直線の数
+		static constexpr size_t PARALLEL_RAYCAST_CHUNK_SIZE = 256;
+		// 並列に補間する時の1回の呼び出しで計算する最小の行列の数
+		static constexpr size_t PARALLEL_INTERPOLATE_CHUNK_SIZE = 256;
+
+		using StepFunction = void (*)(void* _context, f32 _step_seconds);
+
+		u32 advance_fixed_step_internal(f32          _delta_seconds,
+		                                void*        _context,
+		                                StepFunction _function);
+
+		// tickが有効なアクターを呼び出す配列に追加する
+		void register_tick(bavil::Actor* _actor);
+		// 呼び出す配列から取り除く(tick()の呼び出し中は空きにしておく)
+		void unregister_tick(bavil::Actor* _actor);
+		// tick()の呼び出し中に空きにした要素を詰める
+		void compact_tick_actors(std::pmr::vector<bavil::Actor*>& _actors);
+
+		// 索引の有無に関わらず境界ボックスに含まれるアクターを位置と共に呼び出す
+		template<class Func>
+		void query_aabb(const bavil::math::AABB& _aabb, Func&& _func) const
+		{
+			if ( m_spatial_index != nullptr )
+			{
+				m_spatial_index->query_aabb(_aabb, _func);
+				return;
+			}
+			for ( bavil::Actor* actor : m_actors )
+			{
+				const bavil::math::Vector3 position = get_world_position(*actor);
+				if ( _aabb.contains(position) )
+				{
+					_func(*actor, position);
+				}
+			}
+		}
+
+		// アクターの位置を索引に反映する
+		void update_spatial_index(bavil::Actor& _actor)
+		{
+			if ( m_spatial_index != nullptr )
+			{
+				m_spatial_index->update(_actor.m_spatial_id,
+				                        get_world_position(_actor));
+			}
+		}
+
+		// 境界ボックスを持つアクターの現在の位置を木に反映する(無い場合は追加する)
+		void update_bounds(bavil::Actor& _actor);
+		// 境界ボックスを木から取り除く
+		void unregister_bounds(bavil::Actor& _actor);
+
+		std::pmr::vector<bavil::Actor*>& get_tick_actors(
+		    const bavil::Actor& _actor) noexcept
+		{
+			return _actor.is_tick_thread_safe() ? m_parallel_tick_actors
+			                                    : m_tick_actors;
+		}
+
+	private:
+		static constexpr u32 INVALID_HIERARCHY_INDEX = static_cast<u32>(-1);
+
+		// 親子関係を持つアクターの階層の要素
+		struct HierarchyNode
+		{
+			bavil::Actor* actor = nullptr;
+			// 親の要素の位置(ルートの場合は無効)
+			u32 parent = INVALID_HIERARCHY_INDEX;
+			// 子孫の数(子孫は直後に連続して並んでいる)
+			u32 descendant_num = 0;
+			// ワールド行列の計算が必要か(親子関係が変わった時に立てる)
+			bool is_dirty = true;
+		};
+
+		// アクターの子孫を含めて階層から取り出す
+		std::pmr::vector<HierarchyNode> extract_subtree(bavil::Actor* _actor);
+		// 取り出した子孫を含むアクターを指定した位置に挿入する
+		void insert_subtree(size_t                                 _position,
+		                    const std::pmr::vector<HierarchyNode>& _subtree);
+		// 子が居なくなったルートを階層から取り除く
+		void prune_hierarchy_root(bavil::Actor* _actor);
+		// 指定した位置以降の階層の位置を振り直す
+		void renumber_hierarchy(size_t _begin);
+
+	private:
+		std::pmr::vector<bavil::Actor*> m_actors;
+		// アクターのトランスフォームの値
+		bavil::TransformStore m_transform_store;
+
+		// 親子関係を持つアクター(深さ優先の順)とワールド行列
+		std::pmr::vector<HierarchyNode>         m_hierarchy;
+		std::pmr::vector<bavil::math::Matrix44> m_world_matrices;
+		// update_transforms() でワールド行列を計算し直したか
+		std::pmr::vector<u8> m_updated_flags;
+
+		// tick() を呼び出すアクター(呼び出したスレッドで呼ぶものと並列に呼ぶもの)
+		std::pmr::vector<bavil::Actor*> m_tick_actors;
+		std::pmr::vector<bavil::Actor*> m_parallel_tick_actors;
+		size_t                          m_removed_tick_actor_num = 0;
+		bool                            m_is_ticking             = false;
+
+		bavil::SpatialIndexSettings          m_spatial_index_settings;
+		std::unique_ptr<bavil::SpatialIndex> m_spatial_index;
+
+		// 境界ボックスを持つアクターの木
+		bavil::AABBTree m_bounds_tree;
+		// update_transforms() で行列を作り直した後に木を更新するアクター
+		std::pmr::vector<bavil::Actor*> m_moved_bounds_actors;
+
+		FixedStepSettings m_fixed_step_settings;
+		// 固定の間隔に満たずに持ち越した時間
+		f32 m_fixed_step_accumulator = 0.0f;
+		f32 m_interpolation_alpha    = 1.0f;
+		// アクターの配列の順に並べた補間した行列
+		std::pmr::vector<bavil::math::Matrix44> m_interpolated_matrices;
 	};
 
 } // namespace bavil
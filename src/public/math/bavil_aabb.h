@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include "bavil_type.h"
+#include "math/bavil_matrix44.h"
+#include "math/bavil_vector3.h"
+
+namespace bavil::math
+{
+
+	/// <summary>
+	/// 軸に平行な境界ボックス構造体.
+	/// </summary>
+	struct AABB
+	{
+		using value_type = f32;
+
+		/// <summary>
+		/// 最小の座標.
+		/// </summary>
+		Vector3 min;
+		/// <summary>
+		/// 最大の座標.
+		/// </summary>
+		Vector3 max;
+
+		/// <summary>
+		/// コンストラクタ.
+		/// </summary>
+		constexpr AABB() noexcept
+		    : min()
+		    , max()
+		{
+		}
+
+		/// <summary>
+		/// コンストラクタ.
+		/// </summary>
+		/// <param name="_min">最小の座標.</param>
+		/// <param name="_max">最大の座標.</param>
+		constexpr AABB(const Vector3& _min, const Vector3& _max) noexcept
+		    : min(_min)
+		    , max(_max)
+		{
+		}
+
+		/// <summary>
+		/// 球を囲む境界ボックスを求める.
+		/// </summary>
+		/// <param name="_center">球の中心.</param>
+		/// <param name="_radius">球の半径.</param>
+		static AABB FromSphere(const Vector3& _center, value_type _radius) noexcept
+		{
+			const Vector3 extent(_radius);
+			return {_center - extent, _center + extent};
+		}
+
+		/// <summary>
+		/// 2つの境界ボックスを囲む境界ボックスを求める.
+		/// </summary>
+		static AABB Merge(const AABB& _a, const AABB& _b) noexcept
+		{
+			return {{std::min(_a.min.x, _b.min.x),
+			         std::min(_a.min.y, _b.min.y),
+			         std::min(_a.min.z, _b.min.z)},
+			        {std::max(_a.max.x, _b.max.x),
+			         std::max(_a.max.y, _b.max.y),
+			         std::max(_a.max.z, _b.max.z)}};
+		}
+
+		/// <summary>
+		/// 境界ボックスを座標変換した結果を囲む境界ボックスを求める.
+		/// <para>回転した境界ボックスの8頂点を全て含む大きさになる.</para>
+		/// </summary>
+		/// <param name="_aabb">変換する境界ボックス.</param>
+		/// <param name="_matrix">座標変換行列.</param>
+		static AABB Transform(const AABB& _aabb, const Matrix44& _matrix) noexcept
+		{
+			const Vector3 center = _aabb.get_center();
+			const Vector3 extent = _aabb.get_extent();
+
+			// 中心を変換し、半分の大きさは行列の各成分の絶対値で広げる
+			Vector3 result_center(_matrix._41, _matrix._42, _matrix._43);
+			Vector3 result_extent(0.0f);
+			for ( u32 row = 0; row < 3; ++row )
+			{
+				for ( u32 column = 0; column < 3; ++column )
+				{
+					const value_type element = _matrix.m[row][column];
+					result_center[column] += center[row] * element;
+					result_extent[column] += extent[row] * std::abs(element);
+				}
+			}
+			return {result_center - result_extent, result_center + result_extent};
+		}
+
+		/// <summary>
+		/// 全ての方向に広げた境界ボックスを求める.
+		/// </summary>
+		/// <param name="_aabb">広げる境界ボックス.</param>
+		/// <param name="_margin">広げる距離.</param>
+		static AABB Expand(const AABB& _aabb, value_type _margin) noexcept
+		{
+			const Vector3 margin(_margin);
+			return {_aabb.min - margin, _aabb.max + margin};
+		}
+
+		/// <summary>
+		/// 中心の座標を求める.
+		/// </summary>
+		Vector3 get_center() const noexcept
+		{
+			return (min + max) * 0.5f;
+		}
+
+		/// <summary>
+		/// 中心から各軸の境界までの距離を求める.
+		/// </summary>
+		Vector3 get_extent() const noexcept
+		{
+			return (max - min) * 0.5f;
+		}
+
+		/// <summary>
+		/// 表面積を求める.
+		/// </summary>
+		value_type surface_area() const noexcept
+		{
+			const Vector3 size = max - min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		/// <summary>
+		/// 座標が含まれるか判定する.
+		/// <para>境界上の座標も含む.</para>
+		/// </summary>
+		bool contains(const Vector3& _point) const noexcept
+		{
+			return min.x <= _point.x && _point.x <= max.x && min.y <= _point.y &&
+			       _point.y <= max.y && min.z <= _point.z && _point.z <= max.z;
+		}
+
+		/// <summary>
+		/// 境界ボックスが全て含まれるか判定する.
+		/// </summary>
+		bool contains(const AABB& _other) const noexcept
+		{
+			return min.x <= _other.min.x && _other.max.x <= max.x &&
+			       min.y <= _other.min.y && _other.max.y <= max.y &&
+			       min.z <= _other.min.z && _other.max.z <= max.z;
+		}
+
+		/// <summary>
+		/// 境界ボックスと重なるか判定する.
+		/// <para>境界が接している場合も重なるとする.</para>
+		/// </summary>
+		bool intersects(const AABB& _other) const noexcept
+		{
+			return min.x <= _other.max.x && _other.min.x <= max.x &&
+			       min.y <= _other.max.y && _other.min.y <= max.y &&
+			       min.z <= _other.max.z && _other.min.z <= max.z;
+		}
+	};
+
+} // namespace bavil::math
@@ -17,3 +17,5 @@
 #include <math/bavil_matrix44.h>
 #include <math/bavil_quaternion.h>
 #include <math/bavil_euler.h>
+#include <math/bavil_aabb.h>
+#include <math/bavil_ray.h>
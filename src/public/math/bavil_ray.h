@@ -0,0 +1,40 @@
+#pragma once
+
+#include <limits>
+#include "bavil_type.h"
+#include "math/bavil_vector3.h"
+
+namespace bavil::math
+{
+
+	/// <summary>
+	/// 半直線構造体.
+	/// </summary>
+	struct Ray
+	{
+		using value_type = f32;
+
+		/// <summary>
+		/// 始点.
+		/// </summary>
+		Vector3 origin;
+		/// <summary>
+		/// 方向.
+		/// <para>正規化されていない場合、距離は方向の長さを単位とする.</para>
+		/// </summary>
+		Vector3 direction;
+		/// <summary>
+		/// 判定する最大の距離.
+		/// </summary>
+		value_type max_distance = std::numeric_limits<value_type>::infinity();
+
+		/// <summary>
+		/// 指定した距離の座標を求める.
+		/// </summary>
+		Vector3 get_point(value_type _distance) const noexcept
+		{
+			return origin + direction * _distance;
+		}
+	};
+
+} // namespace bavil::math
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <core/bavil_actor_pool_system.h>
+#include <core/bavil_entity_system.h>
+#include <core/bavil_object_system.h>
+#include <core/bavil_world_system.h>
+
+#include <vector>
+
+namespace
+{
+	class PooledActor : public bavil::Actor
+	{
+	public:
+		virtual void construct() override
+		{
+			Actor::construct();
+			construct_num++;
+		}
+
+		virtual void destruct() override
+		{
+			Actor::destruct();
+			s_destruct_num++;
+		}
+
+		virtual void reset() override
+		{
+			reset_num++;
+			hit_points = 0;
+		}
+
+		virtual void reactivate() override
+		{
+			reactivate_num++;
+			hit_points = 100;
+			spawn_position = get_transform().get_position();
+		}
+
+		static inline int s_destruct_num = 0;
+
+		int                  construct_num  = 0;
+		int                  reset_num      = 0;
+		int                  reactivate_num = 0;
+		int                  hit_points     = 100;
+		bavil::math::Vector3 spawn_position;
+	};
+} // namespace
+
+// 第1引数がテストケース名、第2引数がテスト名
+TEST(ActorPoolSystemTest, SpawnTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system = bavil::WorldSystem::Get();
+	auto& pool_system  = bavil::ActorPoolSystem::Get();
+
+	// 事前に生成したアクターはワールドに登録されていない
+	pool_system.configure<PooledActor>({.warm_num = 4, .max_free_num = 6});
+	ASSERT_EQ(pool_system.get_free_num<PooledActor>(), 4);
+	ASSERT_EQ(world_system.get_actor_num(), 0);
+
+	// 取り出したアクターは登録され、書き込んだ位置で reactivate() が呼ばれる
+	const bavil::math::Vector3 position(1.0f, 2.0f, 3.0f);
+	auto actor = pool_system.spawn<PooledActor>(position);
+	ASSERT_EQ(pool_system.get_free_num<PooledActor>(), 3);
+	ASSERT_TRUE(actor->is_in_world());
+	ASSERT_EQ(actor->construct_num, 1);
+	ASSERT_EQ(actor->reactivate_num, 1);
+	ASSERT_EQ(actor->spawn_position.x, position.x);
+	ASSERT_EQ(actor->get_transform().get_position().z, position.z);
+
+	// 返却したアクターはワールドから外れ、次の生成で同じアクターを使う
+	PooledActor* const pooled = actor.get_object();
+	actor->hit_points         = 10;
+	actor->set_local_bounds({bavil::math::Vector3(-1.0f),
+	                         bavil::math::Vector3(1.0f)});
+	pool_system.despawn(std::move(actor));
+	ASSERT_FALSE(pooled->is_in_world());
+	ASSERT_EQ(pooled->reset_num, 1);
+	ASSERT_EQ(pooled->hit_points, 0);
+	ASSERT_EQ(pool_system.get_free_num<PooledActor>(), 4);
+	ASSERT_EQ(world_system.get_actor_num(), 0);
+	ASSERT_FALSE(world_system.raycast({bavil::math::Vector3(0.0f, 0.0f, -5.0f),
+	                                   bavil::math::Vector3(0.0f, 0.0f, 1.0f)})
+	                 .is_hit());
+
+	auto respawned = pool_system.spawn<PooledActor>(bavil::math::Vector3(5.0f));
+	ASSERT_EQ(respawned.get_object(), pooled);
+	ASSERT_EQ(respawned->construct_num, 1);
+	ASSERT_EQ(respawned->reactivate_num, 2);
+	ASSERT_EQ(respawned->hit_points, 100);
+	ASSERT_EQ(respawned->get_transform().get_position().x, 5.0f);
+	ASSERT_EQ(world_system.get_actor_num(), 1);
+
+	// 境界ボックスは保持しているので、登録し直すと判定の対象に戻る
+	world_system.update_transforms();
+	ASSERT_TRUE(world_system.raycast({bavil::math::Vector3(5.0f, 5.0f, 0.0f),
+	                                  bavil::math::Vector3(0.0f, 0.0f, 1.0f)})
+	                .is_hit());
+
+	// 他にハンドルが残っている場合は積まれず、再利用されない
+	bavil::ObjectHandle<PooledActor> copy    = respawned;
+	const bavil::ObjectBinding       binding = copy.get_binding();
+	pool_system.despawn(std::move(respawned));
+	ASSERT_EQ(pool_system.get_free_num<PooledActor>(), 3);
+	ASSERT_TRUE(copy->is_in_world());
+	ASSERT_TRUE(binding.is_alive());
+
+	auto other = pool_system.spawn<PooledActor>(bavil::math::Vector3(7.0f));
+	ASSERT_NE(other.get_object(), copy.get_object());
+	ASSERT_EQ(copy->get_transform().get_position().x, 5.0f);
+
+	// 最後のハンドルを返却すると積まれ、取得済みの ObjectBinding は無効になる
+	pool_system.despawn(std::move(copy));
+	ASSERT_EQ(pool_system.get_free_num<PooledActor>(), 3);
+	ASSERT_FALSE(binding.is_alive());
+	ASSERT_EQ(pooled->reset_num, 2);
+
+	// 同じアクターのハンドルを全て返却しても1回だけ積まれる
+	bavil::ObjectHandle<PooledActor> stale = other;
+	pool_system.despawn(std::move(other));
+	pool_system.despawn(std::move(stale));
+	ASSERT_EQ(pool_system.get_free_num<PooledActor>(), 4);
+
+	system_manager.finalize();
+}
+
+TEST(ActorPoolSystemTest, CapacityTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system  = bavil::WorldSystem::Get();
+	auto& pool_system   = bavil::ActorPoolSystem::Get();
+	auto& object_system = bavil::ObjectSystem::Get();
+
+	PooledActor::s_destruct_num = 0;
+	pool_system.configure<PooledActor>({.warm_num = 0, .max_free_num = 2});
+
+	// 未使用のアクターが無い場合は新しく生成する
+	std::vector<bavil::ObjectHandle<PooledActor>> actors;
+	for ( int i = 0; i < 5; ++i )
+	{
+		actors.push_back(pool_system.spawn<PooledActor>(
+		    bavil::math::Vector3(static_cast<float>(i), 0.0f, 0.0f)));
+		ASSERT_EQ(actors.back()->reactivate_num, 0);
+		ASSERT_EQ(actors.back()->get_transform().get_position().x,
+		          static_cast<float>(i));
+	}
+	ASSERT_EQ(world_system.get_actor_num(), 5);
+	ASSERT_EQ(object_system.get_object_num(), 5);
+
+	// 最大数を超えて返却したアクターは削除される
+	for ( auto& actor : actors )
+	{
+		pool_system.despawn(std::move(actor));
+	}
+	ASSERT_EQ(pool_system.get_free_num<PooledActor>(), 2);
+	ASSERT_EQ(PooledActor::s_destruct_num, 3);
+	ASSERT_EQ(world_system.get_actor_num(), 0);
+
+	// 設定を変えると未使用のアクターを増減する
+	pool_system.configure<PooledActor>({.warm_num = 1, .max_free_num = 1});
+	ASSERT_EQ(pool_system.get_free_num<PooledActor>(), 1);
+	ASSERT_EQ(PooledActor::s_destruct_num, 4);
+
+	// 返却時にブリッジしたエンティティも破棄する
+	auto& entity_system = bavil::EntitySystem::Get();
+	auto  actor = pool_system.spawn<PooledActor>(bavil::math::Vector3());
+	const bavil::Entity entity = entity_system.bridge_actor(*actor.get_object());
+	pool_system.despawn(std::move(actor));
+	ASSERT_FALSE(entity_system.is_alive(entity));
+
+	// 終了時に未使用のアクターも削除する
+	system_manager.finalize();
+	ASSERT_EQ(PooledActor::s_destruct_num, 5);
+}
@@ -1,12 +1,73 @@
 #include <gtest/gtest.h>
+#include <core/bavil_delegate.h>
 #include <core/bavil_multicast_delegate.h>
+#include <core/bavil_concurrent_multicast_delegate.h>
+#include <core/bavil_object_system.h>
+#include <core/bavil_task_system.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 // TESTマクロを使う場合
 
 namespace
 {
 	const char* SEND_MESSAGE = "[hogehoge]";
-}
+
+	class ListenerObject : public bavil::ObjectBase
+	{
+	public:
+		void on_event(int _value)
+		{
+			received_sum += _value;
+		}
+
+		int get_doubled(int _value) const
+		{
+			return _value * 2 + received_sum;
+		}
+
+		int received_sum = 0;
+
+	protected:
+		void construct() override {}
+		void destruct() override {}
+	};
+	class DamageObject : public bavil::ObjectBase
+	{
+	public:
+		void on_damage(int _damage)
+		{
+			hit_points -= _damage;
+			s_damage_num++;
+			// 倒れたら自身のハンドルを手放して破棄する
+			if ( hit_points <= 0 && on_down )
+			{
+				on_down();
+			}
+		}
+
+		static inline int s_damage_num = 0;
+
+		int                   hit_points = 10;
+		std::function<void()> on_down;
+
+	protected:
+		void construct() override {}
+		void destruct() override {}
+	};
+	int add_one(int _value)
+	{
+		return _value + 1;
+	}
+} // namespace
 
 // 第1引数がテストケース名、第2引数がテスト名
 TEST(MulticastDelegateTest, Function1Test)
@@ -34,3 +95,668 @@ TEST(MulticastDelegateTest, Function1Test)
 	ASSERT_EQ(events.is_valid(handle), false);
 	ASSERT_EQ(events.has_delegates(), false);
 }
+
+TEST(MulticastDelegateTest, RemoveTest)
+{
+	bavil::MulticastDelegate<void(std::string)> events;
+
+	std::vector<std::string>           received;
+	std::vector<bavil::DelegateHandle> handles;
+	for ( int i = 0; i < 4; ++i )
+	{
+		handles.push_back(events.add(
+		    [&received, i](std::string _message)
+		    {
+			    received.push_back(_message + std::to_string(i));
+		    }));
+	}
+
+	// 途中の要素を削除しても残りのハンドルは有効
+	events.remove(handles[1]);
+	ASSERT_FALSE(events.is_valid(handles[1]));
+	ASSERT_TRUE(events.is_valid(handles[0]));
+	ASSERT_TRUE(events.is_valid(handles[2]));
+	ASSERT_TRUE(events.is_valid(handles[3]));
+	ASSERT_EQ(events.get_delegate_num(), 3);
+
+	// 全てのデリゲートに同じ引数が渡る
+	events.broadcast("message");
+	std::sort(received.begin(), received.end());
+	ASSERT_EQ(received,
+	          std::vector<std::string>({"message0", "message2", "message3"}));
+
+	events.remove(handles[3]);
+	events.remove(handles[0]);
+	events.remove(handles[0]);
+	ASSERT_EQ(events.get_delegate_num(), 1);
+	ASSERT_TRUE(events.is_valid(handles[2]));
+
+	events.clear();
+	ASSERT_FALSE(events.has_delegates());
+}
+
+TEST(MulticastDelegateTest, HandleTest)
+{
+	bavil::MulticastDelegate<void()> events;
+	bavil::MulticastDelegate<void()> other_events;
+
+	ASSERT_FALSE(bavil::DelegateHandle().is_valid());
+
+	// ハンドルはデリゲート毎に発行される
+	auto handle       = events.add([]() {});
+	auto other_handle = other_events.add([]() {});
+	ASSERT_EQ(handle, other_handle);
+
+	// 削除したスロットを再利用しても古いハンドルは無効
+	events.remove(handle);
+	auto new_handle = events.add([]() {});
+	ASSERT_EQ(new_handle.index, handle.index);
+	ASSERT_FALSE(events.is_valid(handle));
+	ASSERT_TRUE(events.is_valid(new_handle));
+
+	events.remove(handle);
+	ASSERT_EQ(events.get_delegate_num(), 1);
+}
+
+TEST(MulticastDelegateTest, InlineFunctionTest)
+{
+	// デフォルトのサイズでは1キャッシュライン(64バイト)に収まる
+	static_assert(sizeof(bavil::InlineFunction<void(int)>) == 64);
+
+	int                              sum  = 0;
+	bavil::InlineFunction<void(int)> func = [&sum](int _value)
+	{
+		sum += _value;
+	};
+	ASSERT_TRUE(static_cast<bool>(func));
+	func(3);
+	ASSERT_EQ(sum, 3);
+
+	// ムーブ出来ない型を含むキャプチャでもムーブで保持できる
+	auto                         value = std::make_unique<int>(5);
+	bavil::InlineFunction<int()> owner = [value = std::move(value)]()
+	{
+		return *value;
+	};
+	bavil::InlineFunction<int()> moved = std::move(owner);
+	ASSERT_FALSE(static_cast<bool>(owner));
+	ASSERT_EQ(moved(), 5);
+
+	moved = nullptr;
+	ASSERT_FALSE(static_cast<bool>(moved));
+}
+
+TEST(MulticastDelegateTest, InlineMulticastDelegateTest)
+{
+	bavil::InlineMulticastDelegate<void(int)> events;
+
+	int  sum    = 0;
+	auto handle = events.add(
+	    [&sum](int _value)
+	    {
+		    sum += _value;
+	    });
+	events.add(
+	    [&sum](int _value)
+	    {
+		    sum += _value * 10;
+	    });
+
+	events.broadcast(2);
+	ASSERT_EQ(sum, 22);
+
+	events.remove(handle);
+	events.broadcast(1);
+	ASSERT_EQ(sum, 32);
+}
+
+TEST(MulticastDelegateTest, ReentrantTest)
+{
+	bavil::MulticastDelegate<void(int)> events;
+
+	std::vector<int>      called;
+	bavil::DelegateHandle self_handle;
+	bavil::DelegateHandle other_handle;
+	bavil::DelegateHandle added_handle;
+
+	// 自分自身と他のデリゲートを削除し、新しいデリゲートを登録する
+	self_handle = events.add(
+	    [&](int _value)
+	    {
+		    called.push_back(0);
+		    events.remove(self_handle);
+		    events.remove(other_handle);
+		    added_handle = events.add(
+		        [&](int)
+		        {
+			        called.push_back(2);
+		        });
+
+		    // 入れ子のブロードキャスト
+		    if ( _value > 0 )
+		    {
+			    events.broadcast(_value - 1);
+		    }
+	    });
+	other_handle = events.add(
+	    [&](int)
+	    {
+		    called.push_back(1);
+	    });
+
+	events.broadcast(1);
+
+	// 削除したデリゲートは呼ばれず、登録したデリゲートはブロードキャスト後に有効になる
+	ASSERT_EQ(called, std::vector<int>({0}));
+	ASSERT_FALSE(events.is_valid(self_handle));
+	ASSERT_FALSE(events.is_valid(other_handle));
+	ASSERT_TRUE(events.is_valid(added_handle));
+	ASSERT_EQ(events.get_delegate_num(), 1);
+
+	called.clear();
+	events.broadcast(0);
+	ASSERT_EQ(called, std::vector<int>({2}));
+
+	// ブロードキャスト中のクリア
+	events.add(
+	    [&](int)
+	    {
+		    events.clear();
+		    events.add([](int) {});
+	    });
+	events.broadcast(0);
+	ASSERT_EQ(events.get_delegate_num(), 1);
+}
+
+TEST(MulticastDelegateTest, ConcurrentTest)
+{
+	bavil::ConcurrentMulticastDelegate<void(std::atomic<int>&)> events;
+
+	auto handle = events.add(
+	    [](std::atomic<int>& _count)
+	    {
+		    _count++;
+	    });
+	ASSERT_TRUE(events.is_valid(handle));
+	ASSERT_EQ(events.get_delegate_num(), 1);
+
+	constexpr int THREAD_NUM    = 8;
+	constexpr int BROADCAST_NUM = 2000;
+
+	std::atomic<int>         count = 0;
+	std::atomic<bool>        stop  = false;
+	std::vector<std::thread> threads;
+	for ( int i = 0; i < THREAD_NUM; ++i )
+	{
+		threads.emplace_back(
+		    [&]()
+		    {
+			    for ( int j = 0; j < BROADCAST_NUM; ++j )
+			    {
+				    events.broadcast(count);
+			    }
+		    });
+	}
+
+	// ブロードキャスト中に別のスレッドから登録と削除を繰り返す
+	std::thread writer(
+	    [&]()
+	    {
+		    while ( !stop )
+		    {
+			    auto temp = events.add([](std::atomic<int>&) {});
+			    events.remove(temp);
+		    }
+	    });
+
+	for ( auto& thread : threads )
+	{
+		thread.join();
+	}
+	stop = true;
+	writer.join();
+
+	ASSERT_EQ(count, THREAD_NUM * BROADCAST_NUM);
+	ASSERT_EQ(events.get_delegate_num(), 1);
+
+	// ブロードキャスト中に自分自身を削除する
+	events.add(
+	    [&](std::atomic<int>&)
+	    {
+		    events.remove(handle);
+	    });
+	events.broadcast(count);
+	ASSERT_FALSE(events.is_valid(handle));
+
+	events.clear();
+	ASSERT_FALSE(events.has_delegates());
+}
+
+TEST(MulticastDelegateTest, MemberTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& object_system = bavil::ObjectSystem::Get();
+
+	bavil::MulticastDelegate<void(int)> events;
+
+	auto listener = object_system.create_object<ListenerObject>();
+	auto handle   = events.add_member<&ListenerObject::on_event>(listener);
+
+	// 登録してもオブジェクトの参照数は増えない
+	ASSERT_EQ(listener.get_reference_count(), 1);
+	ASSERT_TRUE(events.is_valid(handle));
+
+	events.broadcast(3);
+	ASSERT_EQ(listener->received_sum, 3);
+
+	events.remove(handle);
+	events.broadcast(3);
+	ASSERT_EQ(listener->received_sum, 3);
+
+	// オブジェクトが破棄されたら次のブロードキャストで削除される
+	{
+		auto temp = object_system.create_object<ListenerObject>();
+		handle    = events.add_member<&ListenerObject::on_event>(temp);
+		events.add_member<&ListenerObject::on_event>(listener);
+		events.broadcast(1);
+		ASSERT_EQ(temp->received_sum, 1);
+	}
+	ASSERT_TRUE(events.is_valid(handle));
+	events.broadcast(1);
+	ASSERT_FALSE(events.is_valid(handle));
+	ASSERT_EQ(events.get_delegate_num(), 1);
+	ASSERT_EQ(listener->received_sum, 5);
+
+	// ブロードキャスト中に破棄されたオブジェクトは呼ばれない
+	auto victim = std::make_unique<bavil::ObjectHandle<ListenerObject>>(
+	    object_system.create_object<ListenerObject>());
+	events.clear();
+	events.add(
+	    [&](int)
+	    {
+		    victim.reset();
+	    });
+	events.add_member<&ListenerObject::on_event>(*victim);
+	events.broadcast(1);
+	ASSERT_EQ(events.get_delegate_num(), 1);
+
+	system_manager.finalize();
+}
+
+TEST(MulticastDelegateTest, QueueTest)
+{
+	using Events = bavil::MulticastDelegate<void(int, const std::string&)>;
+
+	Events events;
+
+	std::vector<int> received;
+	events.add(
+	    [&](int _value, const std::string&)
+	    {
+		    received.push_back(_value);
+	    });
+
+	size_t batch_num   = 0;
+	size_t batch_count = 0;
+	auto   batch       = events.add_batch(
+        [&](std::span<const Events::Payload> _payloads)
+        {
+            batch_num += _payloads.size();
+            batch_count++;
+        });
+
+	ASSERT_TRUE(events.is_valid(batch));
+	ASSERT_EQ(events.get_delegate_num(), 2);
+
+	// flush() するまで呼ばれない
+	events.queue(1, "a");
+	events.queue(2, "b");
+	events.queue(3, "c");
+	ASSERT_EQ(events.get_queued_num(), 3);
+	ASSERT_TRUE(received.empty());
+
+	events.flush();
+	ASSERT_EQ(received, (std::vector<int>{1, 2, 3}));
+	ASSERT_EQ(batch_num, 3);
+	ASSERT_EQ(batch_count, 1);
+	ASSERT_EQ(events.get_queued_num(), 0);
+
+	// 積まれていなければ何もしない
+	events.flush();
+	ASSERT_EQ(batch_count, 1);
+
+	// broadcast() ではまとめて受け取るデリゲートは呼ばれない
+	events.broadcast(4, "d");
+	ASSERT_EQ(received.size(), 4);
+	ASSERT_EQ(batch_count, 1);
+
+	// 呼び出し中に積んだ引数は次の flush() で呼ばれる
+	events.add(
+	    [&](int _value, const std::string&)
+	    {
+		    if ( _value == 5 )
+		    {
+			    events.queue(6, "f");
+		    }
+	    });
+	events.queue(5, "e");
+	events.flush();
+	ASSERT_EQ(received.back(), 5);
+	ASSERT_EQ(events.get_queued_num(), 1);
+	events.flush();
+	ASSERT_EQ(received.back(), 6);
+
+	events.remove(batch);
+	ASSERT_FALSE(events.is_valid(batch));
+	ASSERT_EQ(events.get_delegate_num(), 2);
+
+	events.queue(7, "g");
+	events.clear_queue();
+	events.flush();
+	ASSERT_EQ(received.back(), 6);
+	ASSERT_EQ(batch_num, 5);
+}
+
+TEST(MulticastDelegateTest, QueueDestroyTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& object_system = bavil::ObjectSystem::Get();
+
+	bavil::MulticastDelegate<void(int)> events;
+
+	// 呼び出し中に破棄されたオブジェクトは残りの引数で呼ばれない
+	auto target = std::make_unique<bavil::ObjectHandle<DamageObject>>(
+	    object_system.create_object<DamageObject>());
+	(*target)->on_down = [&]()
+	{
+		target.reset();
+	};
+	DamageObject::s_damage_num = 0;
+	events.add_member<&DamageObject::on_damage>(*target);
+	events.queue(10);
+	events.queue(10);
+	events.queue(10);
+	events.flush();
+	ASSERT_EQ(target, nullptr);
+	ASSERT_EQ(DamageObject::s_damage_num, 1);
+	ASSERT_EQ(events.get_delegate_num(), 0);
+
+	// 呼び出し中に削除したデリゲートも残りの引数で呼ばれない
+	std::vector<int>      received;
+	bavil::DelegateHandle handle;
+	handle = events.add(
+	    [&](int _value)
+	    {
+		    received.push_back(_value);
+		    events.remove(handle);
+	    });
+	events.queue(1);
+	events.queue(2);
+	events.flush();
+	ASSERT_EQ(received, (std::vector<int>{1}));
+
+	// 呼び出し中に例外が投げられても、次の flush() は呼び出せる
+	bavil::MulticastDelegate<void(int)> throw_events;
+	std::vector<int>                    thrown;
+	throw_events.add(
+	    [&](int _value)
+	    {
+		    thrown.push_back(_value);
+		    if ( _value == 1 )
+		    {
+			    throw std::runtime_error("flush");
+		    }
+	    });
+	throw_events.queue(1);
+	throw_events.queue(2);
+	ASSERT_THROW(throw_events.flush(), std::runtime_error);
+	ASSERT_EQ(throw_events.get_queued_num(), 0);
+	throw_events.queue(3);
+	throw_events.flush();
+	ASSERT_EQ(thrown, (std::vector<int>{1, 3}));
+
+	system_manager.finalize();
+}
+
+TEST(MulticastDelegateTest, ParallelTest)
+{
+	bavil::core::SystemManager system_manager = {};
+	bavil::TaskSystem::Get().set_worker_num(3);
+
+	bavil::MulticastDelegate<void(int)> events;
+
+	constexpr size_t              LISTENER_NUM = 1000;
+	std::vector<std::atomic<int>> counts(LISTENER_NUM);
+	for ( size_t i = 0; i < LISTENER_NUM; ++i )
+	{
+		events.add(
+		    [&counts, i](int _value)
+		    {
+			    counts[i] += _value;
+		    },
+		    bavil::DelegateFlags::ThreadSafe);
+	}
+
+	// スレッドセーフでないデリゲートは呼び出したスレッドから呼ばれる
+	const auto caller_id = std::this_thread::get_id();
+	int        serial_num = 0;
+	events.add(
+	    [&](int)
+	    {
+		    ASSERT_EQ(std::this_thread::get_id(), caller_id);
+		    serial_num++;
+	    });
+
+	events.broadcast_parallel(2);
+	for ( const auto& count : counts )
+	{
+		ASSERT_EQ(count, 2);
+	}
+	ASSERT_EQ(serial_num, 1);
+
+	// 登録数が少ない場合は呼び出したスレッドで順に呼び出す
+	bavil::MulticastDelegate<void(int)> small_events;
+	small_events.add(
+	    [&](int)
+	    {
+		    ASSERT_EQ(std::this_thread::get_id(), caller_id);
+		    serial_num++;
+	    },
+	    bavil::DelegateFlags::ThreadSafe);
+	small_events.broadcast_parallel(1);
+	ASSERT_EQ(serial_num, 2);
+
+	system_manager.finalize();
+}
+
+TEST(MulticastDelegateTest, ParallelPriorityTest)
+{
+	bavil::core::SystemManager system_manager = {};
+	bavil::TaskSystem::Get().set_worker_num(3);
+
+	bavil::MulticastDelegate<void()> events;
+
+	// 優先度の高いデリゲートを全て呼び出してから、次の優先度に進む
+	constexpr int    LISTENER_NUM = 300;
+	std::atomic<int> high_num     = 0;
+	std::atomic<int> low_num      = 0;
+	std::atomic<int> order_error  = 0;
+	int              middle_num   = 0;
+	for ( int i = 0; i < LISTENER_NUM; ++i )
+	{
+		events.add(
+		    [&]()
+		    {
+			    if ( low_num != 0 || middle_num != 0 )
+			    {
+				    ++order_error;
+			    }
+			    ++high_num;
+		    },
+		    10,
+		    bavil::DelegateFlags::ThreadSafe);
+		events.add(
+		    [&]()
+		    {
+			    if ( high_num != LISTENER_NUM || middle_num != 1 )
+			    {
+				    ++order_error;
+			    }
+			    ++low_num;
+		    },
+		    -10,
+		    bavil::DelegateFlags::ThreadSafe);
+	}
+	events.add(
+	    [&]()
+	    {
+		    if ( high_num != LISTENER_NUM || low_num != 0 )
+		    {
+			    ++order_error;
+		    }
+		    ++middle_num;
+	    });
+
+	events.broadcast_parallel();
+	ASSERT_EQ(high_num, LISTENER_NUM);
+	ASSERT_EQ(middle_num, 1);
+	ASSERT_EQ(low_num, LISTENER_NUM);
+	ASSERT_EQ(order_error, 0);
+
+	system_manager.finalize();
+}
+
+TEST(DelegateTest, BindTest)
+{
+	// デフォルトのサイズでは1キャッシュライン(64バイト)に収まる
+	static_assert(sizeof(bavil::Delegate<int(int)>) == 64);
+
+	bavil::Delegate<int(int)> query;
+	ASSERT_FALSE(query.is_bound());
+
+	// 関数
+	query.bind_static<&add_one>();
+	ASSERT_TRUE(query.is_bound());
+	ASSERT_EQ(query.execute(1), 2);
+
+	query.bind(&add_one);
+	ASSERT_EQ(query(2), 3);
+
+	// ラムダ式
+	int offset = 10;
+	query.bind(
+	    [&offset](int _value)
+	    {
+		    return _value + offset;
+	    });
+	ASSERT_EQ(query.execute(1), 11);
+
+	// メンバ関数
+	ListenerObject listener;
+	listener.received_sum = 5;
+	query.bind_member<&ListenerObject::get_doubled>(&listener);
+	ASSERT_EQ(query.execute(1), 7);
+
+	// ムーブすると元のデリゲートは空になる
+	bavil::Delegate<int(int)> moved = std::move(query);
+	ASSERT_FALSE(query.is_bound());
+	ASSERT_EQ(moved.execute(2), 9);
+
+	moved.unbind();
+	ASSERT_FALSE(moved.is_bound());
+
+	// 戻り値の無いデリゲートは登録されている場合のみ呼び出せる
+	int                        sum = 0;
+	bavil::Delegate<void(int)> callback;
+	ASSERT_FALSE(callback.execute_if_bound(1));
+	callback = [&sum](int _value)
+	{
+		sum += _value;
+	};
+	ASSERT_TRUE(callback.execute_if_bound(3));
+	ASSERT_EQ(sum, 3);
+}
+
+TEST(MulticastDelegateTest, PriorityTest)
+{
+	bavil::MulticastDelegate<void()> events;
+
+	std::vector<int> order;
+	auto             push = [&order](int _value)
+	{
+		return [&order, _value]()
+		{
+			order.push_back(_value);
+		};
+	};
+
+	// 優先度の高い順に呼ばれ、同じ優先度は登録した順に呼ばれる
+	events.add(push(3), -10);
+	auto second = events.add(push(1), 10);
+	events.add(push(2));
+	events.add(push(4), -10);
+	events.add(push(0), 100);
+
+	events.broadcast();
+	ASSERT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+
+	// 削除しても残りの順番は変わらない
+	events.remove(second);
+	order.clear();
+	events.broadcast();
+	ASSERT_EQ(order, (std::vector<int>{0, 2, 3, 4}));
+
+	// ブロードキャスト中の登録も優先度の位置に入る
+	bool is_added = false;
+	events.add(
+	    [&]()
+	    {
+		    if ( !is_added )
+		    {
+			    is_added = true;
+			    events.add(push(1), 10);
+		    }
+	    },
+	    -100);
+	events.broadcast();
+	order.clear();
+	events.broadcast();
+	ASSERT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(MulticastDelegateTest, ConsumeTest)
+{
+	bavil::MulticastDelegate<bool(int)> events;
+
+	std::vector<int> called;
+	events.add(
+	    [&](int)
+	    {
+		    called.push_back(0);
+		    return false;
+	    },
+	    10);
+	events.add(
+	    [&](int _value)
+	    {
+		    // 負の値はここで止める
+		    called.push_back(1);
+		    return _value < 0;
+	    });
+	events.add(
+	    [&](int)
+	    {
+		    called.push_back(2);
+		    return false;
+	    },
+	    -10);
+
+	ASSERT_FALSE(events.broadcast(1));
+	ASSERT_EQ(called, (std::vector<int>{0, 1, 2}));
+
+	called.clear();
+	ASSERT_TRUE(events.broadcast(-1));
+	ASSERT_EQ(called, (std::vector<int>{0, 1}));
+}
@@ -0,0 +1,327 @@
+#include <gtest/gtest.h>
+#include <core/bavil_entity_system.h>
+#include <core/bavil_object_system.h>
+#include <core/bavil_task_system.h>
+#include <core/bavil_world_system.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	struct Position
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+	};
+
+	struct Velocity
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+	};
+
+	// 移動や破棄で数が合っているかを調べる為に、生存数を数える
+	struct Tracked
+	{
+		static inline int s_live_num = 0;
+
+		Tracked()
+		    : value(std::make_unique<int>(0))
+		{
+			++s_live_num;
+		}
+		explicit Tracked(int _value)
+		    : value(std::make_unique<int>(_value))
+		{
+			++s_live_num;
+		}
+		Tracked(Tracked&& _other) noexcept
+		    : value(std::move(_other.value))
+		{
+			++s_live_num;
+		}
+		Tracked& operator=(Tracked&& _other) noexcept
+		{
+			value = std::move(_other.value);
+			return *this;
+		}
+		~Tracked()
+		{
+			--s_live_num;
+		}
+
+		std::unique_ptr<int> value;
+	};
+
+	// 1つでチャンクに収まらないコンポーネント
+	struct Huge
+	{
+		std::byte data[bavil::EntitySystem::CHUNK_SIZE] = {};
+	};
+
+	template<class T>
+	struct ChunkReader
+	{
+		void operator()(std::span<const bavil::Entity>, std::span<T>) const
+		{
+		}
+	};
+
+	// 型を指定してチャンクを辿れるか
+	template<class System, class T>
+	concept CanForEachChunk = requires(System& _system, ChunkReader<T> _func) {
+		_system.template for_each_chunk<T>(_func);
+	};
+} // namespace
+
+// 第1引数がテストケース名、第2引数がテスト名
+TEST(EntitySystemTest, LifecycleTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& entity_system = bavil::EntitySystem::Get();
+
+	const bavil::Entity entity0 =
+	    entity_system.create_entity(Position{1.0f, 2.0f, 3.0f});
+	const bavil::Entity entity1 = entity_system.create_entity(
+	    Position{4.0f, 5.0f, 6.0f}, Velocity{1.0f, 0.0f, 0.0f});
+	const bavil::Entity entity2 = entity_system.create_entity();
+	ASSERT_EQ(entity_system.get_entity_num(), 3);
+	ASSERT_TRUE(entity_system.is_alive(entity0));
+	ASSERT_TRUE(entity_system.has_component<Velocity>(entity1));
+	ASSERT_FALSE(entity_system.has_component<Velocity>(entity0));
+	ASSERT_FALSE(entity_system.has_component<Position>(entity2));
+	ASSERT_EQ(entity_system.get_component<Position>(entity1)->y, 5.0f);
+	ASSERT_EQ(entity_system.get_component<Velocity>(entity0), nullptr);
+
+	// 破棄した番号は世代を変えて再利用する
+	entity_system.destroy_entity(entity0);
+	ASSERT_FALSE(entity_system.is_alive(entity0));
+	ASSERT_EQ(entity_system.get_component<Position>(entity0), nullptr);
+	entity_system.destroy_entity(entity0);
+	ASSERT_EQ(entity_system.get_entity_num(), 2);
+
+	const bavil::Entity entity3 = entity_system.create_entity(Position{});
+	ASSERT_EQ(entity3.index, entity0.index);
+	ASSERT_NE(entity3.generation, entity0.generation);
+	ASSERT_FALSE(entity_system.is_alive(entity0));
+	ASSERT_TRUE(entity_system.is_alive(entity3));
+	ASSERT_FALSE(entity_system.is_alive(bavil::Entity()));
+
+	system_manager.finalize();
+}
+
+TEST(EntitySystemTest, ComponentTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& entity_system = bavil::EntitySystem::Get();
+
+	// 複数のチャンクにまたがる数を生成し、コンポーネントの追加と削除で移す
+	constexpr int              ENTITY_NUM = 3000;
+	std::vector<bavil::Entity> entities;
+	for ( int i = 0; i < ENTITY_NUM; ++i )
+	{
+		entities.push_back(entity_system.create_entity(
+		    Position{static_cast<float>(i), 0.0f, 0.0f}, Tracked(i)));
+	}
+	ASSERT_EQ(Tracked::s_live_num, ENTITY_NUM);
+
+	for ( int i = 0; i < ENTITY_NUM; i += 2 )
+	{
+		auto& velocity = entity_system.add_component(
+		    entities[i], Velocity{static_cast<float>(i), 0.0f, 0.0f});
+		ASSERT_EQ(velocity.x, static_cast<float>(i));
+	}
+	for ( int i = 0; i < ENTITY_NUM; i += 3 )
+	{
+		entity_system.remove_component<Position>(entities[i]);
+	}
+	for ( int i = 0; i < ENTITY_NUM; i += 5 )
+	{
+		entity_system.destroy_entity(entities[i]);
+	}
+	// 既に持っている場合は置き換える
+	entity_system.add_component(entities[1], Tracked(-1));
+	ASSERT_EQ(*entity_system.get_component<Tracked>(entities[1])->value, -1);
+
+	int live_num = 0;
+	for ( int i = 0; i < ENTITY_NUM; ++i )
+	{
+		const bavil::Entity entity = entities[i];
+		if ( i % 5 == 0 )
+		{
+			ASSERT_FALSE(entity_system.is_alive(entity));
+			continue;
+		}
+		++live_num;
+		ASSERT_EQ(entity_system.has_component<Velocity>(entity), i % 2 == 0);
+		ASSERT_EQ(entity_system.has_component<Position>(entity), i % 3 != 0);
+		if ( i % 3 != 0 )
+		{
+			ASSERT_EQ(entity_system.get_component<Position>(entity)->x,
+			          static_cast<float>(i));
+		}
+		if ( i != 1 )
+		{
+			ASSERT_EQ(*entity_system.get_component<Tracked>(entity)->value, i);
+		}
+	}
+	ASSERT_EQ(entity_system.get_entity_num(), live_num);
+	ASSERT_EQ(Tracked::s_live_num, live_num);
+
+	// チャンクに収まらない組み合わせは作れず、元のコンポーネントは残る
+	const size_t archetype_num = entity_system.get_archetype_num();
+	ASSERT_THROW(entity_system.add_component(entities[1], Huge()),
+	             std::length_error);
+	ASSERT_THROW(entity_system.create_entity(Huge()), std::length_error);
+	ASSERT_EQ(entity_system.get_archetype_num(), archetype_num);
+	ASSERT_FALSE(entity_system.has_component<Huge>(entities[1]));
+	ASSERT_EQ(*entity_system.get_component<Tracked>(entities[1])->value, -1);
+
+	// 終了時に残っているコンポーネントも破棄する
+	system_manager.finalize();
+	ASSERT_EQ(Tracked::s_live_num, 0);
+}
+
+TEST(EntitySystemTest, QueryTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& entity_system = bavil::EntitySystem::Get();
+	bavil::TaskSystem::Get().set_worker_num(3);
+
+	constexpr int              ENTITY_NUM = 5000;
+	std::vector<bavil::Entity> entities;
+	for ( int i = 0; i < ENTITY_NUM; ++i )
+	{
+		const bavil::Entity entity = entity_system.create_entity(
+		    Position{static_cast<float>(i), 0.0f, 0.0f});
+		if ( i % 4 != 0 )
+		{
+			entity_system.add_component(entity, Velocity{1.0f, 2.0f, 3.0f});
+		}
+		if ( i % 7 == 0 )
+		{
+			entity_system.add_component(entity, Tracked(i));
+		}
+		entities.push_back(entity);
+	}
+	ASSERT_EQ(entity_system.get_archetype_num(), 4);
+
+	// 組み合わせを含む全てのアーキタイプを辿る
+	int position_num = 0;
+	entity_system.for_each<const Position>(
+	    [&](const Position&)
+	    {
+		    ++position_num;
+	    });
+	ASSERT_EQ(position_num, ENTITY_NUM);
+
+	// チャンクは前から詰まっていて、コンポーネントの配列は同じ長さ
+	size_t chunk_entity_num = 0;
+	entity_system.for_each_chunk<const Position, const Velocity>(
+	    [&](std::span<const bavil::Entity> _entities,
+	        std::span<const Position>      _positions,
+	        std::span<const Velocity>      _velocities)
+	    {
+		    ASSERT_FALSE(_entities.empty());
+		    ASSERT_EQ(_entities.size(), _positions.size());
+		    ASSERT_EQ(_entities.size(), _velocities.size());
+		    for ( size_t i = 0; i < _entities.size(); ++i )
+		    {
+			    ASSERT_EQ(_positions[i].x,
+			              static_cast<float>(_entities[i].index));
+		    }
+		    chunk_entity_num += _entities.size();
+	    });
+	ASSERT_EQ(chunk_entity_num, ENTITY_NUM - ENTITY_NUM / 4);
+
+	// 並列に呼び出しても全てのエンティティを1度だけ更新する
+	std::atomic<int> parallel_num = 0;
+	entity_system.parallel_for_each<Position, const Velocity>(
+	    [&](bavil::Entity _entity, Position& _position, const Velocity& _velocity)
+	    {
+		    ASSERT_TRUE(entity_system.has_component<Velocity>(_entity));
+		    _position.y += _velocity.y;
+		    ++parallel_num;
+	    });
+	ASSERT_EQ(parallel_num, ENTITY_NUM - ENTITY_NUM / 4);
+	for ( int i = 0; i < ENTITY_NUM; ++i )
+	{
+		ASSERT_EQ(entity_system.get_component<Position>(entities[i])->y,
+		          i % 4 != 0 ? 2.0f : 0.0f);
+	}
+
+	int tracked_num = 0;
+	entity_system.for_each<Tracked>(
+	    [&](bavil::Entity _entity, Tracked& _tracked)
+	    {
+		    ASSERT_EQ(*_tracked.value, _entity.index);
+		    ++tracked_num;
+	    });
+	ASSERT_EQ(tracked_num, (ENTITY_NUM + 6) / 7);
+
+	// 読み込み専用の参照からはconstを付けた型のみ辿れる
+	const bavil::EntitySystem& const_system = entity_system;
+	static_assert(CanForEachChunk<bavil::EntitySystem, Position>);
+	static_assert(CanForEachChunk<const bavil::EntitySystem, const Position>);
+	static_assert(!CanForEachChunk<const bavil::EntitySystem, Position>);
+	int const_num = 0;
+	const_system.for_each<const Position, const Velocity>(
+	    [&](const Position&, const Velocity&)
+	    {
+		    ++const_num;
+	    });
+	ASSERT_EQ(const_num, ENTITY_NUM - ENTITY_NUM / 4);
+
+	system_manager.finalize();
+}
+
+TEST(EntitySystemTest, ActorBridgeTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& object_system = bavil::ObjectSystem::Get();
+	auto& entity_system = bavil::EntitySystem::Get();
+
+	auto actor0 = object_system.create_object<bavil::Actor>();
+	auto actor1 = object_system.create_object<bavil::Actor>();
+	ASSERT_FALSE(actor0->get_entity().is_valid());
+
+	// 登録したアクターはエンティティから辿れる
+	const bavil::Entity entity0 = entity_system.bridge_actor(*actor0.get_object());
+	const bavil::Entity entity1 = entity_system.bridge_actor(*actor1.get_object());
+	ASSERT_EQ(entity_system.bridge_actor(*actor0.get_object()), entity0);
+	ASSERT_EQ(actor0->get_entity(), entity0);
+	ASSERT_EQ(entity_system.get_component<bavil::ActorComponent>(entity1)->actor,
+	          actor1.get_object());
+
+	entity_system.add_component(entity0, Velocity{0.0f, 1.0f, 0.0f});
+	int bridged_num = 0;
+	entity_system.for_each<const bavil::ActorComponent, const Velocity>(
+	    [&](const bavil::ActorComponent& _component, const Velocity&)
+	    {
+		    ASSERT_EQ(_component.actor, actor0.get_object());
+		    ++bridged_num;
+	    });
+	ASSERT_EQ(bridged_num, 1);
+
+	// エンティティを破棄するとアクターからも外れる
+	entity_system.destroy_entity(entity1);
+	ASSERT_FALSE(actor1->get_entity().is_valid());
+
+	// アクターを削除するとエンティティも破棄される
+	actor0 = bavil::ObjectHandle<bavil::Actor>();
+	ASSERT_FALSE(entity_system.is_alive(entity0));
+	ASSERT_EQ(entity_system.get_entity_num(), 0);
+
+	system_manager.finalize();
+}
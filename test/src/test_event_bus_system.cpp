@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <core/bavil_event_bus_system.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct DamageEvent
+	{
+		int target = 0;
+		int amount = 0;
+	};
+
+	struct SpawnEvent
+	{
+		int id = 0;
+	};
+} // namespace
+
+// 第1引数がテストケース名、第2引数がテスト名
+TEST(EventBusSystemTest, DispatchTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& event_bus = bavil::EventBusSystem::Get();
+
+	int  total_amount = 0;
+	int  call_num     = 0;
+	auto handle       = event_bus.subscribe<DamageEvent>(
+	    [&](std::span<const DamageEvent> _events)
+	    {
+		    call_num++;
+		    for ( const DamageEvent& event : _events )
+		    {
+			    total_amount += event.amount;
+		    }
+	    });
+
+	event_bus.publish(DamageEvent{1, 10});
+	event_bus.publish(DamageEvent{2, 20});
+
+	const DamageEvent batch[] = {{3, 30}, {4, 40}};
+	event_bus.publish_batch(std::span<const DamageEvent>(batch));
+
+	// dispatch()を呼ぶまでは配信されない
+	ASSERT_EQ(call_num, 0);
+	ASSERT_EQ(event_bus.get_queued_event_num<DamageEvent>(), 4);
+
+	event_bus.dispatch();
+	ASSERT_EQ(call_num, 1);
+	ASSERT_EQ(total_amount, 100);
+	ASSERT_EQ(event_bus.get_queued_event_num<DamageEvent>(), 0);
+
+	// イベントが無ければ呼ばれない
+	event_bus.dispatch();
+	ASSERT_EQ(call_num, 1);
+
+	event_bus.unsubscribe<DamageEvent>(handle);
+	event_bus.publish(DamageEvent{1, 10});
+	event_bus.dispatch();
+	ASSERT_EQ(call_num, 1);
+
+	system_manager.finalize();
+}
+
+TEST(EventBusSystemTest, PublishInDispatchTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& event_bus = bavil::EventBusSystem::Get();
+
+	std::vector<int> spawned;
+	event_bus.subscribe<DamageEvent>(
+	    [&](std::span<const DamageEvent> _events)
+	    {
+		    for ( const DamageEvent& event : _events )
+		    {
+			    event_bus.publish(SpawnEvent{event.target});
+		    }
+	    });
+	event_bus.subscribe<SpawnEvent>(
+	    [&](std::span<const SpawnEvent> _events)
+	    {
+		    for ( const SpawnEvent& event : _events )
+		    {
+			    spawned.push_back(event.id);
+			    // 配信中に積んだ同じ型のイベントは次の配信に回る
+			    event_bus.publish(SpawnEvent{event.id + 100});
+		    }
+	    });
+
+	event_bus.publish(DamageEvent{1, 0});
+	event_bus.dispatch<DamageEvent>();
+	event_bus.dispatch<SpawnEvent>();
+	ASSERT_EQ(spawned, std::vector<int>({1}));
+
+	event_bus.dispatch<SpawnEvent>();
+	ASSERT_EQ(spawned, std::vector<int>({1, 101}));
+
+	system_manager.finalize();
+}
+
+TEST(EventBusSystemTest, DispatchInDispatchTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& event_bus = bavil::EventBusSystem::Get();
+
+	// 配信中に同じ型を配信し直しても、配信中の配列は二重に配信されない
+	std::vector<int> received;
+	event_bus.subscribe<SpawnEvent>(
+	    [&](std::span<const SpawnEvent> _events)
+	    {
+		    for ( const SpawnEvent& event : _events )
+		    {
+			    received.push_back(event.id);
+			    if ( event.id < 10 )
+			    {
+				    event_bus.publish(SpawnEvent{event.id + 10});
+			    }
+		    }
+		    event_bus.dispatch<SpawnEvent>();
+		    event_bus.dispatch();
+	    });
+
+	event_bus.publish(SpawnEvent{1});
+	event_bus.publish(SpawnEvent{2});
+	event_bus.dispatch();
+	ASSERT_EQ(received, std::vector<int>({1, 2}));
+	ASSERT_EQ(event_bus.get_queued_event_num<SpawnEvent>(), 2);
+
+	event_bus.dispatch<SpawnEvent>();
+	ASSERT_EQ(received, std::vector<int>({1, 2, 11, 12}));
+	ASSERT_EQ(event_bus.get_queued_event_num<SpawnEvent>(), 0);
+
+	event_bus.dispatch();
+	ASSERT_EQ(received.size(), 4);
+
+	system_manager.finalize();
+}
+
+TEST(EventBusSystemTest, ThreadPublishTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& event_bus = bavil::EventBusSystem::Get();
+
+	constexpr int THREAD_NUM = 8;
+	constexpr int EVENT_NUM  = 1000;
+
+	std::vector<std::thread> threads;
+	for ( int i = 0; i < THREAD_NUM; ++i )
+	{
+		threads.emplace_back(
+		    [&event_bus, i]()
+		    {
+			    for ( int j = 0; j < EVENT_NUM; ++j )
+			    {
+				    event_bus.publish(DamageEvent{i, 1});
+			    }
+		    });
+	}
+	for ( auto& thread : threads )
+	{
+		thread.join();
+	}
+
+	size_t event_num = 0;
+	event_bus.subscribe<DamageEvent>(
+	    [&](std::span<const DamageEvent> _events)
+	    {
+		    event_num += _events.size();
+	    });
+	event_bus.dispatch();
+	ASSERT_EQ(event_num, THREAD_NUM * EVENT_NUM);
+
+	system_manager.finalize();
+}
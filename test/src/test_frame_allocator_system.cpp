@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <core/bavil_frame_allocator_system.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// 第1引数がテストケース名、第2引数がテスト名
+TEST(FrameAllocatorTest, LinearArenaTest)
+{
+	bavil::LinearArena arena(256);
+
+	ASSERT_EQ(arena.get_capacity(), 256);
+	ASSERT_EQ(arena.get_used_bytes(), 0);
+
+	void* a = arena.allocate(10, 1);
+	void* b = arena.allocate(16, 16);
+
+	ASSERT_TRUE(a != nullptr);
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(b) % 16, 0);
+	ASSERT_EQ(arena.get_overflow_count(), 0);
+
+	// 容量を超えた確保はオーバーフローブロックから行われる
+	void* c = arena.allocate(1024);
+	ASSERT_TRUE(c != nullptr);
+	ASSERT_EQ(arena.get_overflow_count(), 1);
+
+	const size_t used = arena.get_used_bytes();
+	ASSERT_GE(used, 10 + 16 + 1024);
+
+	// リセット時に最大使用量まで拡張される
+	arena.reset();
+	ASSERT_EQ(arena.get_used_bytes(), 0);
+	ASSERT_EQ(arena.get_high_water_mark(), used);
+	ASSERT_GE(arena.get_capacity(), used);
+
+	static_cast<void>(arena.allocate(1024));
+	ASSERT_EQ(arena.get_overflow_count(), 1);
+}
+
+TEST(FrameAllocatorTest, DoubleBufferTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& frame_allocator = bavil::FrameAllocatorSystem::Get();
+
+	frame_allocator.begin_frame();
+
+	int* value = frame_allocator.create<int>(10);
+	ASSERT_EQ(*value, 10);
+
+	auto values = frame_allocator.allocate_array<float>(16);
+	ASSERT_EQ(values.size(), 16);
+
+	// 次のフレームまではメモリが有効
+	frame_allocator.begin_frame();
+	ASSERT_EQ(*value, 10);
+	ASSERT_EQ(frame_allocator.get_statistics().used_bytes, 0);
+
+	frame_allocator.begin_frame();
+	ASSERT_GE(frame_allocator.get_statistics().high_water_mark,
+	          sizeof(int) + sizeof(float) * 16);
+
+	system_manager.finalize();
+}
+
+TEST(FrameAllocatorTest, MemoryResourceTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& frame_allocator = bavil::FrameAllocatorSystem::Get();
+
+	frame_allocator.begin_frame();
+	{
+		std::pmr::vector<int> values(frame_allocator.get_memory_resource());
+		for ( int i = 0; i < 100; ++i )
+		{
+			values.push_back(i);
+		}
+		ASSERT_EQ(values[99], 99);
+	}
+	ASSERT_GE(frame_allocator.get_statistics().used_bytes, sizeof(int) * 100);
+
+	system_manager.finalize();
+}
+
+TEST(FrameAllocatorTest, ThreadArenaTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& frame_allocator = bavil::FrameAllocatorSystem::Get();
+
+	frame_allocator.begin_frame();
+
+	bavil::LinearArena* main_arena   = &frame_allocator.get_thread_arena();
+	bavil::LinearArena* worker_arena = nullptr;
+
+	std::thread worker(
+	    [&]()
+	    {
+		    worker_arena = &frame_allocator.get_thread_arena();
+		    static_cast<void>(worker_arena->allocate(128));
+	    });
+	worker.join();
+
+	// スレッド毎に別のアリーナが割り当てられる
+	ASSERT_NE(main_arena, worker_arena);
+	ASSERT_EQ(frame_allocator.get_thread_statistics().used_bytes, 128);
+
+	system_manager.finalize();
+}
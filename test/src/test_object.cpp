@@ -76,3 +76,25 @@ TEST(ObjectTest, ObjectSystemTest)
 
 	int a = 0;
 }
+
+TEST(ObjectTest, ObjectAllocatorTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& object_system = bavil::ObjectSystem::Get();
+	auto& allocator     = object_system.get_allocator();
+
+	ASSERT_EQ(allocator.get_live_bytes(), 0);
+
+	{
+		auto test_object = object_system.create_object<TestObject>();
+
+		// オブジェクトはシステムのアロケータから確保される
+		ASSERT_EQ(allocator.get_live_bytes(), sizeof(TestObject));
+	}
+
+	ASSERT_EQ(allocator.get_live_bytes(), 0);
+	ASSERT_EQ(allocator.get_peak_bytes(), sizeof(TestObject));
+
+	system_manager.finalize();
+}
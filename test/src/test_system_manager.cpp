@@ -2,6 +2,8 @@
 #include <core/bavil_system.h>
 #include <core/bavil_system_manager.h>
 
+#include <thread>
+
 // TESTマクロを使う場合
 
 namespace
@@ -37,3 +39,80 @@ TEST(SystemManagerTest, Function1Test) {
 	ASSERT_EQ(result->get_system_id(), TestSystem::GetSystemId());
 
 }
+
+TEST(SystemManagerTest, MemoryReportTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	// 生成前に予算を設定出来る
+	system_manager.set_memory_budget<TestSystem>(256);
+
+	TestSystem* result = system_manager.get_system<TestSystem>();
+
+	bavil::core::SystemAllocator& allocator = result->get_allocator();
+	ASSERT_EQ(&allocator, &system_manager.get_allocator<TestSystem>());
+	ASSERT_EQ(allocator.get_budget(), 256);
+
+	void* memory = allocator.allocate(128);
+	ASSERT_EQ(allocator.get_live_bytes(), 128);
+
+	// 予算を超えた確保は失敗する
+	ASSERT_THROW(static_cast<void>(allocator.allocate(256)), std::bad_alloc);
+	ASSERT_EQ(allocator.get_live_bytes(), 128);
+
+	allocator.deallocate(memory, 128);
+
+	bool is_found = false;
+	for ( const auto& report : system_manager.get_memory_report() )
+	{
+		if ( report.system_id == TestSystem::GetSystemId() )
+		{
+			ASSERT_EQ(report.live_bytes, 0);
+			ASSERT_EQ(report.peak_bytes, 128);
+			ASSERT_EQ(report.budget_bytes, 256);
+			is_found = true;
+		}
+	}
+	ASSERT_TRUE(is_found);
+
+	system_manager.finalize();
+}
+
+TEST(SystemManagerTest, ContextTest)
+{
+	bavil::core::SystemManager context_a = {};
+	bavil::core::SystemManager context_b = {};
+
+	// 後から生成したコンテキストがカレントになる
+	ASSERT_EQ(bavil::core::SystemManager::GetCurrent(), &context_b);
+	ASSERT_EQ(context_a.find_system<TestSystem>(), nullptr);
+
+	TestSystem* system_a = &TestSystem::Get(context_a);
+	TestSystem* system_b = &TestSystem::Get();
+
+	ASSERT_NE(system_a, system_b);
+	ASSERT_EQ(context_a.find_system<TestSystem>(), system_a);
+
+	{
+		bavil::core::SystemManager::ScopedContext scope(context_a);
+		ASSERT_EQ(&TestSystem::Get(), system_a);
+	}
+	ASSERT_EQ(&TestSystem::Get(), system_b);
+
+	// スレッド毎に別のカレントコンテキストを持つ
+	TestSystem* thread_system = nullptr;
+	std::thread worker(
+	    [&]()
+	    {
+		    context_a.make_current();
+		    thread_system = &TestSystem::Get();
+	    });
+	worker.join();
+
+	ASSERT_EQ(thread_system, system_a);
+	ASSERT_EQ(&TestSystem::Get(), system_b);
+
+	context_a.finalize();
+	context_b.finalize();
+	ASSERT_EQ(context_a.find_system<TestSystem>(), nullptr);
+}
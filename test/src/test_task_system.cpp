@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <core/bavil_task_system.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// 第1引数がテストケース名、第2引数がテスト名
+TEST(TaskSystemTest, ParallelForTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& task_system = bavil::TaskSystem::Get();
+	task_system.set_worker_num(3);
+	ASSERT_EQ(task_system.get_worker_num(), 3);
+
+	// 全ての要素が一度だけ実行される
+	std::vector<int> counts(10000, 0);
+	task_system.parallel_for(counts.size(),
+	                         16,
+	                         [&](size_t _begin, size_t _end)
+	                         {
+		                         for ( size_t i = _begin; i < _end; ++i )
+		                         {
+			                         counts[i]++;
+		                         }
+	                         });
+	for ( int count : counts )
+	{
+		ASSERT_EQ(count, 1);
+	}
+
+	// 最小の要素数より小さい範囲は分割しない
+	std::atomic<int> call_num = 0;
+	task_system.parallel_for(10,
+	                         16,
+	                         [&](size_t _begin, size_t _end)
+	                         {
+		                         call_num++;
+		                         ASSERT_EQ(_begin, 0);
+		                         ASSERT_EQ(_end, 10);
+	                         });
+	ASSERT_EQ(call_num, 1);
+
+	system_manager.finalize();
+}
+
+TEST(TaskSystemTest, NestedTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& task_system = bavil::TaskSystem::Get();
+	task_system.set_worker_num(2);
+
+	// 実行中の範囲から更に parallel_for() を呼び出せる
+	std::atomic<size_t> sum = 0;
+	task_system.parallel_for(8,
+	                         1,
+	                         [&](size_t _begin, size_t _end)
+	                         {
+		                         for ( size_t i = _begin; i < _end; ++i )
+		                         {
+			                         // ワーカースレッドからもカレントコンテキストで取得できる
+			                         bavil::TaskSystem::Get().parallel_for(
+			                             100,
+			                             1,
+			                             [&](size_t _inner_begin, size_t _inner_end)
+			                             {
+				                             sum += _inner_end - _inner_begin;
+			                             });
+		                         }
+	                         });
+	ASSERT_EQ(sum, 800);
+
+	// ワーカースレッドが無い場合は呼び出したスレッドで実行する
+	task_system.set_worker_num(0);
+	sum = 0;
+	task_system.parallel_for(100,
+	                         1,
+	                         [&](size_t _begin, size_t _end)
+	                         {
+		                         sum += _end - _begin;
+	                         });
+	ASSERT_EQ(sum, 100);
+
+	system_manager.finalize();
+}
+
+TEST(TaskSystemTest, ExceptionTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& task_system = bavil::TaskSystem::Get();
+	task_system.set_worker_num(3);
+
+	// 例外は実行中のチャンクが終わってから呼び出したスレッドで投げ直される
+	const auto caller_id = std::this_thread::get_id();
+	for ( int i = 0; i < 20; ++i )
+	{
+		std::atomic<int> running_num = 0;
+		ASSERT_THROW(task_system.parallel_for(
+		                 1000,
+		                 1,
+		                 [&](size_t, size_t)
+		                 {
+			                 ++running_num;
+			                 if ( std::this_thread::get_id() == caller_id )
+			                 {
+				                 std::this_thread::sleep_for(
+				                     std::chrono::microseconds(100));
+			                 }
+			                 --running_num;
+			                 throw std::runtime_error("chunk failed");
+		                 }),
+		             std::runtime_error);
+		ASSERT_EQ(running_num, 0);
+	}
+
+	// 例外の後も続けて使える
+	std::atomic<size_t> sum = 0;
+	task_system.parallel_for(1000,
+	                         1,
+	                         [&](size_t _begin, size_t _end)
+	                         {
+		                         sum += _end - _begin;
+	                         });
+	ASSERT_EQ(sum, 1000);
+
+	system_manager.finalize();
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <core/bavil_timer_system.h>
+
+#include <vector>
+
+// 第1引数がテストケース名、第2引数がテスト名
+TEST(TimerSystemTest, ScheduleTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& timer_system = bavil::TimerSystem::Get();
+
+	int  fired_num = 0;
+	auto handle    = timer_system.schedule_ticks(
+	    10,
+	    [&]()
+	    {
+		    fired_num++;
+	    });
+
+	ASSERT_TRUE(timer_system.is_active(handle));
+	ASSERT_EQ(timer_system.get_active_timer_num(), 1);
+
+	timer_system.advance_ticks(9);
+	ASSERT_EQ(fired_num, 0);
+
+	timer_system.advance_ticks(1);
+	ASSERT_EQ(fired_num, 1);
+	ASSERT_FALSE(timer_system.is_active(handle));
+	ASSERT_EQ(timer_system.get_active_timer_num(), 0);
+
+	system_manager.finalize();
+}
+
+TEST(TimerSystemTest, CascadeTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& timer_system = bavil::TimerSystem::Get();
+
+	// 上の段のホイールに登録されるタイマーが正しいティックで実行されるか
+	const std::vector<bavil::u64> delays = {1, 255, 256, 257, 1000, 16384, 70000};
+	std::vector<bavil::u64>       fired_ticks;
+
+	timer_system.advance_ticks(100);
+	const bavil::u64 start_tick = timer_system.get_current_tick();
+	for ( bavil::u64 delay : delays )
+	{
+		timer_system.schedule_ticks(delay,
+		                            [&, delay]()
+		                            {
+			                            fired_ticks.push_back(delay);
+			                            ASSERT_EQ(timer_system.get_current_tick(),
+			                                      start_tick + delay);
+		                            });
+	}
+
+	timer_system.advance_ticks(70000);
+	ASSERT_EQ(fired_ticks, delays);
+
+	system_manager.finalize();
+}
+
+TEST(TimerSystemTest, CancelAndRepeatTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& timer_system = bavil::TimerSystem::Get();
+
+	int  cancelled_num = 0;
+	auto cancelled     = timer_system.schedule_ticks(
+	    5,
+	    [&]()
+	    {
+		    cancelled_num++;
+	    });
+	ASSERT_TRUE(timer_system.cancel(cancelled));
+	ASSERT_FALSE(timer_system.cancel(cancelled));
+
+	// 繰り返しのタイマーはコールバック内からキャンセル出来る
+	int                repeat_num = 0;
+	bavil::TimerHandle repeat     = {};
+
+	repeat = timer_system.schedule_ticks(
+	    2,
+	    [&]()
+	    {
+		    if ( ++repeat_num == 3 )
+		    {
+			    timer_system.cancel(repeat);
+		    }
+	    },
+	    4);
+
+	timer_system.advance_ticks(100);
+	ASSERT_EQ(cancelled_num, 0);
+	ASSERT_EQ(repeat_num, 3);
+	ASSERT_EQ(timer_system.get_active_timer_num(), 0);
+
+	// 秒数指定
+	int seconds_num = 0;
+	timer_system.schedule(0.5f,
+	                      [&]()
+	                      {
+		                      seconds_num++;
+	                      });
+	timer_system.tick(0.25f);
+	ASSERT_EQ(seconds_num, 0);
+	timer_system.tick(0.25f);
+	ASSERT_EQ(seconds_num, 1);
+
+	system_manager.finalize();
+}
@@ -0,0 +1,849 @@
+#include <gtest/gtest.h>
+#include <core/bavil_object_system.h>
+#include <core/bavil_world_system.h>
+
+#include <core/bavil_task_system.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	class TickActor : public bavil::Actor
+	{
+	public:
+		explicit TickActor(bool _thread_safe)
+		{
+			set_tick_enabled(true);
+			set_tick_thread_safe(_thread_safe);
+		}
+
+		virtual void tick(bavil::f32 _delta_seconds) override
+		{
+			tick_num++;
+			total_seconds += _delta_seconds;
+			thread_id = std::this_thread::get_id();
+			if ( on_tick )
+			{
+				on_tick();
+			}
+		}
+
+		int                   tick_num      = 0;
+		bavil::f32            total_seconds = 0.0f;
+		std::thread::id       thread_id;
+		std::function<void()> on_tick;
+	};
+} // namespace
+
+// 第1引数がテストケース名、第2引数がテスト名
+TEST(WorldSystemTest, ActorRegistryTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& object_system = bavil::ObjectSystem::Get();
+	auto& world_system  = bavil::WorldSystem::Get();
+
+	// 生成したアクターはワールドに登録される
+	auto actor0 = object_system.create_object<bavil::Actor>();
+	auto actor1 = object_system.create_object<bavil::Actor>();
+	auto actor2 = object_system.create_object<bavil::Actor>();
+	ASSERT_EQ(world_system.get_actor_num(), 3);
+	ASSERT_TRUE(actor1->is_in_world());
+
+	// 二重に登録しても増えない
+	world_system.add_actor(actor1.get_object());
+	ASSERT_EQ(world_system.get_actor_num(), 3);
+
+	// 削除すると末尾のアクターが入れ替わる
+	world_system.remove_actor(actor0.get_object());
+	ASSERT_FALSE(actor0->is_in_world());
+	ASSERT_EQ(world_system.get_actor_num(), 2);
+	ASSERT_EQ(world_system.get_actors()[0], actor2.get_object());
+
+	world_system.remove_actor(actor0.get_object());
+	ASSERT_EQ(world_system.get_actor_num(), 2);
+
+	std::vector<bavil::Actor*> visited;
+	world_system.for_each_actor(
+	    [&](bavil::Actor& _actor)
+	    {
+		    visited.push_back(&_actor);
+	    });
+	ASSERT_EQ(visited.size(), 2);
+	ASSERT_NE(std::find(visited.begin(), visited.end(), actor1.get_object()),
+	          visited.end());
+	ASSERT_NE(std::find(visited.begin(), visited.end(), actor2.get_object()),
+	          visited.end());
+
+	// 破棄したアクターは登録が解除される
+	actor2 = bavil::ObjectHandle<bavil::Actor>();
+	ASSERT_EQ(world_system.get_actor_num(), 1);
+	ASSERT_EQ(world_system.get_actors()[0], actor1.get_object());
+
+	system_manager.finalize();
+}
+
+TEST(WorldSystemTest, TransformTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system = bavil::WorldSystem::Get();
+
+	bavil::Actor actor;
+	world_system.add_actor(&actor);
+
+	// 値を変更しても行列は取得するまで作り直さない
+	bavil::Transform& transform = actor.get_transform();
+	ASSERT_FALSE(transform.is_dirty());
+	transform.set_scale({2.0f, 2.0f, 2.0f});
+	transform.set_position({1.0f, 2.0f, 3.0f});
+	ASSERT_TRUE(transform.is_dirty());
+
+	const bavil::math::Matrix44& matrix = transform.get_matrix();
+	ASSERT_FALSE(transform.is_dirty());
+	ASSERT_FLOAT_EQ(matrix._11, 2.0f);
+	ASSERT_FLOAT_EQ(matrix._41, 1.0f);
+	ASSERT_FLOAT_EQ(matrix._42, 2.0f);
+	ASSERT_FLOAT_EQ(matrix._43, 3.0f);
+
+	// ワールドでまとめて作り直す
+	transform.set_position({4.0f, 0.0f, 0.0f});
+	world_system.update_transforms();
+	ASSERT_FALSE(transform.is_dirty());
+	ASSERT_FLOAT_EQ(transform.get_matrix()._41, 4.0f);
+
+	world_system.remove_actor(&actor);
+	system_manager.finalize();
+}
+
+TEST(WorldSystemTest, TransformStoreTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system = bavil::WorldSystem::Get();
+
+	// 4つずつ作り直す分と、端数の1つずつ作り直す分を含める
+	constexpr size_t ACTOR_NUM = 37;
+	auto             expected  = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	auto             actors    = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		world_system.add_actor(&expected[i]);
+		world_system.add_actor(&actors[i]);
+	}
+
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		// 360度を超える角度や負の角度も含める
+		const float value = static_cast<float>(i);
+		const bavil::math::Vector3 position = {value, -value, value * 0.5f};
+		const bavil::math::Rotator rotation = {
+		    value * 37.0f - 700.0f, value * -53.0f, value * 91.0f};
+		const bavil::math::Vector3 scale = {1.0f + value * 0.1f, 2.0f, 0.5f};
+		for ( bavil::Actor* actor : {&expected[i], &actors[i]} )
+		{
+			bavil::Transform& transform = actor->get_transform();
+			transform.set_position(position);
+			transform.set_rotation(rotation);
+			transform.set_scale(scale);
+		}
+
+		// 比較用に1つずつ作り直す
+		expected[i].get_transform().update_matrix();
+	}
+
+	world_system.update_transforms();
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		const bavil::Transform& transform = actors[i].get_transform();
+		ASSERT_FALSE(transform.is_dirty());
+		const auto& expected_matrix = expected[i].get_transform().get_matrix();
+		for ( size_t j = 0; j < 16; ++j )
+		{
+			ASSERT_NEAR(transform.get_matrix().v[j], expected_matrix.v[j], 1.0e-5f);
+		}
+	}
+
+	// 削除で位置が変わっても同じ値を参照する
+	const bavil::Transform&    last     = actors[ACTOR_NUM - 1].get_transform();
+	const bavil::math::Vector3 position = last.get_position();
+	world_system.remove_actor(&actors[0]);
+	ASSERT_FALSE(actors[0].get_transform().is_valid());
+	ASSERT_FLOAT_EQ(last.get_position().x, position.x);
+	ASSERT_FLOAT_EQ(last.get_position().y, position.y);
+
+	// 削除したアクターは削除前の値を保持し、登録されていない間も値を変更できる
+	bavil::Transform& removed = actors[0].get_transform();
+	ASSERT_FLOAT_EQ(removed.get_scale().y, 2.0f);
+	removed.set_position({1.0f, 0.0f, 0.0f});
+	ASSERT_TRUE(removed.is_dirty());
+	ASSERT_FLOAT_EQ(removed.get_position().x, 1.0f);
+	ASSERT_FLOAT_EQ(removed.get_matrix()._41, 1.0f);
+	ASSERT_FALSE(removed.is_dirty());
+
+	// 登録し直しても値を引き継ぐ
+	world_system.add_actor(&actors[0]);
+	ASSERT_TRUE(removed.is_valid());
+	ASSERT_FLOAT_EQ(removed.get_position().x, 1.0f);
+	ASSERT_FLOAT_EQ(removed.get_scale().y, 2.0f);
+	ASSERT_FLOAT_EQ(removed.get_matrix()._41, 1.0f);
+
+	system_manager.finalize();
+}
+
+TEST(WorldSystemTest, DetachedTransformTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system = bavil::WorldSystem::Get();
+
+	// 登録前に設定した値はワールド行列と索引に反映される
+	bavil::Actor actor;
+	actor.get_transform().set_position({3.0f, 4.0f, 5.0f});
+	actor.get_transform().set_scale({2.0f, 2.0f, 2.0f});
+	world_system.add_actor(&actor);
+	ASSERT_TRUE(actor.get_transform().is_changed());
+	world_system.update_transforms();
+	{
+		const auto& matrix = world_system.get_world_matrix(actor);
+		ASSERT_FLOAT_EQ(matrix._11, 2.0f);
+		ASSERT_FLOAT_EQ(matrix._41, 3.0f);
+		ASSERT_FLOAT_EQ(matrix._42, 4.0f);
+		ASSERT_FLOAT_EQ(matrix._43, 5.0f);
+	}
+
+	// 全て削除しても値は残る
+	world_system.remove_actor(&actor);
+	world_system.add_actor(&actor);
+	system_manager.finalize();
+	ASSERT_FALSE(actor.get_transform().is_valid());
+	ASSERT_FLOAT_EQ(actor.get_transform().get_position().z, 5.0f);
+	ASSERT_FLOAT_EQ(actor.get_transform().get_matrix()._43, 5.0f);
+}
+
+TEST(WorldSystemTest, HierarchyTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system = bavil::WorldSystem::Get();
+
+	bavil::Actor root;
+	bavil::Actor child;
+	bavil::Actor grandchild;
+	world_system.add_actor(&root);
+	world_system.add_actor(&child);
+	world_system.add_actor(&grandchild);
+
+	root.get_transform().set_position({1.0f, 0.0f, 0.0f});
+	child.get_transform().set_position({0.0f, 2.0f, 0.0f});
+	grandchild.get_transform().set_position({0.0f, 0.0f, 3.0f});
+
+	ASSERT_TRUE(world_system.attach_actor(&grandchild, &child));
+	ASSERT_TRUE(world_system.attach_actor(&child, &root));
+	ASSERT_EQ(grandchild.get_parent(), &child);
+	ASSERT_EQ(child.get_parent(), &root);
+
+	// 親子関係が循環する場合は取り付けない
+	ASSERT_FALSE(world_system.attach_actor(&root, &grandchild));
+	ASSERT_FALSE(world_system.attach_actor(&root, &root));
+
+	world_system.update_transforms();
+	{
+		const auto& matrix = world_system.get_world_matrix(grandchild);
+		ASSERT_FLOAT_EQ(matrix._41, 1.0f);
+		ASSERT_FLOAT_EQ(matrix._42, 2.0f);
+		ASSERT_FLOAT_EQ(matrix._43, 3.0f);
+	}
+
+	// 親を動かすと子孫のワールド行列も計算し直される
+	root.get_transform().set_position({5.0f, 0.0f, 0.0f});
+	world_system.update_transforms();
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(grandchild)._41, 5.0f);
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(child)._41, 5.0f);
+
+	// 親の行列を先に取得して作り直していても、子のワールド行列に反映する
+	root.get_transform().set_position({40.0f, 0.0f, 0.0f});
+	ASSERT_FLOAT_EQ(root.get_transform().get_matrix()._41, 40.0f);
+	ASSERT_FALSE(root.get_transform().is_dirty());
+	ASSERT_TRUE(root.get_transform().is_changed());
+	world_system.update_transforms();
+	ASSERT_FALSE(root.get_transform().is_changed());
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(child)._41, 40.0f);
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(grandchild)._41, 40.0f);
+
+	// 取り外すと子のワールド行列は自身の行列になる
+	world_system.detach_actor(&child);
+	ASSERT_EQ(child.get_parent(), nullptr);
+	world_system.update_transforms();
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(child)._41, 0.0f);
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(grandchild)._41, 0.0f);
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(grandchild)._42, 2.0f);
+
+	// 削除したアクターの子はルートとして残る
+	ASSERT_TRUE(world_system.attach_actor(&child, &root));
+	world_system.remove_actor(&root);
+	ASSERT_EQ(child.get_parent(), nullptr);
+	ASSERT_EQ(grandchild.get_parent(), &child);
+	world_system.update_transforms();
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(grandchild)._41, 0.0f);
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(grandchild)._43, 3.0f);
+
+	world_system.remove_actor(&grandchild);
+	ASSERT_EQ(world_system.get_actor_num(), 1);
+	world_system.remove_actor(&child);
+
+	system_manager.finalize();
+}
+
+TEST(WorldSystemTest, TickTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system = bavil::WorldSystem::Get();
+	bavil::TaskSystem::Get().set_worker_num(3);
+
+	std::vector<std::unique_ptr<TickActor>> parallel_actors;
+	std::vector<std::unique_ptr<TickActor>> serial_actors;
+	for ( size_t i = 0; i < 1000; ++i )
+	{
+		parallel_actors.push_back(std::make_unique<TickActor>(true));
+		world_system.add_actor(parallel_actors.back().get());
+	}
+	for ( size_t i = 0; i < 10; ++i )
+	{
+		serial_actors.push_back(std::make_unique<TickActor>(false));
+		world_system.add_actor(serial_actors.back().get());
+	}
+	TickActor disabled_actor(false);
+	disabled_actor.set_tick_enabled(false);
+	world_system.add_actor(&disabled_actor);
+	ASSERT_EQ(world_system.get_tick_actor_num(), 1010);
+
+	// 全てのアクターが1回ずつ呼ばれ、スレッドセーフでないアクターは呼び出したスレッドで呼ばれる
+	world_system.tick(0.5f);
+	for ( const auto& actor : parallel_actors )
+	{
+		ASSERT_EQ(actor->tick_num, 1);
+		ASSERT_FLOAT_EQ(actor->total_seconds, 0.5f);
+	}
+	for ( const auto& actor : serial_actors )
+	{
+		ASSERT_EQ(actor->tick_num, 1);
+		ASSERT_EQ(actor->thread_id, std::this_thread::get_id());
+	}
+	ASSERT_EQ(disabled_actor.tick_num, 0);
+
+	// 登録済みのアクターも無効にすると呼ばれない
+	parallel_actors[0]->set_tick_enabled(false);
+	ASSERT_EQ(world_system.get_tick_actor_num(), 1009);
+	world_system.tick(0.5f);
+	ASSERT_EQ(parallel_actors[0]->tick_num, 1);
+	ASSERT_EQ(parallel_actors[1]->tick_num, 2);
+
+	// 呼び出し中に削除したアクターは呼ばれず、追加したアクターは次から呼ばれる
+	TickActor added_actor(false);
+	TickActor* removed_actor = nullptr;
+	serial_actors[0]->on_tick = [&]()
+	{
+		for ( const auto& actor : serial_actors )
+		{
+			if ( actor.get() != serial_actors[0].get() )
+			{
+				removed_actor = actor.get();
+				break;
+			}
+		}
+		world_system.remove_actor(removed_actor);
+		world_system.add_actor(&added_actor);
+		serial_actors[0]->on_tick = nullptr;
+	};
+	world_system.tick(0.5f);
+	ASSERT_EQ(removed_actor->tick_num, 2);
+	ASSERT_EQ(added_actor.tick_num, 0);
+	ASSERT_EQ(world_system.get_tick_actor_num(), 1009);
+
+	world_system.tick(0.5f);
+	ASSERT_EQ(removed_actor->tick_num, 2);
+	ASSERT_EQ(added_actor.tick_num, 1);
+
+	system_manager.finalize();
+}
+
+TEST(WorldSystemTest, SpatialIndexTest)
+{
+	for ( const auto type : {bavil::SpatialIndexType::None,
+	                         bavil::SpatialIndexType::HashedGrid,
+	                         bavil::SpatialIndexType::Octree} )
+	{
+		bavil::core::SystemManager system_manager = {};
+
+		auto& world_system = bavil::WorldSystem::Get();
+
+		// 八分木の範囲外の位置も含める
+		bavil::SpatialIndexSettings settings;
+		settings.type          = type;
+		settings.cell_size     = 4.0f;
+		settings.bounds        = {bavil::math::Vector3(-64.0f),
+		                          bavil::math::Vector3(64.0f)};
+		settings.leaf_capacity = 4;
+		world_system.set_spatial_index(settings);
+
+		std::mt19937                          engine(1234);
+		std::uniform_real_distribution<float> distribution(-80.0f, 80.0f);
+		auto random_position = [&]() -> bavil::math::Vector3
+		{
+			return {
+			    distribution(engine), distribution(engine), distribution(engine)};
+		};
+
+		constexpr size_t ACTOR_NUM = 500;
+		auto             actors    = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+		for ( size_t i = 0; i < ACTOR_NUM; ++i )
+		{
+			world_system.add_actor(&actors[i]);
+			actors[i].get_transform().set_position(random_position());
+		}
+		// 子はワールド座標で検索される
+		ASSERT_TRUE(world_system.attach_actor(&actors[1], &actors[0]));
+
+		// 半分のアクターを動かし、1割を削除する
+		world_system.update_transforms();
+		for ( size_t i = 0; i < ACTOR_NUM; i += 2 )
+		{
+			actors[i].get_transform().set_position(random_position());
+		}
+		for ( size_t i = 5; i < ACTOR_NUM; i += 10 )
+		{
+			world_system.remove_actor(&actors[i]);
+		}
+		world_system.update_transforms();
+
+		const bavil::math::Vector3 center = {10.0f, -5.0f, 20.0f};
+		constexpr float            RADIUS = 30.0f;
+
+		std::vector<bavil::Actor*> expected;
+		for ( bavil::Actor* actor : world_system.get_actors() )
+		{
+			const auto position = world_system.get_world_position(*actor);
+			if ( bavil::math::Vector3::DistanceSqr(center, position) <=
+			     RADIUS * RADIUS )
+			{
+				expected.push_back(actor);
+			}
+		}
+		ASSERT_FALSE(expected.empty());
+
+		std::vector<bavil::Actor*> result;
+		world_system.query_actors_in_radius(center,
+		                                    RADIUS,
+		                                    [&](bavil::Actor& _actor)
+		                                    {
+			                                    result.push_back(&_actor);
+		                                    });
+		std::sort(expected.begin(), expected.end());
+		std::sort(result.begin(), result.end());
+		ASSERT_EQ(result, expected);
+
+		const bavil::math::AABB aabb = {{-20.0f, -20.0f, -20.0f},
+		                                {70.0f, 5.0f, 70.0f}};
+		expected.clear();
+		for ( bavil::Actor* actor : world_system.get_actors() )
+		{
+			if ( aabb.contains(world_system.get_world_position(*actor)) )
+			{
+				expected.push_back(actor);
+			}
+		}
+		result.clear();
+		world_system.query_actors_in_aabb(aabb,
+		                                  [&](bavil::Actor& _actor)
+		                                  {
+			                                  result.push_back(&_actor);
+		                                  });
+		std::sort(expected.begin(), expected.end());
+		std::sort(result.begin(), result.end());
+		ASSERT_EQ(result, expected);
+
+		// 近い順に取得する
+		const auto actor_span = world_system.get_actors();
+		expected.assign(actor_span.begin(), actor_span.end());
+		std::sort(expected.begin(),
+		          expected.end(),
+		          [&](bavil::Actor* _a, bavil::Actor* _b)
+		          {
+			          return bavil::math::Vector3::DistanceSqr(
+			                     center, world_system.get_world_position(*_a)) <
+			                 bavil::math::Vector3::DistanceSqr(
+			                     center, world_system.get_world_position(*_b));
+		          });
+		std::vector<bavil::Actor*> nearest(8);
+		ASSERT_EQ(world_system.find_nearest_actors(center, nearest), nearest.size());
+		for ( size_t i = 0; i < nearest.size(); ++i )
+		{
+			ASSERT_EQ(nearest[i], expected[i]);
+		}
+
+		// アクターの数より多く取得しようとした場合は全て取得する
+		nearest.resize(ACTOR_NUM);
+		ASSERT_EQ(world_system.find_nearest_actors(center, nearest),
+		          world_system.get_actor_num());
+
+		// 行列を先に取得して作り直していても、索引と境界ボックスの木に反映する
+		bavil::Actor parent;
+		bavil::Actor child;
+		bavil::Actor single;
+		world_system.add_actor(&parent);
+		world_system.add_actor(&child);
+		world_system.add_actor(&single);
+		ASSERT_TRUE(world_system.attach_actor(&child, &parent));
+		single.set_local_bounds({bavil::math::Vector3(-0.5f),
+		                         bavil::math::Vector3(0.5f)});
+		world_system.update_transforms();
+
+		const bavil::math::Vector3 moved_position(100.0f, 100.0f, 100.0f);
+		parent.get_transform().set_position(moved_position);
+		single.get_transform().set_position(moved_position);
+		ASSERT_FLOAT_EQ(parent.get_transform().get_matrix()._41, 100.0f);
+		ASSERT_FLOAT_EQ(single.get_transform().get_matrix()._41, 100.0f);
+		world_system.update_transforms();
+
+		size_t moved_num = 0;
+		world_system.query_actors_in_radius(moved_position,
+		                                    1.0f,
+		                                    [&](bavil::Actor&)
+		                                    {
+			                                    ++moved_num;
+		                                    });
+		ASSERT_EQ(moved_num, 3);
+		size_t overlapped_num = 0;
+		world_system.query_actors_overlapping(
+		    {moved_position, moved_position + bavil::math::Vector3(1.0f)},
+		    [&](bavil::Actor& _actor)
+		    {
+			    ASSERT_EQ(&_actor, &single);
+			    ++overlapped_num;
+		    });
+		ASSERT_EQ(overlapped_num, 1);
+
+		world_system.remove_actor(&child);
+		world_system.remove_actor(&parent);
+		world_system.remove_actor(&single);
+
+		// 不正な設定は受け付けず、索引はそのまま使える
+		if ( type != bavil::SpatialIndexType::None )
+		{
+			bavil::SpatialIndexSettings invalid = settings;
+			invalid.cell_size                   = 0.0f;
+			ASSERT_THROW(world_system.set_spatial_index(invalid),
+			             std::invalid_argument);
+			invalid.cell_size = std::numeric_limits<float>::quiet_NaN();
+			ASSERT_THROW(world_system.set_spatial_index(invalid),
+			             std::invalid_argument);
+			ASSERT_EQ(world_system.find_nearest_actors(center, nearest),
+			          world_system.get_actor_num());
+		}
+		if ( type == bavil::SpatialIndexType::Octree )
+		{
+			bavil::SpatialIndexSettings invalid = settings;
+			invalid.bounds.max.x = std::numeric_limits<float>::infinity();
+			ASSERT_THROW(world_system.set_spatial_index(invalid),
+			             std::invalid_argument);
+		}
+
+		// 数値でない位置も格子にまとめて格納する
+		bavil::Actor nan_actor;
+		world_system.add_actor(&nan_actor);
+		nan_actor.get_transform().set_position(
+		    bavil::math::Vector3(std::numeric_limits<float>::quiet_NaN()));
+		world_system.update_transforms();
+		world_system.query_actors_in_aabb(
+		    {bavil::math::Vector3(std::numeric_limits<float>::quiet_NaN()),
+		     bavil::math::Vector3(std::numeric_limits<float>::quiet_NaN())},
+		    [&](bavil::Actor&) {});
+		world_system.remove_actor(&nan_actor);
+
+		system_manager.finalize();
+	}
+}
+
+TEST(WorldSystemTest, BoundsTreeTest)
+{
+	// 一方向に並べて追加しても、回転で高さが揃う
+	{
+		bavil::AABBTree tree(std::pmr::get_default_resource());
+		constexpr bavil::u32 LEAF_NUM = 1024;
+		for ( bavil::u32 i = 0; i < LEAF_NUM; ++i )
+		{
+			const bavil::math::Vector3 position(static_cast<float>(i), 0.0f, 0.0f);
+			tree.insert(nullptr, {position, position + bavil::math::Vector3(0.5f)});
+		}
+		ASSERT_EQ(tree.size(), LEAF_NUM);
+		ASSERT_LE(tree.get_height(), 20u);
+	}
+
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system = bavil::WorldSystem::Get();
+	bavil::TaskSystem::Get().set_worker_num(3);
+
+	std::mt19937                          engine(4321);
+	std::uniform_real_distribution<float> distribution(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> size_distribution(0.5f, 4.0f);
+	auto random_position = [&]() -> bavil::math::Vector3
+	{
+		return {distribution(engine), distribution(engine), distribution(engine)};
+	};
+
+	constexpr size_t ACTOR_NUM = 400;
+	auto             actors    = std::make_unique<bavil::Actor[]>(ACTOR_NUM);
+	for ( size_t i = 0; i < ACTOR_NUM; ++i )
+	{
+		world_system.add_actor(&actors[i]);
+		actors[i].get_transform().set_position(random_position());
+		actors[i].get_transform().set_rotation(
+		    {distribution(engine), distribution(engine), distribution(engine)});
+		const bavil::math::Vector3 extent(size_distribution(engine),
+		                                  size_distribution(engine),
+		                                  size_distribution(engine));
+		actors[i].set_local_bounds({-extent, extent});
+	}
+	// 子の境界ボックスは親の行列で動く
+	ASSERT_TRUE(world_system.attach_actor(&actors[1], &actors[0]));
+
+	// 半分のアクターを動かし、1割を削除し、1割の境界ボックスを取り除く
+	world_system.update_transforms();
+	for ( size_t i = 0; i < ACTOR_NUM; i += 2 )
+	{
+		actors[i].get_transform().set_position(random_position());
+	}
+	for ( size_t i = 5; i < ACTOR_NUM; i += 10 )
+	{
+		world_system.remove_actor(&actors[i]);
+	}
+	for ( size_t i = 7; i < ACTOR_NUM; i += 10 )
+	{
+		actors[i].clear_local_bounds();
+	}
+	world_system.update_transforms();
+
+	std::vector<bavil::Actor*> bounds_actors;
+	for ( bavil::Actor* actor : world_system.get_actors() )
+	{
+		if ( actor->has_local_bounds() )
+		{
+			bounds_actors.push_back(actor);
+		}
+	}
+	ASSERT_EQ(bounds_actors.size(), ACTOR_NUM - ACTOR_NUM / 5);
+
+	// 重なりの判定を全てのアクターを調べた結果と比べる
+	const bavil::math::AABB aabb = {{-30.0f, -10.0f, -30.0f},
+	                                {20.0f, 15.0f, 40.0f}};
+	std::vector<bavil::Actor*> expected;
+	for ( bavil::Actor* actor : bounds_actors )
+	{
+		if ( world_system.get_world_bounds(*actor).intersects(aabb) )
+		{
+			expected.push_back(actor);
+		}
+	}
+	ASSERT_FALSE(expected.empty());
+
+	std::vector<bavil::Actor*> result;
+	world_system.query_actors_overlapping(aabb,
+	                                      [&](bavil::Actor& _actor)
+	                                      {
+		                                      result.push_back(&_actor);
+	                                      });
+	std::sort(expected.begin(), expected.end());
+	std::sort(result.begin(), result.end());
+	ASSERT_EQ(result, expected);
+
+	// 並列に判定される本数で、軸に平行な半直線や距離の短い半直線も含める
+	std::vector<bavil::math::Ray> rays;
+	for ( size_t i = 0; i < 301; ++i )
+	{
+		bavil::math::Ray ray;
+		ray.origin    = random_position();
+		ray.direction = random_position().get_safe_normalize();
+		if ( i % 7 == 0 )
+		{
+			ray.direction = {0.0f, i % 2 == 0 ? 1.0f : -1.0f, 0.0f};
+		}
+		if ( i % 5 == 0 )
+		{
+			ray.max_distance = 10.0f;
+		}
+		rays.push_back(ray);
+	}
+	std::vector<bavil::RaycastHit> hits(rays.size());
+	world_system.raycast(rays, hits);
+
+	size_t hit_num = 0;
+	for ( size_t i = 0; i < rays.size(); ++i )
+	{
+		const bavil::math::Ray& ray = rays[i];
+
+		bavil::RaycastHit expected_hit;
+		for ( bavil::Actor* actor : bounds_actors )
+		{
+			const bavil::math::AABB bounds = world_system.get_world_bounds(*actor);
+			float                   t_min  = 0.0f;
+			float                   t_max  = ray.max_distance;
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				if ( ray.direction[axis] == 0.0f )
+				{
+					if ( ray.origin[axis] < bounds.min[axis] ||
+					     bounds.max[axis] < ray.origin[axis] )
+					{
+						t_max = -1.0f;
+					}
+					continue;
+				}
+				const float t0 =
+				    (bounds.min[axis] - ray.origin[axis]) / ray.direction[axis];
+				const float t1 =
+				    (bounds.max[axis] - ray.origin[axis]) / ray.direction[axis];
+				t_min = std::max(t_min, std::min(t0, t1));
+				t_max = std::min(t_max, std::max(t0, t1));
+			}
+			if ( t_min <= t_max && t_min < expected_hit.distance )
+			{
+				expected_hit = {actor, t_min};
+			}
+		}
+
+		ASSERT_EQ(hits[i].is_hit(), expected_hit.is_hit()) << i;
+		if ( expected_hit.is_hit() )
+		{
+			ASSERT_NEAR(hits[i].distance, expected_hit.distance, 1.0e-3f) << i;
+			++hit_num;
+		}
+
+		const bavil::RaycastHit single_hit = world_system.raycast(ray);
+		ASSERT_EQ(single_hit.actor, hits[i].actor);
+	}
+	ASSERT_GT(hit_num, 0u);
+
+	system_manager.finalize();
+}
+
+TEST(WorldSystemTest, FixedStepTest)
+{
+	bavil::core::SystemManager system_manager = {};
+
+	auto& world_system = bavil::WorldSystem::Get();
+	world_system.set_fixed_step_settings({.step_seconds = 0.125f,
+	                                      .max_step_num = 4});
+
+	// 進まない設定は受け付けない
+	ASSERT_THROW(world_system.set_fixed_step_settings({.step_seconds = 0.0f}),
+	             std::invalid_argument);
+	ASSERT_THROW(world_system.set_fixed_step_settings({.step_seconds = -1.0f}),
+	             std::invalid_argument);
+	ASSERT_THROW(world_system.set_fixed_step_settings(
+	                 {.step_seconds = std::numeric_limits<float>::quiet_NaN()}),
+	             std::invalid_argument);
+	ASSERT_THROW(world_system.set_fixed_step_settings({.max_step_num = 0}),
+	             std::invalid_argument);
+	ASSERT_FLOAT_EQ(world_system.get_fixed_step_settings().step_seconds, 0.125f);
+
+	TickActor mover(false);
+	mover.on_tick = [&]()
+	{
+		bavil::math::Vector3 position = mover.get_transform().get_position();
+		position.x += 1.0f;
+		mover.get_transform().set_position(position);
+	};
+	world_system.add_actor(&mover);
+
+	// 負の値や数値でない経過時間は進めない
+	ASSERT_EQ(world_system.advance_fixed_step(-1.0f), 0);
+	ASSERT_EQ(world_system.advance_fixed_step(
+	              std::numeric_limits<float>::quiet_NaN()),
+	          0);
+
+	// 固定の間隔に満たない時間は持ち越す
+	ASSERT_EQ(world_system.advance_fixed_step(0.1f), 0);
+	ASSERT_EQ(mover.tick_num, 0);
+	ASSERT_EQ(world_system.advance_fixed_step(0.2f), 2);
+	ASSERT_EQ(mover.tick_num, 2);
+	ASSERT_FLOAT_EQ(mover.total_seconds, 0.25f);
+	ASSERT_NEAR(world_system.get_interpolation_alpha(), 0.4f, 1e-4f);
+
+	// 前回と今回の更新の間を補間する
+	world_system.update_interpolated_matrices();
+	ASSERT_FLOAT_EQ(world_system.get_world_matrix(mover)._41, 2.0f);
+	ASSERT_NEAR(world_system.get_interpolated_matrix(mover)._41, 1.4f, 1e-4f);
+
+	// 上限の回数を超えた時間は捨てる
+	ASSERT_EQ(world_system.advance_fixed_step(10.0f), 4);
+	ASSERT_EQ(mover.tick_num, 6);
+	ASSERT_FLOAT_EQ(world_system.get_interpolation_alpha(), 0.0f);
+	world_system.update_interpolated_matrices();
+	ASSERT_FLOAT_EQ(world_system.get_interpolated_matrix(mover)._41, 5.0f);
+
+	// 回転は球面線形補間し、子は補間した親の行列を掛ける
+	bavil::Actor child;
+	bavil::Actor spinner;
+	bavil::Actor expected;
+	world_system.add_actor(&child);
+	world_system.add_actor(&spinner);
+	world_system.add_actor(&expected);
+	child.get_transform().set_position({0.0f, 1.0f, 0.0f});
+	ASSERT_TRUE(world_system.attach_actor(&child, &mover));
+	expected.get_transform().set_rotation({0.0f, 45.0f, 0.0f});
+
+	int  step_num = 0;
+	auto spin     = [&](bavil::f32 _step_seconds)
+	{
+		ASSERT_EQ(_step_seconds, 0.125f);
+		spinner.get_transform().set_rotation({0.0f, 90.0f, 0.0f});
+		++step_num;
+	};
+	ASSERT_EQ(world_system.advance_fixed_step(0.1875f, spin), 1);
+	ASSERT_EQ(step_num, 1);
+	ASSERT_FLOAT_EQ(world_system.get_interpolation_alpha(), 0.5f);
+
+	world_system.update_interpolated_matrices();
+	{
+		const auto& matrix = world_system.get_interpolated_matrix(child);
+		ASSERT_NEAR(matrix._41, 6.5f, 1e-4f);
+		ASSERT_NEAR(matrix._42, 1.0f, 1e-4f);
+		ASSERT_NEAR(matrix._43, 0.0f, 1e-4f);
+	}
+	{
+		const auto& matrix    = world_system.get_interpolated_matrix(spinner);
+		const auto& reference = world_system.get_world_matrix(expected);
+		for ( int row = 0; row < 3; ++row )
+		{
+			for ( int column = 0; column < 3; ++column )
+			{
+				ASSERT_NEAR(
+				    matrix.m[row][column], reference.m[row][column], 1e-4f);
+			}
+		}
+	}
+
+	// 計算した後に登録したアクターはワールド行列を返す
+	bavil::Actor late;
+	world_system.add_actor(&late);
+	late.get_transform().set_position({3.0f, 0.0f, 0.0f});
+	world_system.update_transforms();
+	ASSERT_FLOAT_EQ(world_system.get_interpolated_matrix(late)._41, 3.0f);
+
+	world_system.remove_actor(&late);
+	world_system.remove_actor(&expected);
+	world_system.remove_actor(&spinner);
+	world_system.remove_actor(&child);
+	world_system.remove_actor(&mover);
+	system_manager.finalize();
+}